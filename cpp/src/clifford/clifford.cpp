@@ -2,49 +2,539 @@
 #include "util/f2_helper.h"
 #include "stabiliser_state/check_matrix.h"
 #include "stabiliser_state/stabiliser_state.h"
+#include "stabiliser_state/inner_product.h"
+#include "stabiliser_state/phase_form.h"
+#include "state_vector_layers.h"
+#include "util/parallel.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+#include <utility>
+#include <stdexcept>
+
+namespace
+{
+    using namespace fst;
+
+    /// Each thread gets at least this many word operations
+    constexpr std::size_t minimum_word_operations_per_task = 1 << 16;
+
+    /// Calls set_entry(row, col, amplitude) for each non-zero entry of the matrix of the Clifford, with the
+    /// amplitudes computed in precision Scalar
+    template <std::floating_point Scalar, std::unsigned_integral Bits, class Setter>
+    void for_each_matrix_entry(const Basic_Clifford<Bits> &clifford, Setter &&set_entry)
+    {
+        using Pauli_Type = Basic_Pauli<Bits>;
+
+        const std::size_t size = integral_pow_2(clifford.number_qubits);
+
+        Basic_Check_Matrix<Bits> first_col_check_matrix(clifford.z_conjugates);
+        Basic_Stabiliser_State<Bits> state (first_col_check_matrix);
+
+        // Each column has the same number of non-zero entries as the first, all of the form amplitude * i^k.
+        // Track their rows and exponents k, so each column costs O(2^dim) integer operations
+        std::vector<std::size_t> rows;
+        std::vector<unsigned int> phase_exponents;
+        rows.reserve(integral_pow_2(state.dim));
+        phase_exponents.reserve(integral_pow_2(state.dim));
+
+        state.for_each_amplitude([&](const std::size_t index, const unsigned int phase_exponent)
+        {
+            rows.push_back(index);
+            phase_exponents.push_back(phase_exponent);
+            return true;
+        });
+
+        const auto amplitudes = scaled_powers_of_i(std::complex<Scalar>(clifford.global_phase) / std::sqrt(Scalar(rows.size())));
+
+        for(std::size_t k = 0; k < rows.size(); k++)
+        {
+            set_entry(rows[k], 0, amplitudes[phase_exponents[k]]);
+        }
+
+        for(std::size_t i = 1; i < size; i++)
+        {
+            // Iterate through the Gray code. The next column is the last one multiplied by UX_iU*, which
+            // sends |row> to i^(phase_exponent) (-1)^(row.z_vector) |row ^ x_vector>
+            const std::size_t new_col_index = i ^ (i >> 1);
+            const Pauli_Type &x_conjugate = clifford.x_conjugates.at(std::countr_zero(i));
+            const unsigned int pauli_phase_exponent = x_conjugate.get_phase_exponent();
+
+            for(std::size_t k = 0; k < rows.size(); k++)
+            {
+                phase_exponents[k] = (phase_exponents[k] + pauli_phase_exponent + 2 * f2_dot_product(rows[k], x_conjugate.z_vector)) % 4;
+                rows[k] ^= x_conjugate.x_vector;
+
+                set_entry(rows[k], new_col_index, amplitudes[phase_exponents[k]]);
+            }
+        }
+    }
+
+    /// Writes the matrix of the Clifford in row-major order into matrix
+    template <std::floating_point Scalar, std::unsigned_integral Bits>
+    void write_matrix(const Basic_Clifford<Bits> &clifford, std::span<std::complex<Scalar>> matrix)
+    {
+        const std::size_t size = integral_pow_2(clifford.number_qubits);
+
+        if (matrix.size() != size * size)
+        {
+            throw std::invalid_argument("The output for the matrix must have length 2^number_qubits * 2^number_qubits");
+        }
+
+        std::fill(matrix.begin(), matrix.end(), std::complex<Scalar>{0, 0});
+
+        for_each_matrix_entry<Scalar>(clifford, [&](const std::size_t row, const std::size_t col, const std::complex<Scalar> amplitude)
+        {
+            matrix[row * size + col] = amplitude;
+        });
+    }
+
+    /// Returns the state stabilised by the Paulis, with the phase convention of Basic_Stabiliser_State: its
+    /// amplitude at the shift is 1 / sqrt(2^dim)
+    template <std::unsigned_integral Bits>
+    Basic_Stabiliser_State<Bits> get_canonical_state(const std::vector<Basic_Pauli<Bits>> &stabilisers)
+    {
+        Basic_Check_Matrix<Bits> check_matrix(stabilisers);
+
+        return Basic_Stabiliser_State<Bits>(check_matrix);
+    }
+
+    /// Multiplies the state by the Pauli P, exactly. As P|v> = phase (-1)^(v.z_vector) |v ^ x_vector>, the support
+    /// is shifted by x_vector, and the amplitudes pick up a sign linear in the coefficients
+    template <std::unsigned_integral Bits>
+    void multiply_state_by_pauli(Basic_Stabiliser_State<Bits> &state, const Basic_Pauli<Bits> &pauli)
+    {
+        for (std::size_t j = 0; j < state.dim; j++)
+        {
+            state.real_linear_part ^= Bits(f2_dot_product(pauli.z_vector, state.basis_vectors[j])) << j;
+        }
+
+        state.global_phase = scaled_powers_of_i(state.global_phase)[(pauli.get_phase_exponent() + 2 * f2_dot_product(pauli.z_vector, state.shift)) % 4];
+        state.shift ^= pauli.x_vector;
+    }
+
+    /// Returns the state U|col>, including its phase. U|col> = (UX^colU*) U|0>, where U|0> is the global phase
+    /// times the canonical state stabilised by the z_conjugates
+    template <std::unsigned_integral Bits>
+    Basic_Stabiliser_State<Bits> get_column_state(const Basic_Clifford<Bits> &clifford, const Bits col)
+    {
+        Basic_Stabiliser_State<Bits> state = get_canonical_state(clifford.z_conjugates);
+        state.global_phase = clifford.global_phase;
+        multiply_state_by_pauli(state, clifford.conjugate(Basic_Pauli<Bits>(clifford.number_qubits, col, 0, false, false)));
+
+        return state;
+    }
+
+    /// A basis of F_2^n: the given independent vectors, then the unit vectors needed to complete them, with the
+    /// coordinates of any vector in it
+    template <std::unsigned_integral Bits>
+    class Completed_Basis
+    {
+        public:
+        std::vector<Bits> columns;
+
+        Completed_Basis(const std::vector<Bits> &vectors, const std::size_t number_bits)
+            : pivot_vectors(number_bits, 0), pivot_coordinates(number_bits, 0)
+        {
+            for (const Bits vector : vectors)
+            {
+                add(vector);
+            }
+
+            for (std::size_t i = 0; i < number_bits && columns.size() < number_bits; i++)
+            {
+                add(integral_pow_2(Bits(i)));
+            }
+        }
+
+        /// Returns the coordinates c of the vector, so the vector is the sum of the columns[k] with c_k = 1
+        Bits get_coordinates(Bits vector) const
+        {
+            Bits coordinates = 0;
+
+            while (vector != 0)
+            {
+                const std::size_t pivot = std::bit_width(vector) - 1;
+                vector ^= pivot_vectors[pivot];
+                coordinates ^= pivot_coordinates[pivot];
+            }
+
+            return coordinates;
+        }
+
+        private:
+        /// Each vector added is reduced to one whose highest bit is a new pivot, which is stored with its
+        /// coordinates. The vectors stored for the higher pivots clear the bits above each pivot in turn
+        std::vector<Bits> pivot_vectors;
+        std::vector<Bits> pivot_coordinates;
+
+        void add(const Bits vector)
+        {
+            Bits reduced = vector;
+            Bits coordinates = integral_pow_2(Bits(columns.size()));
+
+            while (reduced != 0 && pivot_vectors[std::bit_width(reduced) - 1] != 0)
+            {
+                const std::size_t pivot = std::bit_width(reduced) - 1;
+                reduced ^= pivot_vectors[pivot];
+                coordinates ^= pivot_coordinates[pivot];
+            }
+
+            if (reduced != 0)
+            {
+                pivot_vectors[std::bit_width(reduced) - 1] = reduced;
+                pivot_coordinates[std::bit_width(reduced) - 1] = coordinates;
+                columns.push_back(vector);
+            }
+        }
+    };
+
+    /// Returns the Phase_Form in n variables of a Z_4 valued quadratic form given as a function exponent(x), with
+    /// exponent(0) = 0, reading its linear part off the unit vectors and its quadratic form off their pairs
+    template <class Function>
+    Phase_Form fit_phase_form(const std::size_t number_variables, Function &&exponent)
+    {
+        Phase_Form form(number_variables);
+
+        for (std::size_t j = 0; j < number_variables; j++)
+        {
+            form.linear[j] = exponent(integral_pow_2(j));
+        }
+
+        for (std::size_t j = 0; j < number_variables; j++)
+        {
+            for (std::size_t k = j + 1; k < number_variables; k++)
+            {
+                // q(e_j + e_k) = q(e_j) + q(e_k) + 2 Q(e_j, e_k)
+                if ((exponent(integral_pow_2(j) | integral_pow_2(k)) + 8 - form.linear[j] - form.linear[k]) % 4 == 2)
+                {
+                    form.flip_quadratic_form(j, k);
+                }
+            }
+        }
+
+        return form;
+    }
+
+    /// Applies U in place, as U = D H D'. For the first column U|0> = g / sqrt(2^d) sum_c i^q(c) |s + Gc>, and a
+    /// completion R of the columns of G to a basis, each column is
+    ///     U|x> = i^e X^a Z^b U|0> = g i^f(x) / sqrt(2^d) sum_c i^q(c) (-1)^(w.c) |s + Gc + Ru>
+    /// where UX^xU* = i^e X^a Z^b, a = Gt + Ru, and substituting c + t for c leaves f, w and u depending on x
+    /// only. As the columns are orthogonal, x -> (w, u) is invertible and linear, so D' takes x to (w, u) with
+    /// the phase g i^f(x) / sqrt(2^d), H is Hadamards on the d bits of w, and D takes (c, u) to s + Gc + Ru
+    /// with the phase i^q(c). Each is O(n) passes over the vector
+    template <std::floating_point Scalar, std::unsigned_integral Bits>
+    void apply_to_state_vector(const Basic_Clifford<Bits> &clifford, std::span<std::complex<Scalar>> state_vector)
+    {
+        using Pauli_Type = Basic_Pauli<Bits>;
+
+        const std::size_t number_qubits = clifford.number_qubits;
+
+        if (number_qubits >= std::numeric_limits<Bits>::digits || state_vector.size() != integral_pow_2(number_qubits))
+        {
+            throw std::invalid_argument("The state vector must have length 2^number_qubits");
+        }
+
+        const Basic_Stabiliser_State<Bits> first_column = get_canonical_state(clifford.z_conjugates);
+        const std::size_t dim = first_column.dim;
+        const Phase_Form column_form = get_phase_form(first_column);
+        const Completed_Basis<Bits> basis(first_column.basis_vectors, number_qubits);
+
+        // Returns f(x) and the index of (w, u)
+        const auto get_column = [&](const Bits x)
+        {
+            const Pauli_Type pauli = clifford.conjugate(Pauli_Type(number_qubits, x, 0, false, false));
+            const Bits coordinates = basis.get_coordinates(pauli.x_vector);
+            const Bits t = coordinates & (integral_pow_2(Bits(dim)) - 1);
+            Bits w = 0;
+            Bits bilinear = 0;
+
+            // q(c + t) = q(c) + q(t) + 2 B(c, t), for the bilinear form B whose diagonal is the linear part mod 2
+            for (std::size_t k = 0; k < dim; k++)
+            {
+                w |= Bits(f2_dot_product(pauli.z_vector, first_column.basis_vectors[k])) << k;
+                bilinear |= Bits((column_form.linear[k] & bit_set_at(t, k) & 1) ^ f2_dot_product(Bits(column_form.quadratic_form[k]), t)) << k;
+            }
+
+            const unsigned int exponent = pauli.get_phase_exponent() + column_form.evaluate(t) + 2 * f2_dot_product(pauli.z_vector, first_column.shift) + 2 * f2_dot_product(w, t);
+
+            return std::pair<unsigned int, Bits>(exponent % 4, (w ^ bilinear) | ((coordinates >> dim) << dim));
+        };
+
+        std::vector<std::size_t> column_indices;
+
+        for (std::size_t j = 0; j < number_qubits; j++)
+        {
+            column_indices.push_back(get_column(integral_pow_2(Bits(j))).second);
+        }
+
+        const Phase_Form column_phases = fit_phase_form(number_qubits, [&](const Bits x) { return get_column(x).first; });
+
+        Phase_Form support_phases = column_form;
+
+        while (support_phases.linear.size() < number_qubits)
+        {
+            support_phases.add_variable();
+        }
+
+        const std::complex<Scalar> scale = std::complex<Scalar>(clifford.global_phase) / std::sqrt(Scalar(integral_pow_2(dim)));
+
+        apply_phase_layer(state_vector, column_phases, scale);
+        apply_linear_layer(state_vector, std::span<const std::size_t>(column_indices));
+        apply_hadamard_layer(state_vector, dim);
+        apply_phase_layer(state_vector, support_phases, std::complex<Scalar>(1));
+        apply_linear_layer(state_vector, std::span<const std::size_t>(basis.columns));
+        apply_shift_layer(state_vector, first_column.shift);
+    }
+
+    /// Returns the global phase for the conjugates, given the entry of the Clifford at the shift of its first
+    /// column (where the canonical state has amplitude 1 / sqrt(2^dim))
+    std::complex<float> get_global_phase(const std::complex<float> entry)
+    {
+        return entry / std::abs(entry);
+    }
+}
 
 namespace fst
 {
-    Clifford::Clifford(const std::vector<Pauli> z_conjugates, const std::vector<Pauli> x_conjugates, const std::complex<float> global_phase )
+    template <f2_vector_like Bits>
+    Basic_Clifford<Bits>::Basic_Clifford(const std::vector<Pauli_Type> z_conjugates, const std::vector<Pauli_Type> x_conjugates, const std::complex<float> global_phase )
         : z_conjugates(z_conjugates), x_conjugates(x_conjugates), global_phase(global_phase)
         {
             number_qubits = z_conjugates.size();
         }
 
-    std::vector<std::vector<std::complex<float>>> Clifford::get_matrix() const
+    template <f2_vector_like Bits>
+    Basic_Clifford<Bits> Basic_Clifford<Bits>::identity(const std::size_t number_qubits)
     {
-        const std::size_t size = integral_pow_2(number_qubits);
-        std::vector<std::vector<std::complex<float>>> transposed_matrix(size, std::vector<std::complex<float>> (size, 0) );
+        std::vector<Pauli_Type> z_conjugates;
+        std::vector<Pauli_Type> x_conjugates;
+
+        for (std::size_t j = 0; j < number_qubits; j++)
+        {
+            z_conjugates.emplace_back(number_qubits, Bits{}, unit_vector<Bits>(j), false, false);
+            x_conjugates.emplace_back(number_qubits, unit_vector<Bits>(j), Bits{}, false, false);
+        }
 
-        Check_Matrix first_col_check_matrix(z_conjugates);
-        Stabiliser_State state (first_col_check_matrix);
-        state.global_phase = global_phase;
+        return Basic_Clifford(z_conjugates, x_conjugates);
+    }
 
-        transposed_matrix[0] = state.get_state_vector();
+    template <f2_vector_like Bits>
+    Basic_Pauli<Bits> Basic_Clifford<Bits>::conjugate(const Pauli_Type &pauli) const
+    {
+        if (pauli.number_qubits != number_qubits)
+        {
+            throw std::invalid_argument("The Pauli must act on the same number of qubits as the Clifford");
+        }
 
-        std::size_t old_col_index = 0;
+        Pauli_Type result(number_qubits, zero_vector<Bits>(number_qubits), zero_vector<Bits>(number_qubits), pauli.sign_bit, pauli.imag_bit);
 
-        for(std::size_t i = 1; i < size; i++)
+        for_each_set_bit(pauli.x_vector, [&](const std::size_t j)
         {
-            // Iterate through the Gray code
-            std::size_t new_col_index = i ^ (i >> 1);
-            std::size_t bit_flipped = integral_log_2( old_col_index ^ new_col_index );
+            result.multiply_by_pauli_on_right(x_conjugates[j]);
+        });
 
-            transposed_matrix[new_col_index] = x_conjugates.at(bit_flipped).multiply_vector(transposed_matrix[old_col_index]);
+        for_each_set_bit(pauli.z_vector, [&](const std::size_t j)
+        {
+            result.multiply_by_pauli_on_right(z_conjugates[j]);
+        });
+
+        return result;
+    }
 
-            old_col_index = new_col_index;
+    template <f2_vector_like Bits>
+    std::vector<Basic_Pauli<Bits>> Basic_Clifford<Bits>::conjugate(std::span<const Pauli_Type> paulis) const
+    {
+        for (const Pauli_Type &pauli : paulis)
+        {
+            if (pauli.number_qubits != number_qubits)
+            {
+                throw std::invalid_argument("The Paulis must act on the same number of qubits as the Clifford");
+            }
         }
 
-        std::vector<std::vector<std::complex<float>>> matrix(size, std::vector<std::complex<float>>(size, 0));
-        
-        for(std::size_t i = 0; i < size; i++)
+        std::vector<Pauli_Type> conjugates(paulis.size());
+
+        const std::size_t word_operations = paulis.size() * number_qubits * (number_qubits / 64 + 1);
+        const std::size_t number_tasks = std::min({get_number_threads(), paulis.size(), std::max<std::size_t>(1, word_operations / minimum_word_operations_per_task)});
+
+        parallel_for(number_tasks, [&](const std::size_t task)
         {
-            for(std::size_t j = 0; j < size; j++)
+            for (std::size_t k = task * paulis.size() / number_tasks; k < (task + 1) * paulis.size() / number_tasks; k++)
             {
-                matrix[i][j] = transposed_matrix[j][i];
+                conjugates[k] = conjugate(paulis[k]);
             }
+        });
+
+        return conjugates;
+    }
+
+    template <f2_vector_like Bits>
+    Basic_Check_Matrix<Bits> Basic_Clifford<Bits>::apply(const Basic_Check_Matrix<Bits> &check_matrix) const
+    {
+        return Basic_Check_Matrix<Bits>(conjugate(std::span<const Pauli_Type>(check_matrix.get_paulis())));
+    }
+
+    template <f2_vector_like Bits>
+    Basic_Stabiliser_State<Bits> Basic_Clifford<Bits>::apply(const Basic_Stabiliser_State<Bits> &state) const
+        requires std::unsigned_integral<Bits>
+    {
+        if (state.number_qubits != number_qubits)
+        {
+            throw std::invalid_argument("The state must have the same number of qubits as the Clifford");
         }
 
+        Basic_Stabiliser_State<Bits> state_copy = state;
+        const Basic_Check_Matrix<Bits> check_matrix(state_copy);
+
+        Basic_Stabiliser_State<Bits> result = get_canonical_state(conjugate(std::span<const Pauli_Type>(check_matrix.get_paulis())));
+
+        // <y|U|psi> = <U*y|psi>, and the canonical state has a positive real amplitude at its shift y
+        const Basic_Stabiliser_State<Bits> bra = get_column_state(inverse(), result.shift);
+        result.global_phase = get_global_phase(inner_product(bra, state)) * std::abs(state.global_phase);
+
+        return result;
+    }
+
+    template <f2_vector_like Bits>
+    void Basic_Clifford<Bits>::apply(std::span<std::complex<float>> state_vector) const
+        requires std::unsigned_integral<Bits>
+    {
+        apply_to_state_vector(*this, state_vector);
+    }
+
+    template <f2_vector_like Bits>
+    void Basic_Clifford<Bits>::apply(std::span<std::complex<double>> state_vector) const
+        requires std::unsigned_integral<Bits>
+    {
+        apply_to_state_vector(*this, state_vector);
+    }
+
+    template <f2_vector_like Bits>
+    Basic_Clifford<Bits> Basic_Clifford<Bits>::compose(const Basic_Clifford &other) const
+        requires std::unsigned_integral<Bits>
+    {
+        if (number_qubits != other.number_qubits)
+        {
+            throw std::invalid_argument("The Cliffords must act on the same number of qubits");
+        }
+
+        std::vector<Pauli_Type> product_z_conjugates;
+        std::vector<Pauli_Type> product_x_conjugates;
+
+        for (std::size_t j = 0; j < number_qubits; j++)
+        {
+            product_z_conjugates.push_back(conjugate(other.z_conjugates[j]));
+            product_x_conjugates.push_back(conjugate(other.x_conjugates[j]));
+        }
+
+        Basic_Clifford product(product_z_conjugates, product_x_conjugates);
+        const Basic_Stabiliser_State<Bits> first_column = get_canonical_state(product_z_conjugates);
+
+        const Basic_Stabiliser_State<Bits> bra = get_column_state(inverse(), first_column.shift);
+        const Basic_Stabiliser_State<Bits> ket = get_column_state(other, Bits(0));
+
+        product.global_phase = get_global_phase(inner_product(bra, ket));
+
+        return product;
+    }
+
+    template <f2_vector_like Bits>
+    Basic_Clifford<Bits> Basic_Clifford<Bits>::inverse() const
+        requires std::unsigned_integral<Bits>
+    {
+        std::vector<Pauli_Type> inverse_z_conjugates;
+        std::vector<Pauli_Type> inverse_x_conjugates;
+
+        // U*PU has an X (or Z) on qubit k exactly when P anticommutes with UZ_kU* (or UX_kU*), as conjugation
+        // preserves commutation. Its sign is then the one that U maps back to +P
+        const auto add_inverse_conjugate = [&](std::vector<Pauli_Type> &inverse_conjugates, const std::size_t j, const bool is_z)
+        {
+            Bits x_vector = 0;
+            Bits z_vector = 0;
+
+            for (std::size_t k = 0; k < number_qubits; k++)
+            {
+                x_vector |= Bits(bit_set_at(is_z ? z_conjugates[k].x_vector : z_conjugates[k].z_vector, j)) << k;
+                z_vector |= Bits(bit_set_at(is_z ? x_conjugates[k].x_vector : x_conjugates[k].z_vector, j)) << k;
+            }
+
+            Pauli_Type inverse_conjugate(number_qubits, x_vector, z_vector, false, f2_dot_product(x_vector, z_vector));
+            inverse_conjugate.sign_bit ^= conjugate(inverse_conjugate).sign_bit;
+
+            inverse_conjugates.push_back(inverse_conjugate);
+        };
+
+        for (std::size_t j = 0; j < number_qubits; j++)
+        {
+            add_inverse_conjugate(inverse_z_conjugates, j, true);
+            add_inverse_conjugate(inverse_x_conjugates, j, false);
+        }
+
+        Basic_Clifford inverse_clifford(inverse_z_conjugates, inverse_x_conjugates);
+
+        // <y|U*|0> is the conjugate of <0|U|y>
+        const Basic_Stabiliser_State<Bits> first_column = get_canonical_state(inverse_z_conjugates);
+        inverse_clifford.global_phase = get_global_phase(std::conj(get_column_state(*this, first_column.shift).get_amplitude(Bits(0))));
+
+        return inverse_clifford;
+    }
+
+    template <f2_vector_like Bits>
+    Basic_Clifford<Bits> Basic_Clifford<Bits>::power(const long long exponent) const
+        requires std::unsigned_integral<Bits>
+    {
+        Basic_Clifford result = identity(number_qubits);
+        Basic_Clifford base = exponent < 0 ? inverse() : *this;
+
+        for (unsigned long long rest = exponent < 0 ? 0 - static_cast<unsigned long long>(exponent) : exponent; rest != 0; rest >>= 1)
+        {
+            if (rest & 1)
+            {
+                result = result.compose(base);
+            }
+
+            if (rest > 1)
+            {
+                base = base.compose(base);
+            }
+        }
+
+        return result;
+    }
+
+    template <f2_vector_like Bits>
+    std::vector<std::vector<std::complex<float>>> Basic_Clifford<Bits>::get_matrix() const
+        requires std::unsigned_integral<Bits>
+    {
+        const std::size_t size = integral_pow_2(number_qubits);
+        std::vector<std::vector<std::complex<float>>> matrix(size, std::vector<std::complex<float>>(size, 0));
+
+        for_each_matrix_entry<float>(*this, [&](const std::size_t row, const std::size_t col, const std::complex<float> amplitude)
+        {
+            matrix[row][col] = amplitude;
+        });
+
         return matrix;
     }
+
+    template <f2_vector_like Bits>
+    void Basic_Clifford<Bits>::get_matrix(std::span<std::complex<float>> matrix) const
+        requires std::unsigned_integral<Bits>
+    {
+        write_matrix(*this, matrix);
+    }
+
+    template <f2_vector_like Bits>
+    void Basic_Clifford<Bits>::get_matrix(std::span<std::complex<double>> matrix) const
+        requires std::unsigned_integral<Bits>
+    {
+        write_matrix(*this, matrix);
+    }
+
+    template struct Basic_Clifford<std::size_t>;
+    template struct Basic_Clifford<F2_Vector>;
 }
\ No newline at end of file
@@ -5,26 +5,99 @@
 
 #include <vector>
 #include <complex>
+#include <span>
 
 namespace fst
 {
+    template <f2_vector_like Bits>
+    struct Basic_Check_Matrix;
+
+    template <f2_vector_like Bits>
+    struct Basic_Stabiliser_State;
+
     /// The class used to represent a Clifford operator U.
     /// Represented by its action on the Pauli basis:
     /// z_conjugates[i] = UZ_iU*, x_conjugates[i] = UX_iU*
-    struct Clifford
+    ///
+    /// As for Basic_Pauli, Bits is std::size_t (the Clifford alias, up to 64 qubits) or
+    /// F2_Vector (the Wide_Clifford alias, any number of qubits).
+    template <f2_vector_like Bits>
+    struct Basic_Clifford
     {
+        using Pauli_Type = Basic_Pauli<Bits>;
+
         std::size_t number_qubits = 0;
 
-        std::vector<Pauli> z_conjugates;
-        std::vector<Pauli> x_conjugates;
+        std::vector<Pauli_Type> z_conjugates;
+        std::vector<Pauli_Type> x_conjugates;
 
         std::complex<float> global_phase;
 
-        Clifford(const std::vector<Pauli> z_conjugates, const std::vector<Pauli> x_conjugates, const std::complex<float> global_phase = 1.0f);
+        Basic_Clifford(const std::vector<Pauli_Type> z_conjugates, const std::vector<Pauli_Type> x_conjugates, const std::complex<float> global_phase = 1.0f);
+
+        /// Returns the identity on number_qubits qubits
+        static Basic_Clifford identity(const std::size_t number_qubits);
+
+        /// Returns UPU* for a Pauli P (with any phase), as the product of the conjugates of its X and Z parts, in
+        /// O(n) Pauli multiplications. Throws std::invalid_argument if the numbers of qubits differ
+        Pauli_Type conjugate(const Pauli_Type &pauli) const;
+
+        /// Returns UPU* for each of the Paulis, as above, with the Paulis split between threads. Throws
+        /// std::invalid_argument before conjugating any if one has a different number of qubits
+        std::vector<Pauli_Type> conjugate(std::span<const Pauli_Type> paulis) const;
+
+        /// Returns the check matrix of U|psi>, for the state |psi> of the check matrix, by conjugating its
+        /// generators. Throws std::invalid_argument if the numbers of qubits differ
+        Basic_Check_Matrix<Bits> apply(const Basic_Check_Matrix<Bits> &check_matrix) const;
+
+        /// Returns the state U|psi>, including its global phase, in O(n^3) without building either state vector.
+        /// Its stabilisers are those of |psi> conjugated by U, and its amplitude at its shift y is the inner
+        /// product of U*|y> and |psi>. Throws std::invalid_argument if the numbers of qubits differ
+        Basic_Stabiliser_State<Bits> apply(const Basic_Stabiliser_State<Bits> &state) const
+            requires std::unsigned_integral<Bits>;
+
+        /// Applies the Clifford in place to a state vector of length 2^n, in single or double precision, without
+        /// building its matrix. U is split into Hadamards on d qubits (for d the dimension of the support of U|0>)
+        /// between two permutations of the basis with phases, each a linear map on the indices applied as O(n)
+        /// passes of swaps of amplitudes, so this takes O(n 2^n) operations, split between threads. Throws
+        /// std::invalid_argument if the length is wrong
+        void apply(std::span<std::complex<float>> state_vector) const
+            requires std::unsigned_integral<Bits>;
+        void apply(std::span<std::complex<double>> state_vector) const
+            requires std::unsigned_integral<Bits>;
+
+        /// Returns the Clifford UV, which applies other (V) and then this Clifford (U). The conjugates are those
+        /// of V conjugated by U, in O(n^2) word operations, and the global phase is fixed by the entry <y|UV|0>
+        /// for y in the support of the first column, which is the inner product of the stabiliser states U*|y> and
+        /// V|0>, in O(n^3). Throws std::invalid_argument if the numbers of qubits differ
+        Basic_Clifford compose(const Basic_Clifford &other) const
+            requires std::unsigned_integral<Bits>;
+
+        /// Returns the inverse U*. Its conjugates are read off the symplectic inverse of the tableau, with each
+        /// sign fixed by conjugating back by U, and its global phase from the conjugate of one entry of U, so this
+        /// takes O(n^3) word operations
+        Basic_Clifford inverse() const
+            requires std::unsigned_integral<Bits>;
+
+        /// Returns U^exponent by repeated squaring (of the inverse, for a negative exponent), in
+        /// O(n^3 log |exponent|)
+        Basic_Clifford power(const long long exponent) const
+            requires std::unsigned_integral<Bits>;
 
         /// Returns the matrix of the Clifford (with respect to the computational basis) 
-        std::vector<std::vector<std::complex<float>>> get_matrix() const; 
+        std::vector<std::vector<std::complex<float>>> get_matrix() const
+            requires std::unsigned_integral<Bits>;
+
+        /// Writes the matrix of the Clifford in row-major order into matrix, which must have length 2^n * 2^n,
+        /// in single or double precision. Throws std::invalid_argument if the length is wrong
+        void get_matrix(std::span<std::complex<float>> matrix) const
+            requires std::unsigned_integral<Bits>;
+        void get_matrix(std::span<std::complex<double>> matrix) const
+            requires std::unsigned_integral<Bits>;
     };
+
+    using Clifford = Basic_Clifford<std::size_t>;
+    using Wide_Clifford = Basic_Clifford<F2_Vector>;
 }
 
 #endif
\ No newline at end of file
@@ -12,38 +12,70 @@ using namespace fst;
 
 namespace
 {
-    std::vector<std::vector<std::complex<float>>> transpose_matrix(const std::vector<std::vector<std::complex<float>>> &matrix, const std::size_t &size)
+    /// Returns the size of a row-major matrix of length 2^n * 2^n, or nothing for any other length
+    std::optional<std::size_t> get_row_major_size(const std::size_t length)
     {
-        std::vector<std::vector<std::complex<float>>> transposed_matrix ( size, std::vector<std::complex<float>> (size) );
-        
-        for (std::size_t i = 0; i < size; i++)
+        if (!is_power_of_2(length) || integral_log_2(length) % 2 != 0)
         {
-            for (std::size_t j = 0; j < size; j++)
-            {
-                transposed_matrix[i][j] = matrix[j][i];
-            }
+            return std::nullopt;
         }
 
-        return transposed_matrix;
+        return integral_pow_2(std::size_t(integral_log_2(length) / 2));
     }
 
-    template <bool assume_valid, bool return_state>
-    auto clifford_from_matrix_internal(const std::vector<std::vector<std::complex<float>>> &matrix)
+    /// The matrix is read through entry(i, j), its (i, j) entry, so a row-major span is read in place
+    template <bool assume_valid, bool return_state, std::floating_point Scalar, class Entry>
+    auto clifford_from_matrix_internal(const Entry &entry, const std::size_t size, const Tolerance &tolerance)
         -> std::conditional_t<return_state, std::optional<fst::Clifford>, bool>
     {
-        const std::size_t size = matrix.size();
-        std::vector<std::vector<std::complex<float>>> transposed_matrix = transpose_matrix(matrix, size);
+        using Complex = std::complex<Scalar>;
+
+        // Whether the ratio of two entries is i^phase_exponent, up to the tolerance
+        const auto is_ratio = [&](const Complex ratio, const unsigned int phase_exponent)
+        {
+            return std::norm(ratio - Complex(powers_of_i[phase_exponent])) < tolerance.phase;
+        };
+
+        // The entry times the phase (-1)^(index.z_vector) * i^k the Pauli gives to index, exactly
+        const auto apply_phase = [](const Complex entry, const Pauli &pauli, const std::size_t index)
+        {
+            return scaled_powers_of_i(entry)[(pauli.get_phase_exponent() + 2 * f2_dot_product(index, pauli.z_vector)) % 4];
+        };
+
+        // Whether the column is a (-1)^eig_sign eigenvector of the Pauli, up to the tolerance
+        const auto has_eigenstate = [&](const Pauli &pauli, const std::size_t column, const bool eig_sign)
+        {
+            for (std::size_t index = 0; index < size; index++)
+            {
+                const Complex expected_entry = eig_sign ? -apply_phase(entry(index, column), pauli, index) : apply_phase(entry(index, column), pauli, index);
+
+                if (std::norm(entry(index ^ pauli.x_vector, column) - expected_entry) >= tolerance.amplitude)
+                {
+                    return false;
+                }
+            }
+
+            return true;
+        };
 
         if (!is_power_of_2(size))
         {   
             return {};
         }
 
+        // The first column is the only one copied, as the state conversion reads a contiguous vector
+        std::vector<Complex> first_column(size);
+
+        for (std::size_t index = 0; index < size; index++)
+        {
+            first_column[index] = entry(index, 0);
+        }
+
         Stabiliser_State first_col_state;
 
         try
         {
-            first_col_state = std::move(stabiliser_from_statevector(transposed_matrix[0], assume_valid));
+            first_col_state = std::move(stabiliser_from_statevector(std::span<const Complex>(first_column), assume_valid, tolerance));
         }
         catch (...)
         {   
@@ -84,7 +116,7 @@ namespace
             std::size_t col_index = integral_pow_2(i);
             std::size_t row_index = 0;
 
-            while (row_index < size && transposed_matrix[col_index][row_index] == .0f)
+            while (row_index < size && entry(row_index, col_index) == Scalar(0))
             {
                 ++row_index;
             }
@@ -94,19 +126,19 @@ namespace
                 return {};
             }
 
-            std::complex<float> non_zero_entry = transposed_matrix[col_index][row_index];
+            Complex non_zero_entry = entry(row_index, col_index);
 
             for (std::size_t j = 0; j < number_qubits; j++)
             {
                 //TODO make pointer?
                 Pauli pauli = first_col_paulis[j];
-                std::complex<float> phase = transposed_matrix[col_index][row_index ^ pauli.x_vector]/(non_zero_entry * sign_f2_dot_product(row_index, pauli.z_vector) * pauli.get_phase());
+                Complex phase = entry(row_index ^ pauli.x_vector, col_index)/apply_phase(non_zero_entry, pauli, row_index);
 
-                if (std::norm(phase + 1.0f) < 0.125)
+                if (is_ratio(phase, 2))
                 {
                     first_col_effects[j] ^= col_index;
                 }
-                else if (std::norm(phase - 1.0f) >= 0.125)
+                else if (!is_ratio(phase, 0))
                 {
                     return {};
                 }
@@ -151,7 +183,7 @@ namespace
             {
                 for (std::size_t i = 1; i < number_qubits; i++)
                 {
-                    if (! z_conjugates[i].has_eigenstate(transposed_matrix[col_index], bit_set_at(col_index, i)))
+                    if (!has_eigenstate(z_conjugates[i], col_index, bit_set_at(col_index, i)))
                     {
                         return {};
                     }
@@ -163,23 +195,23 @@ namespace
         {
             std::size_t non_zero_index = first_col_state.shift ^ W_paulis[i].x_vector;
             std::size_t col_index = integral_pow_2(i);
-            std::complex<float> relative_phase = transposed_matrix[col_index][non_zero_index]/(transposed_matrix[0][first_col_state.shift]*sign_f2_dot_product(first_col_state.shift, W_paulis[i].z_vector)*W_paulis[i].get_phase());
+            Complex relative_phase = entry(non_zero_index, col_index)/apply_phase(entry(first_col_state.shift, 0), W_paulis[i], first_col_state.shift);
 
-            if (std::norm(relative_phase + 1.0f) < 0.125)
+            if (is_ratio(relative_phase, 2))
             {
                 W_paulis[i].sign_bit ^= 1;
             }
-            else if (std::norm(relative_phase + std::complex<float>{0,1}) < 0.125)
+            else if (is_ratio(relative_phase, 3))
             {
                 W_paulis[i].sign_bit ^= W_paulis[i].imag_bit;
                 W_paulis[i].imag_bit ^= 1;
             }
-            else if (std::norm(relative_phase - std::complex<float>{0,1}) < 0.125)
+            else if (is_ratio(relative_phase, 1))
             {
                 W_paulis[i].sign_bit ^= !W_paulis[i].imag_bit;
                 W_paulis[i].imag_bit ^= 1;
             }
-            else if (std::norm(relative_phase - 1.0f) >= 0.125)
+            else if (!is_ratio(relative_phase, 0))
             {
                 return {};
             }
@@ -189,18 +221,18 @@ namespace
         {
             std::size_t i_non_zero_index = first_col_state.shift ^ W_paulis[i].x_vector;
             std::size_t i_col_index = integral_pow_2(i);
-            std::complex<float> i_non_zero_entry = transposed_matrix[i_col_index][i_non_zero_index]; 
+            Complex i_non_zero_entry = entry(i_non_zero_index, i_col_index); 
 
             for (std::size_t j = 0; j < number_qubits; j++)
             {
                 std::size_t ij_non_zero_index = i_non_zero_index ^ W_paulis[j].x_vector;
-                std::complex<float> relative_phase = transposed_matrix[i_col_index ^ integral_pow_2(j)][ij_non_zero_index]/(i_non_zero_entry*sign_f2_dot_product(i_non_zero_index, W_paulis[j].z_vector)*W_paulis[j].get_phase());
+                Complex relative_phase = entry(ij_non_zero_index, i_col_index ^ integral_pow_2(j))/apply_phase(i_non_zero_entry, W_paulis[j], i_non_zero_index);
 
-                if (std::norm(relative_phase + 1.0f) < 0.125)
+                if (is_ratio(relative_phase, 2))
                 {
                     W_paulis[j].multiply_by_pauli_on_right(z_conjugates[i]);
                 }
-                else if (std::norm(relative_phase - 1.0f) >= 0.125)
+                else if (!is_ratio(relative_phase, 0))
                 {
                     return {};
                 }
@@ -221,7 +253,7 @@ namespace
                 Pauli pauli_flip = W_paulis[flipped_bit];
                 std::size_t new_support = old_support ^ pauli_flip.x_vector;
 
-                if (std::norm(transposed_matrix[new_col_index][new_support] - transposed_matrix[old_col_index][old_support]*sign_f2_dot_product(old_support, pauli_flip.z_vector)*pauli_flip.get_phase()) >= 0.001)
+                if (std::norm(entry(new_support, new_col_index) - apply_phase(entry(old_support, old_col_index), pauli_flip, old_support)) >= tolerance.amplitude)
                 {
                     return {};
                 }
@@ -242,21 +274,77 @@ namespace
     }
 }
 
-fst::Clifford fst::clifford_from_matrix(const std::vector<std::vector<std::complex<float>>> &matrix, const bool assume_valid)
+namespace
 {
-    std::optional<Clifford> clifford = assume_valid 
-                                ? clifford_from_matrix_internal<true, true>(matrix)
-                                : clifford_from_matrix_internal<false, true>(matrix);
+    template <std::floating_point Scalar, class Entry>
+    fst::Clifford clifford_from_entries(const Entry &entry, const std::size_t size, const bool assume_valid, const Tolerance &tolerance)
+    {
+        std::optional<Clifford> clifford = assume_valid 
+                                    ? clifford_from_matrix_internal<true, true, Scalar>(entry, size, tolerance)
+                                    : clifford_from_matrix_internal<false, true, Scalar>(entry, size, tolerance);
+
+        if (!clifford)
+        {
+            throw std::invalid_argument("Matrix was not a Clifford");
+        }
+
+        return *std::move(clifford);
+    }
 
-    if (!clifford)
+    template <std::floating_point Scalar>
+    fst::Clifford clifford_from_row_major_matrix(std::span<const std::complex<Scalar>> matrix, const bool assume_valid, const Tolerance &tolerance)
     {
-        throw std::invalid_argument("Matrix was not a Clifford");
+        const std::optional<std::size_t> size = get_row_major_size(matrix.size());
+
+        if (!size)
+        {
+            throw std::invalid_argument("Matrix was not a Clifford");
+        }
+
+        return clifford_from_entries<Scalar>([&](const std::size_t i, const std::size_t j) { return matrix[i * *size + j]; }, *size, assume_valid, tolerance);
     }
 
-    return *std::move(clifford);
+    template <std::floating_point Scalar>
+    bool is_clifford_row_major_matrix(std::span<const std::complex<Scalar>> matrix, const Tolerance &tolerance)
+    {
+        const std::optional<std::size_t> size = get_row_major_size(matrix.size());
+
+        return size && clifford_from_matrix_internal<false, false, Scalar>([&](const std::size_t i, const std::size_t j) { return matrix[i * *size + j]; }, *size, tolerance);
+    }
+
+    /// The (i, j) entry of a matrix given as a list of rows
+    auto get_row_entry(const std::vector<std::vector<std::complex<float>>> &matrix)
+    {
+        return [&matrix](const std::size_t i, const std::size_t j) { return matrix[i][j]; };
+    }
+}
+
+fst::Clifford fst::clifford_from_matrix(const std::vector<std::vector<std::complex<float>>> &matrix, const bool assume_valid, const Tolerance &tolerance)
+{
+    return clifford_from_entries<float>(get_row_entry(matrix), matrix.size(), assume_valid, tolerance);
+}
+
+fst::Clifford fst::clifford_from_matrix(std::span<const std::complex<float>> matrix, const bool assume_valid, const Tolerance &tolerance)
+{
+    return clifford_from_row_major_matrix(matrix, assume_valid, tolerance);
 }
 
-bool fst::is_clifford_matrix(const std::vector<std::vector<std::complex<float>>> &matrix )
+fst::Clifford fst::clifford_from_matrix(std::span<const std::complex<double>> matrix, const bool assume_valid, const Tolerance &tolerance)
 {
-    return clifford_from_matrix_internal<false, false>(matrix);
-}
\ No newline at end of file
+    return clifford_from_row_major_matrix(matrix, assume_valid, tolerance);
+}
+
+bool fst::is_clifford_matrix(const std::vector<std::vector<std::complex<float>>> &matrix, const Tolerance &tolerance)
+{
+    return clifford_from_matrix_internal<false, false, float>(get_row_entry(matrix), matrix.size(), tolerance);
+}
+
+bool fst::is_clifford_matrix(std::span<const std::complex<float>> matrix, const Tolerance &tolerance)
+{
+    return is_clifford_row_major_matrix(matrix, tolerance);
+}
+
+bool fst::is_clifford_matrix(std::span<const std::complex<double>> matrix, const Tolerance &tolerance)
+{
+    return is_clifford_row_major_matrix(matrix, tolerance);
+}
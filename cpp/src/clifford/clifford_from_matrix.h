@@ -2,19 +2,30 @@
 #define _FAST_STABILISER_CLIFFORD_FROM_MATRIX_H
 
 #include <complex>
+#include <span>
 
 #include "clifford.h"
+#include "util/tolerance.h"
 
 namespace fst
 {
     /// Convert a 2^n by 2^n matrix with complex entries into a clifford object.
 	///
 	/// Assuming valid is faster, but will result in undefined behaviour if the matrix is not in fact a
-	/// valid clifford operator
-    Clifford clifford_from_matrix (const std::vector<std::vector<std::complex<float>>> &matrix, const bool assume_valid = false);
+	/// valid clifford operator. The tolerance sets how close to a Clifford the matrix must be
+    Clifford clifford_from_matrix (const std::vector<std::vector<std::complex<float>>> &matrix, const bool assume_valid = false, const Tolerance &tolerance = {});
+
+    /// As above, for a 2^n by 2^n matrix stored in row-major order (so of length 2^n * 2^n), in single
+    /// or double precision (which the conversion then works in)
+    Clifford clifford_from_matrix (std::span<const std::complex<float>> matrix, const bool assume_valid = false, const Tolerance &tolerance = {});
+    Clifford clifford_from_matrix (std::span<const std::complex<double>> matrix, const bool assume_valid = false, const Tolerance &tolerance = {});
 
     /// Test wheter a matrix with complex entries corresponds to a clifford state.
-    bool is_clifford_matrix(const std::vector<std::vector<std::complex<float>>> &matrix);
+    bool is_clifford_matrix(const std::vector<std::vector<std::complex<float>>> &matrix, const Tolerance &tolerance = {});
+
+    /// As above, for a matrix stored in row-major order
+    bool is_clifford_matrix(std::span<const std::complex<float>> matrix, const Tolerance &tolerance = {});
+    bool is_clifford_matrix(std::span<const std::complex<double>> matrix, const Tolerance &tolerance = {});
 }
 
 #endif
\ No newline at end of file
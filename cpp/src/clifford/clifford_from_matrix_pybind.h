@@ -6,19 +6,33 @@
 #include <pybind11/stl.h>
 
 #include "clifford_from_matrix.h"
+#include "util/numpy_pybind.h"
 
 namespace py = pybind11;
 using namespace fst;
 
-// Eliminate copying by making types opaque, accept np arrays?
-
 namespace fst_pybind
 {
+    /// Defines the conversions reading matrices from an Array, so they can be overloaded for complex64 and
+    /// complex128 input
+    template <class Array>
+    void def_clifford_from_matrix(py::module_ &m)
+    {
+        m.def("clifford_from_matrix", [](const Array &matrix, const bool assume_valid, const Tolerance &tolerance)
+        {
+            return clifford_from_matrix(as_square_matrix_span(matrix), assume_valid, tolerance);
+        }, py::arg("matrix"), py::arg("assume_valid") = false, py::arg("tolerance") = Tolerance{}, "Converts a 2^n by 2^n matrix with complex entries into a Clifford object. Assuming valid is faster, but will result in undefined behaviour if the matrix is not in fact a valid Clifford operator. The tolerance sets how close to a Clifford the matrix must be. complex128 input is read in place and checked in double precision");
+        m.def("is_clifford_matrix", [](const Array &matrix, const Tolerance &tolerance)
+        {
+            return matrix.ndim() == 2 && matrix.shape(0) == matrix.shape(1) && is_clifford_matrix(as_span(matrix), tolerance);
+        }, py::arg("matrix"), py::arg("tolerance") = Tolerance{}, "Tests whether a matrix with complex entries corresponds to a Clifford, up to the tolerance");
+    }
+
     void init_clifford_from_matrix(py::module_ &m)
     {
-        m.def("clifford_from_matrix", &clifford_from_matrix, py::arg("matrix"), py::arg("assume_valid") = false, "Converts a 2^n by 2^n matrix with complex entries into a Clifford object. Assuming valid is faster, but will result in undefined behaviour if the matrix is not in fact a valid Clifford operator");
-        m.def("is_clifford_matrix", &is_clifford_matrix, py::arg("matrix"), "Tests whether a matrix with complex entries corresponds to a Clifford");
+        def_clifford_from_matrix<Complex_Array>(m);
+        def_clifford_from_matrix<Double_Complex_Array>(m);
     }
 }
 
-#endif
\ No newline at end of file
+#endif
@@ -6,6 +6,9 @@
 #include <pybind11/stl.h>
 
 #include "clifford.h"
+#include "stabiliser_state/check_matrix.h"
+#include "stabiliser_state/stabiliser_state.h"
+#include "util/numpy_pybind.h"
 
 namespace py = pybind11;
 using namespace fst;
@@ -20,7 +23,27 @@ namespace fst_pybind
             .def_readwrite("x_conjugates", &Clifford::x_conjugates, "list[Pauli]")
             .def_readwrite("global_phase", &Clifford::global_phase, "complex")
             .def(py::init<const std::vector<Pauli>, const std::vector<Pauli>, const std::complex<float>>(), py::arg("z_conjugates"), py::arg("x_conjugates"), py::arg("global_phase") = 1.0f)
-            .def("get_matrix", &Clifford::get_matrix, "Returns the matrix of the Clifford (with respect to the computational basis)")
+            .def("get_matrix", [](const Clifford &clifford, const py::object &out)
+            {
+                const py::ssize_t size = py::ssize_t(1) << clifford.number_qubits;
+                return write_array({size, size}, out, [&](const auto matrix) { clifford.get_matrix(matrix); });
+            }, py::arg("out") = py::none(), "Returns the matrix of the Clifford (with respect to the computational basis), as a complex64 numpy array. If out (a C-contiguous complex64 or complex128 array of the same size) is given, the matrix is written into it instead, in that precision")
+            .def("conjugate", py::overload_cast<const Pauli &>(&Clifford::conjugate, py::const_), py::arg("pauli"), "Returns UPU* for a Pauli P, with its phase. Raises ValueError if the numbers of qubits differ")
+            .def("conjugate", [](const Clifford &clifford, const std::vector<Pauli> &paulis)
+            {
+                py::gil_scoped_release release;
+                return clifford.conjugate(std::span<const Pauli>(paulis));
+            }, py::arg("paulis"), "Returns the list[Pauli] of UPU* for each Pauli P in the list, split between threads")
+            .def("apply", py::overload_cast<const Check_Matrix &>(&Clifford::apply, py::const_), py::arg("check_matrix"), "Returns the Check_Matrix of U|psi> for the state |psi> of the check matrix, by conjugating its Paulis")
+            .def("apply", py::overload_cast<const Stabiliser_State &>(&Clifford::apply, py::const_), py::arg("state"), "Returns the Stabiliser_State U|psi>, including its global phase, in polynomial time without building either state vector. Raises ValueError if the numbers of qubits differ")
+            .def("apply", [](const Clifford &clifford, const py::array &state_vector)
+            {
+                return write_array({py::ssize_t(1) << clifford.number_qubits}, state_vector, [&](const auto amplitudes) { clifford.apply(amplitudes); });
+            }, py::arg("state_vector").noconvert(), "Applies the Clifford to a state vector in place, in O(n 2^n) time without building its matrix, and returns the same array. The state vector must be a writeable C-contiguous complex64 or complex128 array of length 2^n")
+            .def_static("identity", &Clifford::identity, py::arg("number_qubits"), "Returns the identity Clifford on number_qubits qubits")
+            .def("compose", &Clifford::compose, py::arg("other"), "Returns the Clifford UV which applies other (V) and then this Clifford (U), including its global phase, in polynomial time from the tableaux alone. Raises ValueError if the numbers of qubits differ")
+            .def("inverse", &Clifford::inverse, "Returns the inverse of the Clifford, including its global phase, in polynomial time from the tableau alone")
+            .def("power", &Clifford::power, py::arg("exponent"), "Returns the Clifford raised to an integer power (negative for powers of the inverse) by repeated squaring, in polynomial time")
             .doc() = "The class used to represent a Clifford operator U. Represented by its action on the Pauli basis: z_conjugates[i] = UZ_iU*, x_conjugates[i] = UX_iU*";
     }
 }
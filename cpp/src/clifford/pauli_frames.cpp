@@ -0,0 +1,496 @@
+#include "pauli_frames.h"
+#include "stabiliser_state/stabiliser_state.h"
+#include "util/f2_helper.h"
+#include "util/parallel.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <numeric>
+#include <stdexcept>
+#include <utility>
+
+namespace
+{
+    using namespace fst;
+    using word_type = F2_Matrix::word_type;
+
+    /// Each thread runs the circuit on tiles of this many words of shots, which stay in cache
+    constexpr std::size_t words_per_tile = 8;
+
+    /// Each thread gets at least this many (gate, word) pairs, or (Pauli, word) pairs
+    constexpr std::size_t minimum_word_operations_per_task = 1 << 16;
+
+    std::size_t get_number_tasks(const std::size_t number_words, const std::size_t word_operations)
+    {
+        return std::min({get_number_threads(), std::max<std::size_t>(1, number_words), std::max<std::size_t>(1, word_operations / minimum_word_operations_per_task)});
+    }
+
+    /// Calls hit(shot) for each of number_shots shots independently with the given probability. The gaps
+    /// between hits are geometrically distributed, so each is drawn with one output of generator
+    template <class Hit>
+    void for_each_random_shot(const std::size_t number_shots, const double probability, Random_Generator &generator, Hit &&hit)
+    {
+        if (!(probability >= 0 && probability <= 1))
+        {
+            throw std::invalid_argument("The probability of an error must be between 0 and 1");
+        }
+
+        if (probability == 0)
+        {
+            return;
+        }
+
+        if (probability == 1)
+        {
+            for (std::size_t shot = 0; shot < number_shots; shot++)
+            {
+                hit(shot);
+            }
+
+            return;
+        }
+
+        const double log_miss = std::log1p(-probability);
+
+        for (std::size_t shot = 0;; shot++)
+        {
+            // uniform in (0, 1], so its logarithm is finite
+            const double uniform = double((generator() >> 11) + 1) * 0x1p-53;
+            const double gap = std::floor(std::log(uniform) / log_miss);
+
+            if (gap >= double(number_shots - shot))
+            {
+                return;
+            }
+
+            shot += std::size_t(gap);
+            hit(shot);
+        }
+    }
+
+    /// The local qubits on which a conjugate UX_jU* or UZ_jU* of a Clifford on k qubits has an X part, and those on
+    /// which it has a Z part
+    struct Local_Support
+    {
+        std::vector<std::size_t> x_qubits;
+        std::vector<std::size_t> z_qubits;
+    };
+
+    template <f2_vector_like Bits>
+    Local_Support make_local_support(const Basic_Pauli<Bits> &pauli, const std::size_t number_qubits)
+    {
+        if (pauli.number_qubits != number_qubits)
+        {
+            throw std::invalid_argument("The conjugates of the Clifford must be Paulis on the same number of qubits as it");
+        }
+
+        Local_Support support;
+
+        for_each_set_bit(pauli.x_vector, [&](const std::size_t qubit) { support.x_qubits.push_back(qubit); });
+        for_each_set_bit(pauli.z_vector, [&](const std::size_t qubit) { support.z_qubits.push_back(qubit); });
+
+        return support;
+    }
+}
+
+namespace fst
+{
+    template <f2_vector_like Bits>
+    Basic_Pauli_Frames<Bits>::Basic_Pauli_Frames(const std::size_t number_qubits, const std::size_t number_shots)
+        : number_qubits(number_qubits), number_shots(number_shots), x_columns(number_qubits, number_shots), z_columns(number_qubits, number_shots)
+    {
+    }
+
+    template <f2_vector_like Bits>
+    Basic_Pauli_Frames<Bits>::Basic_Pauli_Frames(std::span<const Pauli_Type> paulis)
+        : Basic_Pauli_Frames(paulis.empty() ? 0 : paulis.front().number_qubits, paulis.size())
+    {
+        for (std::size_t shot = 0; shot < number_shots; shot++)
+        {
+            const Pauli_Type &pauli = paulis[shot];
+
+            if (pauli.number_qubits != number_qubits)
+            {
+                throw std::invalid_argument("The frames must be Paulis on the same number of qubits");
+            }
+
+            for_each_set_bit(pauli.x_vector, [&](const std::size_t qubit) { x_columns.flip(qubit, shot); });
+            for_each_set_bit(pauli.z_vector, [&](const std::size_t qubit) { z_columns.flip(qubit, shot); });
+        }
+    }
+
+    template <f2_vector_like Bits>
+    std::size_t Basic_Pauli_Frames<Bits>::get_number_qubits() const
+    {
+        return number_qubits;
+    }
+
+    template <f2_vector_like Bits>
+    std::size_t Basic_Pauli_Frames<Bits>::get_number_shots() const
+    {
+        return number_shots;
+    }
+
+    template <f2_vector_like Bits>
+    void Basic_Pauli_Frames<Bits>::check_qubit(const std::size_t qubit) const
+    {
+        if (qubit >= number_qubits)
+        {
+            throw std::invalid_argument("The qubit must be less than the number of qubits");
+        }
+    }
+
+    template <f2_vector_like Bits>
+    void Basic_Pauli_Frames<Bits>::x_error(const std::size_t qubit, const double probability, Random_Generator &generator)
+    {
+        check_qubit(qubit);
+        for_each_random_shot(number_shots, probability, generator, [&](const std::size_t shot) { x_columns.flip(qubit, shot); });
+    }
+
+    template <f2_vector_like Bits>
+    void Basic_Pauli_Frames<Bits>::y_error(const std::size_t qubit, const double probability, Random_Generator &generator)
+    {
+        check_qubit(qubit);
+        for_each_random_shot(number_shots, probability, generator, [&](const std::size_t shot)
+        {
+            x_columns.flip(qubit, shot);
+            z_columns.flip(qubit, shot);
+        });
+    }
+
+    template <f2_vector_like Bits>
+    void Basic_Pauli_Frames<Bits>::z_error(const std::size_t qubit, const double probability, Random_Generator &generator)
+    {
+        check_qubit(qubit);
+        for_each_random_shot(number_shots, probability, generator, [&](const std::size_t shot) { z_columns.flip(qubit, shot); });
+    }
+
+    template <f2_vector_like Bits>
+    void Basic_Pauli_Frames<Bits>::depolarise(const std::size_t qubit, const double probability, Random_Generator &generator)
+    {
+        check_qubit(qubit);
+        for_each_random_shot(number_shots, probability, generator, [&](const std::size_t shot)
+        {
+            // 1, 2 or 3 uniformly, for X, Z and Y
+            const unsigned int kind = 1 + static_cast<unsigned int>(((generator() >> 32) * 3) >> 32);
+
+            if (kind & 1)
+            {
+                x_columns.flip(qubit, shot);
+            }
+
+            if (kind & 2)
+            {
+                z_columns.flip(qubit, shot);
+            }
+        });
+    }
+
+    template <f2_vector_like Bits>
+    void Basic_Pauli_Frames<Bits>::apply_to_words(const Gate &gate, const std::size_t first_word, const std::size_t end_word)
+    {
+        word_type *x_1 = x_columns.row(gate.first_qubit).data();
+        word_type *z_1 = z_columns.row(gate.first_qubit).data();
+        word_type *x_2 = x_columns.row(gate.second_qubit).data();
+        word_type *z_2 = z_columns.row(gate.second_qubit).data();
+
+        switch (gate.type)
+        {
+            case Gate_Type::h:
+                std::swap_ranges(x_1 + first_word, x_1 + end_word, z_1 + first_word);
+                break;
+            case Gate_Type::s:
+            case Gate_Type::s_dagger:
+                for (std::size_t w = first_word; w < end_word; w++)
+                {
+                    z_1[w] ^= x_1[w];
+                }
+                break;
+            case Gate_Type::x:
+            case Gate_Type::y:
+            case Gate_Type::z:
+                break;
+            case Gate_Type::cx:
+                for (std::size_t w = first_word; w < end_word; w++)
+                {
+                    x_2[w] ^= x_1[w];
+                    z_1[w] ^= z_2[w];
+                }
+                break;
+            case Gate_Type::cz:
+                for (std::size_t w = first_word; w < end_word; w++)
+                {
+                    z_1[w] ^= x_2[w];
+                    z_2[w] ^= x_1[w];
+                }
+                break;
+            case Gate_Type::swap:
+                std::swap_ranges(x_1 + first_word, x_1 + end_word, x_2 + first_word);
+                std::swap_ranges(z_1 + first_word, z_1 + end_word, z_2 + first_word);
+                break;
+        }
+    }
+
+    template <f2_vector_like Bits>
+    void Basic_Pauli_Frames<Bits>::apply_gate(const Gate &gate)
+    {
+        apply_gates(std::span<const Gate>(&gate, 1));
+    }
+
+    template <f2_vector_like Bits>
+    void Basic_Pauli_Frames<Bits>::apply_gates(std::span<const Gate> gates)
+    {
+        for (const Gate &gate : gates)
+        {
+            const bool two_qubit = gate.type == Gate_Type::cx || gate.type == Gate_Type::cz || gate.type == Gate_Type::swap;
+
+            if (gate.first_qubit >= number_qubits || (two_qubit && gate.second_qubit >= number_qubits))
+            {
+                throw std::invalid_argument("The qubits of a gate must be less than the number of qubits");
+            }
+
+            if (two_qubit && gate.first_qubit == gate.second_qubit)
+            {
+                throw std::invalid_argument("The qubits of a two qubit gate must be different");
+            }
+        }
+
+        const std::size_t number_words = x_columns.row_words();
+        const std::size_t number_tiles = (number_words + words_per_tile - 1) / words_per_tile;
+
+        if (number_tiles == 0)
+        {
+            return;
+        }
+
+        const std::size_t number_tasks = std::min(number_tiles, get_number_tasks(number_words, gates.size() * number_words));
+
+        parallel_for(number_tasks, [&](const std::size_t task)
+        {
+            for (std::size_t tile = task; tile < number_tiles; tile += number_tasks)
+            {
+                const std::size_t first_word = tile * words_per_tile;
+                const std::size_t end_word = std::min(number_words, first_word + words_per_tile);
+
+                for (const Gate &gate : gates)
+                {
+                    apply_to_words(gate, first_word, end_word);
+                }
+            }
+        });
+    }
+
+    template <f2_vector_like Bits>
+    void Basic_Pauli_Frames<Bits>::apply_clifford(const Basic_Clifford<Bits> &clifford)
+    {
+        std::vector<std::size_t> qubits(number_qubits);
+        std::iota(qubits.begin(), qubits.end(), 0);
+
+        apply_clifford(clifford, qubits);
+    }
+
+    template <f2_vector_like Bits>
+    void Basic_Pauli_Frames<Bits>::apply_clifford(const Basic_Clifford<Bits> &clifford, std::span<const std::size_t> qubits)
+    {
+        const std::size_t number_clifford_qubits = qubits.size();
+
+        if (clifford.number_qubits != number_clifford_qubits || clifford.z_conjugates.size() != number_clifford_qubits || clifford.x_conjugates.size() != number_clifford_qubits)
+        {
+            throw std::invalid_argument("The Clifford must act on the given number of qubits");
+        }
+
+        std::vector<bool> used(number_qubits, false);
+
+        for (const std::size_t qubit : qubits)
+        {
+            if (qubit >= number_qubits || used[qubit])
+            {
+                throw std::invalid_argument("The qubits of the Clifford must be different, and less than the number of qubits");
+            }
+
+            used[qubit] = true;
+        }
+
+        std::vector<Local_Support> x_images;
+        std::vector<Local_Support> z_images;
+        std::size_t support_size = 0;
+
+        for (std::size_t j = 0; j < number_clifford_qubits; j++)
+        {
+            x_images.push_back(make_local_support(clifford.x_conjugates[j], number_clifford_qubits));
+            z_images.push_back(make_local_support(clifford.z_conjugates[j], number_clifford_qubits));
+            support_size += x_images[j].x_qubits.size() + x_images[j].z_qubits.size() + z_images[j].x_qubits.size() + z_images[j].z_qubits.size();
+        }
+
+        const std::size_t number_words = x_columns.row_words();
+
+        if (number_words == 0)
+        {
+            return;
+        }
+
+        const std::size_t number_tasks = get_number_tasks(number_words, number_words * std::max<std::size_t>(1, support_size));
+
+        parallel_for(number_tasks, [&](const std::size_t task)
+        {
+            std::vector<word_type> x_words(number_clifford_qubits);
+            std::vector<word_type> z_words(number_clifford_qubits);
+
+            for (std::size_t w = task * number_words / number_tasks; w < (task + 1) * number_words / number_tasks; w++)
+            {
+                std::fill(x_words.begin(), x_words.end(), 0);
+                std::fill(z_words.begin(), z_words.end(), 0);
+
+                // Up to phase, UEU* is the product of the conjugates of the X and Z parts of E on each qubit
+                const auto multiply = [&](const Local_Support &image, const word_type mask)
+                {
+                    for (const std::size_t qubit : image.x_qubits)
+                    {
+                        x_words[qubit] ^= mask;
+                    }
+
+                    for (const std::size_t qubit : image.z_qubits)
+                    {
+                        z_words[qubit] ^= mask;
+                    }
+                };
+
+                for (std::size_t j = 0; j < number_clifford_qubits; j++)
+                {
+                    multiply(x_images[j], x_columns.row(qubits[j])[w]);
+                    multiply(z_images[j], z_columns.row(qubits[j])[w]);
+                }
+
+                for (std::size_t j = 0; j < number_clifford_qubits; j++)
+                {
+                    x_columns.row(qubits[j])[w] = x_words[j];
+                    z_columns.row(qubits[j])[w] = z_words[j];
+                }
+            }
+        });
+    }
+
+    template <f2_vector_like Bits>
+    std::vector<Basic_Pauli<Bits>> Basic_Pauli_Frames<Bits>::get_paulis() const
+    {
+        std::vector<Pauli_Type> paulis;
+        paulis.reserve(number_shots);
+
+        for (std::size_t shot = 0; shot < number_shots; shot++)
+        {
+            Bits x_vector = zero_vector<Bits>(number_qubits);
+            Bits z_vector = zero_vector<Bits>(number_qubits);
+            unsigned int ys = 0;
+
+            for (std::size_t qubit = 0; qubit < number_qubits; qubit++)
+            {
+                const bool x_bit = x_columns.get(qubit, shot);
+                const bool z_bit = z_columns.get(qubit, shot);
+
+                if (x_bit)
+                {
+                    set_bit(x_vector, qubit);
+                }
+
+                if (z_bit)
+                {
+                    set_bit(z_vector, qubit);
+                }
+
+                ys += x_bit && z_bit;
+            }
+
+            // The phase exponent 2 * sign_bit + 3 * imag_bit is the number of Ys
+            const unsigned int phase_exponent = ys % 4;
+            const unsigned int imag_bit = phase_exponent & 1;
+
+            paulis.emplace_back(number_qubits, x_vector, z_vector, ((phase_exponent + 4 - 3 * imag_bit) % 4) / 2, imag_bit);
+        }
+
+        return paulis;
+    }
+
+    template <f2_vector_like Bits>
+    F2_Matrix Basic_Pauli_Frames<Bits>::get_flips(std::span<const Pauli_Type> paulis) const
+    {
+        std::vector<Local_Support> supports;
+        std::size_t support_size = 0;
+
+        for (const Pauli_Type &pauli : paulis)
+        {
+            if (pauli.number_qubits != number_qubits)
+            {
+                throw std::invalid_argument("The Paulis must be on the same number of qubits as the frames");
+            }
+
+            supports.push_back(make_local_support(pauli, number_qubits));
+            support_size += supports.back().x_qubits.size() + supports.back().z_qubits.size();
+        }
+
+        F2_Matrix flips(paulis.size(), number_shots);
+        const std::size_t number_words = x_columns.row_words();
+        const std::size_t number_tasks = std::min(std::max<std::size_t>(1, paulis.size()), get_number_tasks(paulis.size(), number_words * support_size));
+
+        // The frame anticommutes with P when the X part of one meets the Z part of the other on an odd number of qubits
+        parallel_for(number_tasks, [&](const std::size_t task)
+        {
+            for (std::size_t k = task * paulis.size() / number_tasks; k < (task + 1) * paulis.size() / number_tasks; k++)
+            {
+                const std::span<word_type> row = flips.row(k);
+
+                for (const std::size_t qubit : supports[k].x_qubits)
+                {
+                    const std::span<const word_type> z_row = z_columns.row(qubit);
+                    std::transform(row.begin(), row.end(), z_row.begin(), row.begin(), std::bit_xor<word_type>());
+                }
+
+                for (const std::size_t qubit : supports[k].z_qubits)
+                {
+                    const std::span<const word_type> x_row = x_columns.row(qubit);
+                    std::transform(row.begin(), row.end(), x_row.begin(), row.begin(), std::bit_xor<word_type>());
+                }
+            }
+        });
+
+        return flips;
+    }
+
+    template <f2_vector_like Bits>
+    F2_Matrix Basic_Pauli_Frames<Bits>::get_flips(const Basic_Check_Matrix<Bits> &check_matrix) const
+    {
+        return get_flips(std::span<const Pauli_Type>(check_matrix.get_paulis()));
+    }
+
+    template <f2_vector_like Bits>
+    std::vector<Bits> Basic_Pauli_Frames<Bits>::sample(const Basic_Check_Matrix<Bits> &check_matrix, const std::uint64_t seed) const
+        requires std::unsigned_integral<Bits>
+    {
+        if (check_matrix.number_qubits != number_qubits)
+        {
+            throw std::invalid_argument("The check matrix must be on the same number of qubits as the frames");
+        }
+
+        Basic_Check_Matrix<Bits> reference = check_matrix;
+        const Basic_Stabiliser_State<Bits> state(reference);
+        std::vector<Bits> outcomes = state.sample(number_shots, seed);
+
+        for (std::size_t qubit = 0; qubit < number_qubits; qubit++)
+        {
+            const std::span<const word_type> x_row = x_columns.row(qubit);
+
+            for (std::size_t w = 0; w < x_row.size(); w++)
+            {
+                for (word_type rest = x_row[w]; rest != 0; rest &= rest - 1)
+                {
+                    outcomes[w * F2_Matrix::word_size + std::countr_zero(rest)] ^= Bits(1) << qubit;
+                }
+            }
+        }
+
+        return outcomes;
+    }
+
+    template class Basic_Pauli_Frames<std::size_t>;
+    template class Basic_Pauli_Frames<F2_Vector>;
+}
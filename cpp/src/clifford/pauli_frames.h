@@ -0,0 +1,103 @@
+#ifndef _FAST_STABILISER_PAULI_FRAMES_H
+#define _FAST_STABILISER_PAULI_FRAMES_H
+
+#include "clifford.h"
+#include "tableau_simulator.h"
+#include "pauli/pauli.h"
+#include "stabiliser_state/check_matrix.h"
+#include "util/f2_matrix.h"
+#include "util/random.h"
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace fst
+{
+    /// A batch of Pauli frames, one per shot of a noisy Clifford circuit, for Monte-Carlo sampling. A frame is the
+    /// Pauli error E (up to phase) carried by a shot, so the shot is in the state E|psi> for the state |psi> of the
+    /// noiseless circuit, and a Clifford U takes E to UEU*.
+    ///
+    /// The frames are stored bit-sliced as in Basic_Tableau_Simulator: for each qubit, one row of bits over the
+    /// shots for the X parts and one for the Z parts, so each gate or error on a qubit touches O(number of
+    /// shots / 64) words, and no phases are tracked.
+    ///
+    /// As for Basic_Pauli, Bits is std::size_t (the Pauli_Frames alias, up to 64 qubits) or F2_Vector (the
+    /// Wide_Pauli_Frames alias, any number of qubits).
+    template <f2_vector_like Bits>
+    class Basic_Pauli_Frames
+    {
+        public:
+        using Pauli_Type = Basic_Pauli<Bits>;
+        using word_type = F2_Matrix::word_type;
+
+        /// number_shots frames on number_qubits qubits, each the identity
+        Basic_Pauli_Frames(const std::size_t number_qubits, const std::size_t number_shots);
+
+        /// One frame per Pauli, ignoring their phases. Throws std::invalid_argument if the numbers of qubits differ
+        explicit Basic_Pauli_Frames(std::span<const Pauli_Type> paulis);
+
+        std::size_t get_number_qubits() const;
+        std::size_t get_number_shots() const;
+
+        /// Multiply each frame by X (or Y, or Z) on the qubit with the given probability, independently for each
+        /// shot. The shots hit are found by skipping geometrically distributed gaps, so this draws from generator
+        /// about once per error rather than once per shot. Each throws std::invalid_argument if the qubit is out of
+        /// range or the probability is not in [0, 1]
+        void x_error(const std::size_t qubit, const double probability, Random_Generator &generator);
+        void y_error(const std::size_t qubit, const double probability, Random_Generator &generator);
+        void z_error(const std::size_t qubit, const double probability, Random_Generator &generator);
+
+        /// Multiplies each frame by X, Y or Z on the qubit, each with probability probability / 3
+        void depolarise(const std::size_t qubit, const double probability, Random_Generator &generator);
+
+        /// Conjugates each frame by the gate (a Pauli gate leaves the frames unchanged, as phases are not tracked).
+        /// Throws std::invalid_argument as for Basic_Tableau_Simulator::apply_gate
+        void apply_gate(const Gate &gate);
+
+        /// Applies the gates in order. Every gate is checked before any is applied, and the shots are split into
+        /// tiles of a few words, each run through the whole circuit while it is in cache, with the tiles split
+        /// between threads
+        void apply_gates(std::span<const Gate> gates);
+
+        /// Conjugates each frame by a Clifford on the given qubits (in order), or on all the qubits. Each frame
+        /// becomes the product of the conjugates of its X and Z parts, which is a few word XORs per 64 shots for
+        /// each Pauli in the support of a conjugate. Throws std::invalid_argument as for
+        /// Basic_Tableau_Simulator::apply_clifford
+        void apply_clifford(const Basic_Clifford<Bits> &clifford);
+        void apply_clifford(const Basic_Clifford<Bits> &clifford, std::span<const std::size_t> qubits);
+
+        /// Returns the frames, each as a Hermitian Pauli with sign +1
+        std::vector<Pauli_Type> get_paulis() const;
+
+        /// Returns the matrix with a row for each Pauli P and a column for each shot, with entry 1 if the frame
+        /// anticommutes with P. Measuring P then gives the opposite outcome to the noiseless circuit, so for the
+        /// generators of a check matrix these are the flipped syndrome bits. Throws std::invalid_argument if the
+        /// numbers of qubits differ
+        F2_Matrix get_flips(std::span<const Pauli_Type> paulis) const;
+        F2_Matrix get_flips(const Basic_Check_Matrix<Bits> &check_matrix) const;
+
+        /// Returns one computational basis measurement outcome per shot (bit q for qubit q), for the state E|psi>
+        /// of each frame E and the state |psi> of the reference check matrix. The outcome is a sample of |psi>
+        /// (see write_samples, from the stream given by seed) with the X part of E added, as E only permutes
+        /// the computational basis up to phases. Throws std::invalid_argument if the numbers of qubits differ
+        std::vector<Bits> sample(const Basic_Check_Matrix<Bits> &check_matrix, const std::uint64_t seed) const
+            requires std::unsigned_integral<Bits>;
+
+        private:
+        std::size_t number_qubits = 0;
+        std::size_t number_shots = 0;
+
+        /// Row q holds the X (or Z) bits on qubit q of each of the frames
+        F2_Matrix x_columns;
+        F2_Matrix z_columns;
+
+        void check_qubit(const std::size_t qubit) const;
+        void apply_to_words(const Gate &gate, const std::size_t first_word, const std::size_t end_word);
+    };
+
+    using Pauli_Frames = Basic_Pauli_Frames<std::size_t>;
+    using Wide_Pauli_Frames = Basic_Pauli_Frames<F2_Vector>;
+}
+
+#endif
@@ -0,0 +1,122 @@
+#ifndef _FAST_STABILISER_PAULI_FRAMES_PYBIND_H
+#define _FAST_STABILISER_PAULI_FRAMES_PYBIND_H
+
+#include <pybind11/pybind11.h>
+#include <pybind11/numpy.h>
+#include <pybind11/stl.h>
+
+#include "pauli_frames.h"
+#include "util/numpy_pybind.h"
+#include "util/random_pybind.h"
+
+#include <optional>
+
+namespace py = pybind11;
+using namespace fst;
+
+namespace fst_pybind
+{
+    /// The kinds of error, each given its own stream of a seed on each qubit
+    enum class Error_Kind : std::uint64_t
+    {
+        x,
+        y,
+        z,
+        depolarising
+    };
+
+    /// Returns the generator for an error of the given kind on the qubit, from seed (or from std::random_device if
+    /// seed is None). Each (qubit, kind) pair has its own stream, so reusing one seed across qubits or kinds of
+    /// error does not correlate the errors
+    inline Random_Generator make_error_generator(const std::optional<std::uint64_t> seed, const std::size_t qubit, const Error_Kind kind)
+    {
+        return make_generator(seed, 4 * std::uint64_t(qubit) + std::uint64_t(kind));
+    }
+
+    void init_pauli_frames(py::module_ &m)
+    {
+        py::class_<Pauli_Frames>(m, "Pauli_Frames")
+            .def(py::init<const std::size_t, const std::size_t>(), py::arg("number_qubits"), py::arg("number_shots"))
+            .def(py::init([](const std::vector<Pauli> &paulis) { return Pauli_Frames(paulis); }), py::arg("paulis"))
+            .def("get_number_qubits", &Pauli_Frames::get_number_qubits)
+            .def("get_number_shots", &Pauli_Frames::get_number_shots)
+            .def("x_error", [](Pauli_Frames &frames, const std::size_t qubit, const double probability, const std::optional<std::uint64_t> seed)
+            {
+                Random_Generator generator = make_error_generator(seed, qubit, Error_Kind::x);
+                frames.x_error(qubit, probability, generator);
+            }, py::arg("qubit"), py::arg("probability"), py::arg("seed") = py::none(), "Multiplies each frame by X on the qubit with the given probability, independently for each shot, drawn from seed (or std::random_device if seed is None). Each qubit and kind of error has its own stream of the seed, so one seed can be reused across qubits without correlating their errors")
+            .def("y_error", [](Pauli_Frames &frames, const std::size_t qubit, const double probability, const std::optional<std::uint64_t> seed)
+            {
+                Random_Generator generator = make_error_generator(seed, qubit, Error_Kind::y);
+                frames.y_error(qubit, probability, generator);
+            }, py::arg("qubit"), py::arg("probability"), py::arg("seed") = py::none(), "As x_error, for Y")
+            .def("z_error", [](Pauli_Frames &frames, const std::size_t qubit, const double probability, const std::optional<std::uint64_t> seed)
+            {
+                Random_Generator generator = make_error_generator(seed, qubit, Error_Kind::z);
+                frames.z_error(qubit, probability, generator);
+            }, py::arg("qubit"), py::arg("probability"), py::arg("seed") = py::none(), "As x_error, for Z")
+            .def("depolarise", [](Pauli_Frames &frames, const std::size_t qubit, const double probability, const std::optional<std::uint64_t> seed)
+            {
+                Random_Generator generator = make_error_generator(seed, qubit, Error_Kind::depolarising);
+                frames.depolarise(qubit, probability, generator);
+            }, py::arg("qubit"), py::arg("probability"), py::arg("seed") = py::none(), "Multiplies each frame by X, Y or Z on the qubit, each with probability probability / 3, drawn as for x_error")
+            .def("apply_gate", &Pauli_Frames::apply_gate, py::arg("gate"))
+            .def("apply_gates", [](Pauli_Frames &frames, const std::vector<Gate> &gates)
+            {
+                py::gil_scoped_release release;
+                frames.apply_gates(gates);
+            }, py::arg("gates"), "Conjugates each frame by a list of Gates in order. Every gate is checked before any is applied (raising ValueError for invalid qubits), and the shots are split between threads")
+            .def("apply_clifford", [](Pauli_Frames &frames, const Clifford &clifford, const std::optional<std::vector<std::size_t>> &qubits)
+            {
+                py::gil_scoped_release release;
+
+                if (qubits)
+                {
+                    frames.apply_clifford(clifford, *qubits);
+                }
+                else
+                {
+                    frames.apply_clifford(clifford);
+                }
+            }, py::arg("clifford"), py::arg("qubits") = py::none(), "Conjugates each frame by a Clifford on the given list of qubits (in order), or on all the qubits if qubits is None")
+            .def("get_paulis", &Pauli_Frames::get_paulis, "Returns the list[Pauli] of frames, each Hermitian with sign +1")
+            .def("get_flips", [](const Pauli_Frames &frames, const std::vector<Pauli> &paulis)
+            {
+                F2_Matrix flips;
+                {
+                    py::gil_scoped_release release;
+                    flips = frames.get_flips(std::span<const Pauli>(paulis));
+                }
+
+                const std::size_t number_shots = frames.get_number_shots();
+                py::array_t<std::uint8_t> bits(std::vector<py::ssize_t>{static_cast<py::ssize_t>(number_shots), static_cast<py::ssize_t>(paulis.size())});
+                std::uint8_t *bits_data = bits.mutable_data();
+
+                for (std::size_t shot = 0; shot < number_shots; shot++)
+                {
+                    for (std::size_t k = 0; k < paulis.size(); k++)
+                    {
+                        bits_data[shot * paulis.size() + k] = flips.get(k, shot);
+                    }
+                }
+
+                return bits;
+            }, py::arg("paulis"), "Returns a uint8 numpy array of shape (number_shots, len(paulis)), with entry 1 where the frame anticommutes with the Pauli, so that measuring it gives the opposite outcome to the noiseless circuit. Pass the Paulis of a Check_Matrix for its flipped syndrome bits")
+            .def("sample", [](const Pauli_Frames &frames, const Check_Matrix &check_matrix, const std::optional<std::uint64_t> seed)
+            {
+                const std::uint64_t stream_seed = get_seed(seed);
+
+                std::vector<std::size_t> shots;
+                {
+                    py::gil_scoped_release release;
+                    shots = frames.sample(check_matrix, stream_seed);
+                }
+
+                const py::ssize_t number_shots = static_cast<py::ssize_t>(shots.size());
+                return to_numpy(std::move(shots), {number_shots});
+            }, py::arg("check_matrix"), py::arg("seed") = py::none(), "Returns one computational basis measurement outcome per shot, as a uint64 numpy array (bit q for qubit q), for the state E|psi> of each frame E and the state |psi> of the check matrix. The samples of |psi> are drawn from seed as for Stabiliser_State.sample")
+            .doc() = "A batch of Pauli frames, one per shot of a noisy Clifford circuit, stored bit-sliced so that each gate or error touches O(number of shots / 64) words. Phases are not tracked";
+    }
+}
+
+#endif
@@ -0,0 +1,538 @@
+#include "state_vector_layers.h"
+#include "util/f2_helper.h"
+#include "util/parallel.h"
+
+#include <algorithm>
+#include <bit>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace
+{
+    using namespace fst;
+
+    /// Each thread gets at least this many amplitudes
+    constexpr std::size_t minimum_amplitudes_per_task = 1 << 14;
+
+    /// Blocks of the phase and involution layers, and tiles of the Hadamard layer, are at most 2^max_block_bits
+    /// amplitudes, so they stay in L1 cache
+    constexpr std::size_t max_block_bits = 12;
+
+    /// A linear layer is eliminated this many columns at a time, each batch a linear map on this many bits and
+    /// one involution, so each pass over the vector does this many columns of the elimination
+    constexpr std::size_t batch_bits = 8;
+
+    /// The Hadamards on qubits above the tiles are done this many at a time, on 2^hadamard_group_qubits strided
+    /// amplitudes
+    constexpr std::size_t hadamard_group_qubits = 4;
+
+    std::size_t get_number_tasks(const std::size_t number_amplitudes)
+    {
+        return std::min(get_number_threads(), std::max<std::size_t>(1, number_amplitudes / minimum_amplitudes_per_task));
+    }
+
+    /// Calls body(first, end) on contiguous ranges splitting [0, size) between threads
+    template <class Body>
+    void parallel_ranges(const std::size_t size, const std::size_t amplitudes_per_index, Body &&body)
+    {
+        const std::size_t number_tasks = std::min(get_number_tasks(size * amplitudes_per_index), std::max<std::size_t>(1, size));
+
+        parallel_for(number_tasks, [&](const std::size_t task)
+        {
+            body(task * size / number_tasks, (task + 1) * size / number_tasks);
+        });
+    }
+
+    /// Returns i with zero bits inserted at the positions, which must be in increasing order, moving the higher
+    /// bits up
+    std::size_t insert_zero_bits(std::size_t i, std::span<const std::size_t> positions)
+    {
+        for (const std::size_t position : positions)
+        {
+            const std::size_t low_bits = integral_pow_2(position) - 1;
+            i = ((i & ~low_bits) << 1) | (i & low_bits);
+        }
+
+        return i;
+    }
+
+    /// Returns the table of the sums of subsets of the vectors: entry c is the sum of the vectors[j] with c_j = 1
+    std::vector<std::size_t> get_subset_sums(std::span<const std::size_t> vectors)
+    {
+        std::vector<std::size_t> sums(integral_pow_2(vectors.size()), 0);
+
+        for (std::size_t c = 1; c < sums.size(); c++)
+        {
+            sums[c] = sums[c & (c - 1)] ^ vectors[std::countr_zero(c)];
+        }
+
+        return sums;
+    }
+
+    /// For each base index with the bits at the positions (in increasing order) clear, reads the 2^k amplitudes at
+    /// base + deposit(c) into buffer[c], calls transform(buffer), and writes them back
+    template <std::floating_point Scalar, class Transform>
+    void transform_cosets(std::span<std::complex<Scalar>> state_vector, std::span<const std::size_t> positions, Transform &&transform)
+    {
+        std::vector<std::size_t> unit_vectors;
+
+        for (const std::size_t position : positions)
+        {
+            unit_vectors.push_back(integral_pow_2(position));
+        }
+
+        const std::vector<std::size_t> offsets = get_subset_sums(unit_vectors);
+
+        parallel_ranges(state_vector.size() / offsets.size(), offsets.size(), [&](const std::size_t first, const std::size_t end)
+        {
+            std::vector<std::complex<Scalar>> buffer(offsets.size());
+
+            for (std::size_t i = first; i < end; i++)
+            {
+                const std::size_t base = insert_zero_bits(i, positions);
+
+                for (std::size_t c = 0; c < offsets.size(); c++)
+                {
+                    buffer[c] = state_vector[base | offsets[c]];
+                }
+
+                transform(buffer);
+
+                for (std::size_t c = 0; c < offsets.size(); c++)
+                {
+                    state_vector[base | offsets[c]] = buffer[c];
+                }
+            }
+        });
+    }
+
+    /// Moves the amplitude at each index x to x + Nx, for the matrix N with columns N e_j = columns[j] and N^2 = 0.
+    /// Then x + Nx has the same image under N, so this is an involution, swapping the amplitudes of each pair
+    /// once from the index without the lowest bit of Nx. Nx is a table lookup for the low bits of x plus a sum of
+    /// columns once per block
+    template <std::floating_point Scalar>
+    void apply_involution(std::span<std::complex<Scalar>> state_vector, std::span<const std::size_t> columns)
+    {
+        const std::size_t block_bits = std::min(columns.size(), max_block_bits);
+        const std::size_t block_size = integral_pow_2(block_bits);
+        const std::vector<std::size_t> low_images = get_subset_sums(columns.first(block_bits));
+
+        parallel_ranges(state_vector.size() / block_size, block_size, [&](const std::size_t first, const std::size_t end)
+        {
+            for (std::size_t block = first; block < end; block++)
+            {
+                const std::size_t high = block << block_bits;
+                std::size_t high_image = 0;
+
+                for (std::size_t rest = high; rest != 0; rest &= rest - 1)
+                {
+                    high_image ^= columns[std::countr_zero(rest)];
+                }
+
+                for (std::size_t low = 0; low < block_size; low++)
+                {
+                    const std::size_t image = high_image ^ low_images[low];
+                    const std::size_t x = high | low;
+
+                    if (image != 0 && !bit_set_at(x, std::size_t(std::countr_zero(image))))
+                    {
+                        std::swap(state_vector[x], state_vector[x ^ image]);
+                    }
+                }
+            }
+        });
+    }
+
+    /// Moves the amplitude at each index x to the index with the bits at the positions (in increasing order)
+    /// replaced by Ac, for c those bits of x and the invertible matrix A with columns A e_j = local_columns[j]
+    template <std::floating_point Scalar>
+    void apply_local_map(std::span<std::complex<Scalar>> state_vector, std::span<const std::size_t> positions, std::span<const std::size_t> local_columns)
+    {
+        const std::vector<std::size_t> images = get_subset_sums(local_columns);
+
+        transform_cosets(state_vector, positions, [&, permuted = std::vector<std::complex<Scalar>>(images.size())](std::vector<std::complex<Scalar>> &buffer) mutable
+        {
+            for (std::size_t c = 0; c < buffer.size(); c++)
+            {
+                permuted[images[c]] = buffer[c];
+            }
+
+            std::swap(buffer, permuted);
+        });
+    }
+
+    /// Moves the amplitude at each index x to the index with bit permutation[k] equal to x_k. Each cycle
+    /// c_0 -> c_1 -> ... of the permutation is the reflection c_i -> c_(-i) followed by c_i -> c_(1 - i), so this
+    /// is two involutions
+    template <std::floating_point Scalar>
+    void apply_qubit_permutation(std::span<std::complex<Scalar>> state_vector, std::span<const std::size_t> permutation)
+    {
+        const std::size_t number_qubits = permutation.size();
+        std::vector<std::size_t> first_columns(number_qubits, 0);
+        std::vector<std::size_t> second_columns(number_qubits, 0);
+        std::vector<bool> visited(number_qubits, false);
+
+        for (std::size_t start = 0; start < number_qubits; start++)
+        {
+            std::vector<std::size_t> cycle;
+
+            for (std::size_t k = start; !visited[k]; k = permutation[k])
+            {
+                visited[k] = true;
+                cycle.push_back(k);
+            }
+
+            const std::size_t length = cycle.size();
+
+            for (std::size_t i = 0; i < length; i++)
+            {
+                first_columns[cycle[i]] = integral_pow_2(cycle[i]) ^ integral_pow_2(cycle[(length - i) % length]);
+                second_columns[cycle[i]] = integral_pow_2(cycle[i]) ^ integral_pow_2(cycle[(length + 1 - i) % length]);
+            }
+        }
+
+        if (std::ranges::any_of(first_columns, [](const std::size_t column) { return column != 0; }))
+        {
+            apply_involution(state_vector, std::span<const std::size_t>(first_columns));
+        }
+
+        if (std::ranges::any_of(second_columns, [](const std::size_t column) { return column != 0; }))
+        {
+            apply_involution(state_vector, std::span<const std::size_t>(second_columns));
+        }
+    }
+
+    /// Returns the inverse of the invertible k x k matrix over F_2 with rows rows[j], or throws
+    /// std::invalid_argument
+    std::vector<std::size_t> invert_local_matrix(std::vector<std::size_t> rows)
+    {
+        const std::size_t size = rows.size();
+        std::vector<std::size_t> inverse(size);
+
+        for (std::size_t j = 0; j < size; j++)
+        {
+            inverse[j] = integral_pow_2(j);
+        }
+
+        for (std::size_t k = 0; k < size; k++)
+        {
+            std::size_t pivot = k;
+
+            while (pivot < size && !bit_set_at(rows[pivot], k))
+            {
+                pivot++;
+            }
+
+            if (pivot == size)
+            {
+                throw std::invalid_argument("The map on the indices must be invertible");
+            }
+
+            std::swap(rows[pivot], rows[k]);
+            std::swap(inverse[pivot], inverse[k]);
+
+            for (std::size_t j = 0; j < size; j++)
+            {
+                if (j != k && bit_set_at(rows[j], k))
+                {
+                    rows[j] ^= rows[k];
+                    inverse[j] ^= inverse[k];
+                }
+            }
+        }
+
+        return inverse;
+    }
+
+    /// One batch of the elimination of a linear layer: the linear map A on the bits at the pivot rows, and the
+    /// involution x -> x + Nx clearing the batch of columns from the other rows
+    struct Elimination_Batch
+    {
+        std::vector<std::size_t> pivot_rows;
+        std::vector<std::size_t> local_columns;
+        std::vector<std::size_t> clearing_columns;
+    };
+}
+
+namespace fst
+{
+    template <std::floating_point Scalar>
+    void apply_phase_layer(std::span<std::complex<Scalar>> state_vector, const Phase_Form &form, const std::complex<Scalar> scale)
+    {
+        const std::size_t number_qubits = form.linear.size();
+
+        if (state_vector.size() != integral_pow_2(number_qubits))
+        {
+            throw std::invalid_argument("The state vector must have length 2^n for a form in n variables");
+        }
+
+        // For x = high | low, q(x) = q(high) + (q(low) - constant) + 2 (low.m mod 2), where m is the sum of the
+        // rows of the quadratic form for the bits of high
+        const std::size_t block_bits = std::min(number_qubits, max_block_bits);
+        const std::size_t block_size = integral_pow_2(block_bits);
+
+        std::vector<unsigned int> low_exponents(block_size);
+
+        for (std::size_t low = 0; low < block_size; low++)
+        {
+            low_exponents[low] = (form.evaluate(low) + 4 - form.constant % 4) % 4;
+        }
+
+        const auto phases = scaled_powers_of_i(scale);
+
+        parallel_ranges(state_vector.size() / block_size, block_size, [&](const std::size_t first, const std::size_t end)
+        {
+            for (std::size_t block = first; block < end; block++)
+            {
+                const std::size_t high = block << block_bits;
+                const unsigned int high_exponent = form.evaluate(high);
+                std::size_t mask = 0;
+
+                for (std::size_t rest = high; rest != 0; rest &= rest - 1)
+                {
+                    mask ^= form.quadratic_form[std::countr_zero(rest)];
+                }
+
+                mask &= block_size - 1;
+                std::complex<Scalar> *amplitudes = state_vector.data() + high;
+
+                for (std::size_t low = 0; low < block_size; low++)
+                {
+                    amplitudes[low] *= phases[(high_exponent + low_exponents[low] + 2 * f2_dot_product(low, mask)) % 4];
+                }
+            }
+        });
+    }
+
+    template <std::floating_point Scalar>
+    void apply_linear_layer(std::span<std::complex<Scalar>> state_vector, std::span<const std::size_t> columns)
+    {
+        const std::size_t number_qubits = columns.size();
+
+        if (state_vector.size() != integral_pow_2(number_qubits))
+        {
+            throw std::invalid_argument("The state vector must have length 2^n for a map on n bits");
+        }
+
+        // Row i holds bit i of each column
+        std::vector<std::size_t> rows(number_qubits, 0);
+
+        for (std::size_t j = 0; j < number_qubits; j++)
+        {
+            for (std::size_t i = 0; i < number_qubits; i++)
+            {
+                rows[i] |= std::size_t(bit_set_at(columns[j], i)) << j;
+            }
+        }
+
+        // Each batch of columns S picks pivot rows R with M[R, S] invertible, multiplies M on the left by its
+        // inverse on the rows R, then by the involution adding the rows R to the other rows to clear the columns S.
+        // This leaves a permutation matrix P, so M is the product of the inverses of these steps, then P
+        std::vector<Elimination_Batch> batches;
+        std::size_t used_rows = 0;
+
+        for (std::size_t first_column = 0; first_column < number_qubits; first_column += batch_bits)
+        {
+            const std::size_t batch_size = std::min(batch_bits, number_qubits - first_column);
+            const std::size_t batch_mask = (integral_pow_2(batch_size) - 1) << first_column;
+
+            Elimination_Batch batch;
+            std::vector<std::size_t> reduced_rows(number_qubits);
+
+            for (std::size_t i = 0; i < number_qubits; i++)
+            {
+                reduced_rows[i] = rows[i] & batch_mask;
+            }
+
+            for (std::size_t k = first_column; k < first_column + batch_size; k++)
+            {
+                std::size_t pivot = 0;
+
+                while (pivot < number_qubits && (bit_set_at(used_rows, pivot) || !bit_set_at(reduced_rows[pivot], k)))
+                {
+                    pivot++;
+                }
+
+                if (pivot == number_qubits)
+                {
+                    throw std::invalid_argument("The map on the indices must be invertible");
+                }
+
+                used_rows |= integral_pow_2(pivot);
+                batch.pivot_rows.push_back(pivot);
+
+                for (std::size_t i = 0; i < number_qubits; i++)
+                {
+                    if (!bit_set_at(used_rows, i) && bit_set_at(reduced_rows[i], k))
+                    {
+                        reduced_rows[i] ^= reduced_rows[pivot];
+                    }
+                }
+            }
+
+            std::ranges::sort(batch.pivot_rows);
+
+            std::vector<std::size_t> local_rows;
+
+            for (const std::size_t pivot : batch.pivot_rows)
+            {
+                local_rows.push_back((rows[pivot] & batch_mask) >> first_column);
+            }
+
+            const std::vector<std::size_t> inverse_rows = invert_local_matrix(local_rows);
+            std::vector<std::size_t> new_pivot_rows(batch_size, 0);
+
+            batch.local_columns.assign(batch_size, 0);
+
+            for (std::size_t j = 0; j < batch_size; j++)
+            {
+                for (std::size_t l = 0; l < batch_size; l++)
+                {
+                    batch.local_columns[l] |= std::size_t(bit_set_at(local_rows[j], l)) << j;
+
+                    if (bit_set_at(inverse_rows[j], l))
+                    {
+                        new_pivot_rows[j] ^= rows[batch.pivot_rows[l]];
+                    }
+                }
+            }
+
+            batch.clearing_columns.assign(number_qubits, 0);
+
+            for (std::size_t j = 0; j < batch_size; j++)
+            {
+                const std::size_t pivot = batch.pivot_rows[j];
+                rows[pivot] = new_pivot_rows[j];
+
+                for (std::size_t i = 0; i < number_qubits; i++)
+                {
+                    if (std::ranges::find(batch.pivot_rows, i) == batch.pivot_rows.end() && bit_set_at(rows[i], first_column + j))
+                    {
+                        batch.clearing_columns[pivot] |= integral_pow_2(i);
+                    }
+                }
+            }
+
+            for (std::size_t j = 0; j < batch_size; j++)
+            {
+                for (std::size_t rest = batch.clearing_columns[batch.pivot_rows[j]]; rest != 0; rest &= rest - 1)
+                {
+                    rows[std::countr_zero(rest)] ^= rows[batch.pivot_rows[j]];
+                }
+            }
+
+            batches.push_back(std::move(batch));
+        }
+
+        std::vector<std::size_t> permutation(number_qubits);
+
+        for (std::size_t i = 0; i < number_qubits; i++)
+        {
+            permutation[std::countr_zero(rows[i])] = i;
+        }
+
+        apply_qubit_permutation(state_vector, std::span<const std::size_t>(permutation));
+
+        for (auto batch = batches.rbegin(); batch != batches.rend(); batch++)
+        {
+            if (std::ranges::any_of(batch->clearing_columns, [](const std::size_t column) { return column != 0; }))
+            {
+                apply_involution(state_vector, std::span<const std::size_t>(batch->clearing_columns));
+            }
+
+            apply_local_map(state_vector, std::span<const std::size_t>(batch->pivot_rows), std::span<const std::size_t>(batch->local_columns));
+        }
+    }
+
+    template <std::floating_point Scalar>
+    void apply_shift_layer(std::span<std::complex<Scalar>> state_vector, const std::size_t shift)
+    {
+        if (shift == 0)
+        {
+            return;
+        }
+
+        if (shift >= state_vector.size())
+        {
+            throw std::invalid_argument("The shift must be an index of the state vector");
+        }
+
+        const std::size_t lowest_bit = std::countr_zero(shift);
+
+        parallel_ranges(state_vector.size() / 2, 2, [&](const std::size_t first, const std::size_t end)
+        {
+            for (std::size_t i = first; i < end; i++)
+            {
+                const std::size_t x = insert_zero_bits(i, std::span<const std::size_t>(&lowest_bit, 1));
+                std::swap(state_vector[x], state_vector[x ^ shift]);
+            }
+        });
+    }
+
+    template <std::floating_point Scalar>
+    void apply_hadamard_layer(std::span<std::complex<Scalar>> state_vector, const std::size_t number_low_qubits)
+    {
+        if (number_low_qubits == 0)
+        {
+            return;
+        }
+
+        if (state_vector.size() < integral_pow_2(number_low_qubits))
+        {
+            throw std::invalid_argument("The Hadamards must act on qubits of the state vector");
+        }
+
+        const auto transform = [](std::complex<Scalar> *amplitudes, const std::size_t size)
+        {
+            for (std::size_t step = 1; step < size; step <<= 1)
+            {
+                for (std::size_t pair_start = 0; pair_start < size; pair_start += 2 * step)
+                {
+                    for (std::size_t x = pair_start; x < pair_start + step; x++)
+                    {
+                        const std::complex<Scalar> a = amplitudes[x];
+                        const std::complex<Scalar> b = amplitudes[x + step];
+                        amplitudes[x] = a + b;
+                        amplitudes[x + step] = a - b;
+                    }
+                }
+            }
+        };
+
+        const std::size_t tile_bits = std::min(number_low_qubits, max_block_bits);
+        const std::size_t tile_size = integral_pow_2(tile_bits);
+
+        parallel_ranges(state_vector.size() / tile_size, tile_size, [&](const std::size_t first, const std::size_t end)
+        {
+            for (std::size_t tile = first; tile < end; tile++)
+            {
+                transform(state_vector.data() + tile * tile_size, tile_size);
+            }
+        });
+
+        for (std::size_t first_qubit = tile_bits; first_qubit < number_low_qubits; first_qubit += hadamard_group_qubits)
+        {
+            std::vector<std::size_t> qubits;
+
+            for (std::size_t qubit = first_qubit; qubit < std::min(first_qubit + hadamard_group_qubits, number_low_qubits); qubit++)
+            {
+                qubits.push_back(qubit);
+            }
+
+            transform_cosets(state_vector, std::span<const std::size_t>(qubits), [&](std::vector<std::complex<Scalar>> &buffer)
+            {
+                transform(buffer.data(), buffer.size());
+            });
+        }
+    }
+
+    template void apply_phase_layer<float>(std::span<std::complex<float>>, const Phase_Form &, const std::complex<float>);
+    template void apply_phase_layer<double>(std::span<std::complex<double>>, const Phase_Form &, const std::complex<double>);
+    template void apply_linear_layer<float>(std::span<std::complex<float>>, std::span<const std::size_t>);
+    template void apply_linear_layer<double>(std::span<std::complex<double>>, std::span<const std::size_t>);
+    template void apply_shift_layer<float>(std::span<std::complex<float>>, const std::size_t);
+    template void apply_shift_layer<double>(std::span<std::complex<double>>, const std::size_t);
+    template void apply_hadamard_layer<float>(std::span<std::complex<float>>, const std::size_t);
+    template void apply_hadamard_layer<double>(std::span<std::complex<double>>, const std::size_t);
+}
@@ -0,0 +1,38 @@
+#ifndef _FAST_STABILISER_STATE_VECTOR_LAYERS_H
+#define _FAST_STABILISER_STATE_VECTOR_LAYERS_H
+
+#include "stabiliser_state/phase_form.h"
+
+#include <complex>
+#include <concepts>
+#include <span>
+
+namespace fst
+{
+    /// In place kernels for the layers a Clifford is split into when applied to a state vector of length 2^n.
+    /// Each is one or a few passes over the vector, with the indices split between threads with parallel_for.
+
+    /// Multiplies the amplitude at each index x by scale * i^q(x), for a form in n variables. The vector is
+    /// walked in blocks of consecutive indices, with q on the low bits of a block read from a table
+    template <std::floating_point Scalar>
+    void apply_phase_layer(std::span<std::complex<Scalar>> state_vector, const Phase_Form &form, const std::complex<Scalar> scale);
+
+    /// Moves the amplitude at each index x to the index Mx, for the invertible matrix M over F_2 with columns
+    /// M e_j = columns[j]. Gauss-Jordan elimination on a batch of eight columns at a time writes M as a
+    /// permutation of the qubits (two involutions) and, per batch, a linear map on eight bits (a gather and
+    /// scatter of 256 amplitudes) and an involution x -> x + Nx, each one pass over the vector
+    template <std::floating_point Scalar>
+    void apply_linear_layer(std::span<std::complex<Scalar>> state_vector, std::span<const std::size_t> columns);
+
+    /// Moves the amplitude at each index x to the index x ^ shift
+    template <std::floating_point Scalar>
+    void apply_shift_layer(std::span<std::complex<Scalar>> state_vector, const std::size_t shift);
+
+    /// Applies sqrt(2)^number_low_qubits times a Hadamard to each of the qubits 0, ..., number_low_qubits - 1.
+    /// The low qubits of each tile of a few thousand amplitudes are done while it is in cache, and any higher
+    /// ones four at a time, on groups of 16 strided amplitudes
+    template <std::floating_point Scalar>
+    void apply_hadamard_layer(std::span<std::complex<Scalar>> state_vector, const std::size_t number_low_qubits);
+}
+
+#endif
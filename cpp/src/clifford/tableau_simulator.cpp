@@ -0,0 +1,546 @@
+#include "tableau_simulator.h"
+#include "util/f2_helper.h"
+#include "util/parallel.h"
+
+#include <algorithm>
+#include <bit>
+#include <numeric>
+#include <stdexcept>
+#include <utility>
+
+namespace
+{
+    using namespace fst;
+    using word_type = F2_Matrix::word_type;
+
+    /// Each thread runs the circuit on tiles of this many words of generators, which stay in cache
+    constexpr std::size_t words_per_tile = 8;
+
+    /// Each thread gets at least this many (gate, word) pairs, or (Clifford qubit pair, word) pairs
+    constexpr std::size_t minimum_word_operations_per_task = 1 << 16;
+
+    /// The number of qubits on which the Pauli is Y, mod 4
+    template <f2_vector_like Bits>
+    unsigned int number_ys(const Basic_Pauli<Bits> &pauli)
+    {
+        if constexpr (std::unsigned_integral<Bits>)
+        {
+            return std::popcount(pauli.x_vector & pauli.z_vector) % 4;
+        }
+        else
+        {
+            return (pauli.x_vector & pauli.z_vector).popcount() % 4;
+        }
+    }
+
+    /// Returns the exponent k in Z_4 with the Pauli i^k times the tensor product of I, X, Y and Z. As
+    /// Y = i XZ, this is the phase exponent less the number of Ys, and it is 0 or 2 exactly when the
+    /// Pauli is Hermitian
+    template <f2_vector_like Bits>
+    unsigned int get_tensor_phase_exponent(const Basic_Pauli<Bits> &pauli)
+    {
+        return (pauli.get_phase_exponent() + 4 - number_ys(pauli)) % 4;
+    }
+
+    /// A conjugate UX_jU* or UZ_jU* of a Clifford on k qubits, as i^phase_exponent times the tensor product
+    /// of the Paulis in support: bit 0 of each kind is the X part, and bit 1 the Z part, on local qubit first
+    struct Local_Pauli
+    {
+        unsigned int phase_exponent = 0;
+        std::vector<std::pair<std::size_t, unsigned int>> support;
+    };
+
+    template <f2_vector_like Bits>
+    Local_Pauli make_local_pauli(const Basic_Pauli<Bits> &pauli, const std::size_t number_qubits)
+    {
+        if (pauli.number_qubits != number_qubits || !pauli.is_hermitian())
+        {
+            throw std::invalid_argument("The conjugates of the Clifford must be Hermitian Paulis on the same number of qubits as it");
+        }
+
+        Local_Pauli local_pauli {get_tensor_phase_exponent(pauli), {}};
+        std::vector<unsigned int> kinds(number_qubits, 0);
+
+        for_each_set_bit(pauli.x_vector, [&](const std::size_t qubit) { kinds.at(qubit) |= 1; });
+        for_each_set_bit(pauli.z_vector, [&](const std::size_t qubit) { kinds.at(qubit) |= 2; });
+
+        for (std::size_t qubit = 0; qubit < number_qubits; qubit++)
+        {
+            if (kinds[qubit] != 0)
+            {
+                local_pauli.support.emplace_back(qubit, kinds[qubit]);
+            }
+        }
+
+        return local_pauli;
+    }
+
+    /// A product of Paulis on k qubits for each of 64 generators, bit-sliced: bit g of the words is generator g.
+    /// The phase i^e is kept as the bits of e mod 4 in low and high
+    struct Sliced_Product
+    {
+        std::vector<word_type> x_words;
+        std::vector<word_type> z_words;
+        word_type low = 0;
+        word_type high = 0;
+
+        explicit Sliced_Product(const std::size_t number_qubits)
+            : x_words(number_qubits), z_words(number_qubits)
+        {
+        }
+
+        void clear()
+        {
+            std::fill(x_words.begin(), x_words.end(), 0);
+            std::fill(z_words.begin(), z_words.end(), 0);
+            low = 0;
+            high = 0;
+        }
+
+        /// Adds 1 (or 2, or 3) to the exponent of the generators in mask
+        void add_one(const word_type mask)
+        {
+            high ^= low & mask;
+            low ^= mask;
+        }
+
+        void add_two(const word_type mask)
+        {
+            high ^= mask;
+        }
+
+        void add_three(const word_type mask)
+        {
+            high ^= ~low & mask;
+            low ^= mask;
+        }
+
+        /// Multiplies the product of the generators in mask on the right by the Pauli. For a single qubit,
+        /// AB = i^g (the Pauli of the sum of A and B), where g is +1 or -1 for distinct non-identity A and B,
+        /// as XY = iZ, YZ = iX, ZX = iY, and 0 otherwise
+        void multiply(const Local_Pauli &pauli, const word_type mask)
+        {
+            if (mask == 0)
+            {
+                return;
+            }
+
+            if (pauli.phase_exponent == 2)
+            {
+                add_two(mask);
+            }
+
+            for (const auto &[qubit, kind] : pauli.support)
+            {
+                const word_type a = x_words[qubit];
+                const word_type b = z_words[qubit];
+                word_type plus = 0;
+                word_type minus = 0;
+
+                switch (kind)
+                {
+                    case 1:
+                        plus = ~a & b;
+                        minus = a & b;
+                        break;
+                    case 2:
+                        plus = a & b;
+                        minus = a & ~b;
+                        break;
+                    default:
+                        plus = a & ~b;
+                        minus = ~a & b;
+                        break;
+                }
+
+                add_one(plus & mask);
+                add_three(minus & mask);
+
+                if (kind & 1)
+                {
+                    x_words[qubit] ^= mask;
+                }
+
+                if (kind & 2)
+                {
+                    z_words[qubit] ^= mask;
+                }
+            }
+        }
+    };
+}
+
+namespace fst
+{
+    template <f2_vector_like Bits>
+    Basic_Tableau_Simulator<Bits>::Basic_Tableau_Simulator(const Basic_Check_Matrix<Bits> &check_matrix)
+        : Basic_Tableau_Simulator(std::span<const Pauli_Type>(check_matrix.get_paulis()))
+    {
+    }
+
+    template <f2_vector_like Bits>
+    Basic_Tableau_Simulator<Bits>::Basic_Tableau_Simulator(std::span<const Pauli_Type> paulis)
+        : number_qubits(paulis.empty() ? 0 : paulis.front().number_qubits), number_generators(paulis.size()),
+          x_columns(number_qubits, number_generators), z_columns(number_qubits, number_generators), signs(x_columns.row_words(), 0)
+    {
+        for (std::size_t generator = 0; generator < number_generators; generator++)
+        {
+            const Pauli_Type &pauli = paulis[generator];
+
+            if (pauli.number_qubits != number_qubits || !pauli.is_hermitian())
+            {
+                throw std::invalid_argument("The generators must be Hermitian Paulis on the same number of qubits");
+            }
+
+            for_each_set_bit(pauli.x_vector, [&](const std::size_t qubit) { x_columns.flip(qubit, generator); });
+            for_each_set_bit(pauli.z_vector, [&](const std::size_t qubit) { z_columns.flip(qubit, generator); });
+
+            signs[generator / F2_Matrix::word_size] |= word_type(get_tensor_phase_exponent(pauli) >> 1) << (generator % F2_Matrix::word_size);
+        }
+    }
+
+    template <f2_vector_like Bits>
+    std::size_t Basic_Tableau_Simulator<Bits>::get_number_qubits() const
+    {
+        return number_qubits;
+    }
+
+    template <f2_vector_like Bits>
+    std::size_t Basic_Tableau_Simulator<Bits>::get_number_generators() const
+    {
+        return number_generators;
+    }
+
+    template <f2_vector_like Bits>
+    void Basic_Tableau_Simulator<Bits>::check_gate(const Gate &gate) const
+    {
+        const bool two_qubit = gate.type == Gate_Type::cx || gate.type == Gate_Type::cz || gate.type == Gate_Type::swap;
+
+        if (gate.first_qubit >= number_qubits || (two_qubit && gate.second_qubit >= number_qubits))
+        {
+            throw std::invalid_argument("The qubits of a gate must be less than the number of qubits");
+        }
+
+        if (two_qubit && gate.first_qubit == gate.second_qubit)
+        {
+            throw std::invalid_argument("The qubits of a two qubit gate must be different");
+        }
+    }
+
+    template <f2_vector_like Bits>
+    void Basic_Tableau_Simulator<Bits>::apply_to_words(const Gate &gate, const std::size_t first_word, const std::size_t end_word)
+    {
+        word_type *x_1 = x_columns.row(gate.first_qubit).data();
+        word_type *z_1 = z_columns.row(gate.first_qubit).data();
+        word_type *x_2 = x_columns.row(gate.second_qubit).data();
+        word_type *z_2 = z_columns.row(gate.second_qubit).data();
+
+        switch (gate.type)
+        {
+            case Gate_Type::h:
+                for (std::size_t w = first_word; w < end_word; w++)
+                {
+                    signs[w] ^= x_1[w] & z_1[w];
+                    std::swap(x_1[w], z_1[w]);
+                }
+                break;
+            case Gate_Type::s:
+                for (std::size_t w = first_word; w < end_word; w++)
+                {
+                    signs[w] ^= x_1[w] & z_1[w];
+                    z_1[w] ^= x_1[w];
+                }
+                break;
+            case Gate_Type::s_dagger:
+                for (std::size_t w = first_word; w < end_word; w++)
+                {
+                    signs[w] ^= x_1[w] & ~z_1[w];
+                    z_1[w] ^= x_1[w];
+                }
+                break;
+            case Gate_Type::x:
+                for (std::size_t w = first_word; w < end_word; w++)
+                {
+                    signs[w] ^= z_1[w];
+                }
+                break;
+            case Gate_Type::y:
+                for (std::size_t w = first_word; w < end_word; w++)
+                {
+                    signs[w] ^= x_1[w] ^ z_1[w];
+                }
+                break;
+            case Gate_Type::z:
+                for (std::size_t w = first_word; w < end_word; w++)
+                {
+                    signs[w] ^= x_1[w];
+                }
+                break;
+            case Gate_Type::cx:
+                for (std::size_t w = first_word; w < end_word; w++)
+                {
+                    signs[w] ^= x_1[w] & z_2[w] & ~(x_2[w] ^ z_1[w]);
+                    x_2[w] ^= x_1[w];
+                    z_1[w] ^= z_2[w];
+                }
+                break;
+            case Gate_Type::cz:
+                for (std::size_t w = first_word; w < end_word; w++)
+                {
+                    signs[w] ^= x_1[w] & x_2[w] & (z_1[w] ^ z_2[w]);
+                    z_1[w] ^= x_2[w];
+                    z_2[w] ^= x_1[w];
+                }
+                break;
+            case Gate_Type::swap:
+                std::swap_ranges(x_1 + first_word, x_1 + end_word, x_2 + first_word);
+                std::swap_ranges(z_1 + first_word, z_1 + end_word, z_2 + first_word);
+                break;
+        }
+    }
+
+    template <f2_vector_like Bits>
+    void Basic_Tableau_Simulator<Bits>::h(const std::size_t qubit)
+    {
+        apply_gate({Gate_Type::h, qubit, 0});
+    }
+
+    template <f2_vector_like Bits>
+    void Basic_Tableau_Simulator<Bits>::s(const std::size_t qubit)
+    {
+        apply_gate({Gate_Type::s, qubit, 0});
+    }
+
+    template <f2_vector_like Bits>
+    void Basic_Tableau_Simulator<Bits>::s_dagger(const std::size_t qubit)
+    {
+        apply_gate({Gate_Type::s_dagger, qubit, 0});
+    }
+
+    template <f2_vector_like Bits>
+    void Basic_Tableau_Simulator<Bits>::x(const std::size_t qubit)
+    {
+        apply_gate({Gate_Type::x, qubit, 0});
+    }
+
+    template <f2_vector_like Bits>
+    void Basic_Tableau_Simulator<Bits>::y(const std::size_t qubit)
+    {
+        apply_gate({Gate_Type::y, qubit, 0});
+    }
+
+    template <f2_vector_like Bits>
+    void Basic_Tableau_Simulator<Bits>::z(const std::size_t qubit)
+    {
+        apply_gate({Gate_Type::z, qubit, 0});
+    }
+
+    template <f2_vector_like Bits>
+    void Basic_Tableau_Simulator<Bits>::cx(const std::size_t control, const std::size_t target)
+    {
+        apply_gate({Gate_Type::cx, control, target});
+    }
+
+    template <f2_vector_like Bits>
+    void Basic_Tableau_Simulator<Bits>::cz(const std::size_t first_qubit, const std::size_t second_qubit)
+    {
+        apply_gate({Gate_Type::cz, first_qubit, second_qubit});
+    }
+
+    template <f2_vector_like Bits>
+    void Basic_Tableau_Simulator<Bits>::swap(const std::size_t first_qubit, const std::size_t second_qubit)
+    {
+        apply_gate({Gate_Type::swap, first_qubit, second_qubit});
+    }
+
+    template <f2_vector_like Bits>
+    void Basic_Tableau_Simulator<Bits>::apply_gate(const Gate &gate)
+    {
+        check_gate(gate);
+        apply_to_words(gate, 0, signs.size());
+    }
+
+    template <f2_vector_like Bits>
+    void Basic_Tableau_Simulator<Bits>::apply_gates(std::span<const Gate> gates)
+    {
+        for (const Gate &gate : gates)
+        {
+            check_gate(gate);
+        }
+
+        const std::size_t number_words = signs.size();
+        const std::size_t number_tiles = (number_words + words_per_tile - 1) / words_per_tile;
+        const std::size_t number_tasks = std::min({get_number_threads(), number_tiles, std::max<std::size_t>(1, gates.size() * number_words / minimum_word_operations_per_task)});
+
+        if (number_tiles == 0)
+        {
+            return;
+        }
+
+        parallel_for(number_tasks, [&](const std::size_t task)
+        {
+            for (std::size_t tile = task; tile < number_tiles; tile += number_tasks)
+            {
+                const std::size_t first_word = tile * words_per_tile;
+                const std::size_t end_word = std::min(number_words, first_word + words_per_tile);
+
+                for (const Gate &gate : gates)
+                {
+                    apply_to_words(gate, first_word, end_word);
+                }
+            }
+        });
+    }
+
+    template <f2_vector_like Bits>
+    void Basic_Tableau_Simulator<Bits>::apply_clifford(const Basic_Clifford<Bits> &clifford)
+    {
+        std::vector<std::size_t> qubits(number_qubits);
+        std::iota(qubits.begin(), qubits.end(), 0);
+
+        apply_clifford(clifford, qubits);
+    }
+
+    template <f2_vector_like Bits>
+    void Basic_Tableau_Simulator<Bits>::apply_clifford(const Basic_Clifford<Bits> &clifford, std::span<const std::size_t> qubits)
+    {
+        const std::size_t number_clifford_qubits = qubits.size();
+
+        if (clifford.number_qubits != number_clifford_qubits || clifford.z_conjugates.size() != number_clifford_qubits || clifford.x_conjugates.size() != number_clifford_qubits)
+        {
+            throw std::invalid_argument("The Clifford must act on the given number of qubits");
+        }
+
+        std::vector<bool> used(number_qubits, false);
+
+        for (const std::size_t qubit : qubits)
+        {
+            if (qubit >= number_qubits || used[qubit])
+            {
+                throw std::invalid_argument("The qubits of the Clifford must be different, and less than the number of qubits");
+            }
+
+            used[qubit] = true;
+        }
+
+        std::vector<Local_Pauli> x_images;
+        std::vector<Local_Pauli> z_images;
+
+        for (std::size_t j = 0; j < number_clifford_qubits; j++)
+        {
+            x_images.push_back(make_local_pauli(clifford.x_conjugates[j], number_clifford_qubits));
+            z_images.push_back(make_local_pauli(clifford.z_conjugates[j], number_clifford_qubits));
+        }
+
+        const std::size_t number_words = signs.size();
+        const std::size_t word_operations = number_words * std::max<std::size_t>(1, number_clifford_qubits * number_clifford_qubits);
+        const std::size_t number_tasks = std::min({get_number_threads(), number_words, std::max<std::size_t>(1, word_operations / minimum_word_operations_per_task)});
+
+        if (number_words == 0)
+        {
+            return;
+        }
+
+        parallel_for(number_tasks, [&](const std::size_t task)
+        {
+            Sliced_Product product(number_clifford_qubits);
+
+            for (std::size_t w = task * number_words / number_tasks; w < (task + 1) * number_words / number_tasks; w++)
+            {
+                product.clear();
+
+                // Each generator is (-1)^sign times the product over the qubits of X^x Z^z, times i for each Y,
+                // so UPU* is the same product of the conjugates
+                for (std::size_t j = 0; j < number_clifford_qubits; j++)
+                {
+                    const word_type x_word = x_columns.row(qubits[j])[w];
+                    const word_type z_word = z_columns.row(qubits[j])[w];
+
+                    product.add_one(x_word & z_word);
+                    product.multiply(x_images[j], x_word);
+                    product.multiply(z_images[j], z_word);
+                }
+
+                // The conjugate of a Hermitian Pauli is Hermitian, so product.low is zero
+                signs[w] ^= product.high;
+
+                for (std::size_t j = 0; j < number_clifford_qubits; j++)
+                {
+                    x_columns.row(qubits[j])[w] = product.x_words[j];
+                    z_columns.row(qubits[j])[w] = product.z_words[j];
+                }
+            }
+        });
+    }
+
+    template <f2_vector_like Bits>
+    std::vector<Basic_Pauli<Bits>> Basic_Tableau_Simulator<Bits>::get_paulis() const
+    {
+        std::vector<Pauli_Type> paulis;
+        paulis.reserve(number_generators);
+
+        for (std::size_t generator = 0; generator < number_generators; generator++)
+        {
+            Bits x_vector = zero_vector<Bits>(number_qubits);
+            Bits z_vector = zero_vector<Bits>(number_qubits);
+            unsigned int ys = 0;
+
+            for (std::size_t qubit = 0; qubit < number_qubits; qubit++)
+            {
+                const bool x_bit = x_columns.get(qubit, generator);
+                const bool z_bit = z_columns.get(qubit, generator);
+
+                if (x_bit)
+                {
+                    set_bit(x_vector, qubit);
+                }
+
+                if (z_bit)
+                {
+                    set_bit(z_vector, qubit);
+                }
+
+                ys += x_bit && z_bit;
+            }
+
+            // The phase exponent 2 * sign_bit + 3 * imag_bit is 2 * sign + (the number of Ys)
+            const bool sign = bit_set_at(signs[generator / F2_Matrix::word_size], generator % F2_Matrix::word_size);
+            const unsigned int phase_exponent = (2 * sign + ys) % 4;
+            const unsigned int imag_bit = phase_exponent & 1;
+
+            paulis.emplace_back(number_qubits, x_vector, z_vector, ((phase_exponent + 4 - 3 * imag_bit) % 4) / 2, imag_bit);
+        }
+
+        return paulis;
+    }
+
+    template <f2_vector_like Bits>
+    void Basic_Tableau_Simulator<Bits>::write_to(Basic_Check_Matrix<Bits> &check_matrix) const
+    {
+        check_matrix.set_paulis(get_paulis());
+    }
+
+    template <f2_vector_like Bits>
+    void apply_gates(Basic_Check_Matrix<Bits> &check_matrix, std::span<const Gate> gates)
+    {
+        Basic_Tableau_Simulator<Bits> simulator(check_matrix);
+        simulator.apply_gates(gates);
+        simulator.write_to(check_matrix);
+    }
+
+    template <f2_vector_like Bits>
+    void apply_clifford(Basic_Check_Matrix<Bits> &check_matrix, const Basic_Clifford<Bits> &clifford)
+    {
+        Basic_Tableau_Simulator<Bits> simulator(check_matrix);
+        simulator.apply_clifford(clifford);
+        simulator.write_to(check_matrix);
+    }
+
+    template class Basic_Tableau_Simulator<std::size_t>;
+    template class Basic_Tableau_Simulator<F2_Vector>;
+
+    template void apply_gates(Basic_Check_Matrix<std::size_t> &, std::span<const Gate>);
+    template void apply_gates(Basic_Check_Matrix<F2_Vector> &, std::span<const Gate>);
+    template void apply_clifford(Basic_Check_Matrix<std::size_t> &, const Basic_Clifford<std::size_t> &);
+    template void apply_clifford(Basic_Check_Matrix<F2_Vector> &, const Basic_Clifford<F2_Vector> &);
+}
@@ -0,0 +1,122 @@
+#ifndef _FAST_STABILISER_TABLEAU_SIMULATOR_H
+#define _FAST_STABILISER_TABLEAU_SIMULATOR_H
+
+#include "clifford.h"
+#include "pauli/pauli.h"
+#include "stabiliser_state/check_matrix.h"
+#include "util/f2_matrix.h"
+
+#include <span>
+#include <vector>
+
+namespace fst
+{
+    /// The gates that Basic_Tableau_Simulator applies directly
+    enum class Gate_Type
+    {
+        h,
+        s,
+        s_dagger,
+        x,
+        y,
+        z,
+        cx,
+        cz,
+        swap
+    };
+
+    /// A gate of a circuit. Single qubit gates act on first_qubit. For cx, first_qubit is the control and
+    /// second_qubit the target; cz and swap are symmetric in the two
+    struct Gate
+    {
+        Gate_Type type = Gate_Type::h;
+        std::size_t first_qubit = 0;
+        std::size_t second_qubit = 0;
+
+        bool operator==(const Gate &other) const = default;
+    };
+
+    /// Evolves the stabiliser group of a check matrix under Clifford gates, conjugating each generator P to
+    /// UPU*.
+    ///
+    /// The generators are stored column-sliced: for each qubit, one row of bits over the generators for the
+    /// X parts and one for the Z parts, plus one row of signs, so a gate on one or two qubits touches only
+    /// O(number of generators / 64) words. The signs are stored as in Aaronson & Gottesman, with the
+    /// generator (-1)^sign times the tensor product of I, X, Y and Z, rather than as the sign_bit and
+    /// imag_bit of Basic_Pauli.
+    ///
+    /// As for Basic_Pauli, Bits is std::size_t (the Tableau_Simulator alias, up to 64 qubits) or
+    /// F2_Vector (the Wide_Tableau_Simulator alias, any number of qubits).
+    template <f2_vector_like Bits>
+    class Basic_Tableau_Simulator
+    {
+        public:
+        using Pauli_Type = Basic_Pauli<Bits>;
+        using word_type = F2_Matrix::word_type;
+
+        /// Throws std::invalid_argument if a generator is not Hermitian or has a different number of qubits
+        explicit Basic_Tableau_Simulator(const Basic_Check_Matrix<Bits> &check_matrix);
+        explicit Basic_Tableau_Simulator(std::span<const Pauli_Type> paulis);
+
+        std::size_t get_number_qubits() const;
+        std::size_t get_number_generators() const;
+
+        /// Apply a single gate. Each throws std::invalid_argument if a qubit is out of range, or the two
+        /// qubits of a two qubit gate are the same
+        void h(const std::size_t qubit);
+        void s(const std::size_t qubit);
+        void s_dagger(const std::size_t qubit);
+        void x(const std::size_t qubit);
+        void y(const std::size_t qubit);
+        void z(const std::size_t qubit);
+        void cx(const std::size_t control, const std::size_t target);
+        void cz(const std::size_t first_qubit, const std::size_t second_qubit);
+        void swap(const std::size_t first_qubit, const std::size_t second_qubit);
+
+        void apply_gate(const Gate &gate);
+
+        /// Applies the gates in order. Every gate is checked before any is applied, and the generators are
+        /// split into tiles of a few words, each run through the whole circuit while it is in cache, with the
+        /// tiles split between threads
+        void apply_gates(std::span<const Gate> gates);
+
+        /// Applies a Clifford on the given qubits (in order), or on all the qubits. Each generator becomes the
+        /// product of the conjugates of its X and Z parts, with the phases of the products tracked bit-sliced
+        /// across 64 generators at once, so this takes O(k^2) word operations per 64 generators for a Clifford
+        /// on k qubits. The global phase of the Clifford does not change the stabiliser group. Throws
+        /// std::invalid_argument if the Clifford is not on qubits.size() qubits or the qubits are invalid
+        void apply_clifford(const Basic_Clifford<Bits> &clifford);
+        void apply_clifford(const Basic_Clifford<Bits> &clifford, std::span<const std::size_t> qubits);
+
+        /// Returns the generators, in the order they were given
+        std::vector<Pauli_Type> get_paulis() const;
+
+        /// Sets the Paulis of the check matrix to the generators
+        void write_to(Basic_Check_Matrix<Bits> &check_matrix) const;
+
+        private:
+        std::size_t number_qubits = 0;
+        std::size_t number_generators = 0;
+
+        /// Row q holds the X (or Z) bits on qubit q of each of the generators
+        F2_Matrix x_columns;
+        F2_Matrix z_columns;
+        std::vector<word_type> signs;
+
+        void check_gate(const Gate &gate) const;
+        void apply_to_words(const Gate &gate, const std::size_t first_word, const std::size_t end_word);
+    };
+
+    using Tableau_Simulator = Basic_Tableau_Simulator<std::size_t>;
+    using Wide_Tableau_Simulator = Basic_Tableau_Simulator<F2_Vector>;
+
+    /// Applies the gates, or the Clifford, to the stabiliser group of the check matrix in place, with one
+    /// Basic_Tableau_Simulator. The check matrix is no longer row reduced
+    template <f2_vector_like Bits>
+    void apply_gates(Basic_Check_Matrix<Bits> &check_matrix, std::span<const Gate> gates);
+
+    template <f2_vector_like Bits>
+    void apply_clifford(Basic_Check_Matrix<Bits> &check_matrix, const Basic_Clifford<Bits> &clifford);
+}
+
+#endif
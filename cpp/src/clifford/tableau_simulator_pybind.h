@@ -0,0 +1,82 @@
+#ifndef _FAST_STABILISER_TABLEAU_SIMULATOR_PYBIND_H
+#define _FAST_STABILISER_TABLEAU_SIMULATOR_PYBIND_H
+
+#include <pybind11/pybind11.h>
+#include <pybind11/complex.h>
+#include <pybind11/stl.h>
+
+#include "tableau_simulator.h"
+
+#include <optional>
+
+namespace py = pybind11;
+using namespace fst;
+
+namespace fst_pybind
+{
+    void init_tableau_simulator(py::module_ &m)
+    {
+        py::enum_<Gate_Type>(m, "Gate_Type", "The gates that Tableau_Simulator applies directly")
+            .value("h", Gate_Type::h)
+            .value("s", Gate_Type::s)
+            .value("s_dagger", Gate_Type::s_dagger)
+            .value("x", Gate_Type::x)
+            .value("y", Gate_Type::y)
+            .value("z", Gate_Type::z)
+            .value("cx", Gate_Type::cx)
+            .value("cz", Gate_Type::cz)
+            .value("swap", Gate_Type::swap);
+
+        py::class_<Gate>(m, "Gate")
+            .def_readwrite("type", &Gate::type, "Gate_Type")
+            .def_readwrite("first_qubit", &Gate::first_qubit, "int\t\tThe qubit of a single qubit gate, or the control of cx")
+            .def_readwrite("second_qubit", &Gate::second_qubit, "int\t\tThe other qubit of a two qubit gate (the target of cx)")
+            .def(py::init<const Gate_Type, const std::size_t, const std::size_t>(), py::arg("type"), py::arg("first_qubit"), py::arg("second_qubit") = 0)
+            .def("__eq__", &Gate::operator==)
+            .doc() = "A gate of a circuit, for Tableau_Simulator";
+
+        py::class_<Tableau_Simulator>(m, "Tableau_Simulator")
+            .def(py::init<const Check_Matrix &>(), py::arg("check_matrix"))
+            .def(py::init([](const std::vector<Pauli> &paulis) { return Tableau_Simulator(paulis); }), py::arg("paulis"))
+            .def("get_number_qubits", &Tableau_Simulator::get_number_qubits)
+            .def("get_number_generators", &Tableau_Simulator::get_number_generators)
+            .def("h", &Tableau_Simulator::h, py::arg("qubit"))
+            .def("s", &Tableau_Simulator::s, py::arg("qubit"))
+            .def("s_dagger", &Tableau_Simulator::s_dagger, py::arg("qubit"))
+            .def("x", &Tableau_Simulator::x, py::arg("qubit"))
+            .def("y", &Tableau_Simulator::y, py::arg("qubit"))
+            .def("z", &Tableau_Simulator::z, py::arg("qubit"))
+            .def("cx", &Tableau_Simulator::cx, py::arg("control"), py::arg("target"))
+            .def("cz", &Tableau_Simulator::cz, py::arg("first_qubit"), py::arg("second_qubit"))
+            .def("swap", &Tableau_Simulator::swap, py::arg("first_qubit"), py::arg("second_qubit"))
+            .def("apply_gate", &Tableau_Simulator::apply_gate, py::arg("gate"))
+            .def("apply_gates", [](Tableau_Simulator &simulator, const std::vector<Gate> &gates)
+            {
+                py::gil_scoped_release release;
+                simulator.apply_gates(gates);
+            }, py::arg("gates"), "Applies a list of Gates in order. Every gate is checked before any is applied (raising ValueError for invalid qubits), and the generators are split between threads")
+            .def("apply_clifford", [](Tableau_Simulator &simulator, const Clifford &clifford, const std::optional<std::vector<std::size_t>> &qubits)
+            {
+                if (qubits)
+                {
+                    simulator.apply_clifford(clifford, *qubits);
+                }
+                else
+                {
+                    simulator.apply_clifford(clifford);
+                }
+            }, py::arg("clifford"), py::arg("qubits") = py::none(), "Applies a Clifford to the given list of qubits (in order), or to all the qubits if qubits is None, in polynomial time")
+            .def("get_paulis", &Tableau_Simulator::get_paulis, "Returns the list[Pauli] of generators, in the order they were given")
+            .def("write_to", &Tableau_Simulator::write_to, py::arg("check_matrix"), "Sets the Paulis of the check matrix to the generators")
+            .doc() = "Evolves the stabiliser group of a check matrix under Clifford gates, with the generators stored column-sliced so that each gate touches O(n / 64) words";
+
+        m.def("apply_gates", [](Check_Matrix &check_matrix, const std::vector<Gate> &gates)
+        {
+            py::gil_scoped_release release;
+            apply_gates(check_matrix, std::span<const Gate>(gates));
+        }, py::arg("check_matrix"), py::arg("gates"), "Applies a list of Gates to the state of the check matrix in place, with one Tableau_Simulator");
+        m.def("apply_clifford", py::overload_cast<Check_Matrix &, const Clifford &>(&apply_clifford<std::size_t>), py::arg("check_matrix"), py::arg("clifford"), "Applies a Clifford on all the qubits to the state of the check matrix in place, without building its matrix");
+    }
+}
+
+#endif
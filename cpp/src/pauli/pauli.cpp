@@ -1,33 +1,80 @@
 #include "pauli.h"
 #include "util/f2_helper.h"
+#include "util/f2_vector.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace
+{
+    using namespace fst;
+
+    template <std::unsigned_integral Bits, std::floating_point Scalar>
+    bool is_eigenstate(const Basic_Pauli<Bits> &pauli, std::span<const std::complex<Scalar>> vector, const unsigned int eig_sign)
+    {
+        if (integral_pow_2(pauli.number_qubits) != vector.size())
+        {
+            throw std::invalid_argument("Invalid vector dimension");
+        }
+
+        const std::size_t size = integral_pow_2(pauli.number_qubits);
+        const unsigned int vector_phase_exponent = pauli.get_phase_exponent() + 2 * eig_sign;
+
+        for (size_t index = 0; index < size; index++)
+        {
+            // (-1)^(eig_sign) * phase * (-1)^(index.z_vector) * vector[index], exactly
+            const std::complex<Scalar> expected_phase = scaled_powers_of_i(vector[index])[(vector_phase_exponent + 2 * f2_dot_product(index, pauli.z_vector)) % 4];
+
+            if (vector[index ^ pauli.x_vector] != expected_phase)
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+}
 
 namespace fst
 {
-    Pauli::Pauli(const std::size_t number_qubits, const std::size_t x_vector, const std::size_t z_vector, const bool sign_bit, const bool imag_bit)
+    template <f2_vector_like Bits>
+    Basic_Pauli<Bits>::Basic_Pauli(const std::size_t number_qubits, const Bits x_vector, const Bits z_vector, const bool sign_bit, const bool imag_bit)
         : number_qubits(number_qubits), x_vector(x_vector), z_vector(z_vector), sign_bit(sign_bit), imag_bit(imag_bit)
     {}
 
-    std::complex<float> Pauli::get_phase() const
+    template <f2_vector_like Bits>
+    std::complex<float> Basic_Pauli<Bits>::get_phase() const
     {
-        return {f_min1_pow(sign_bit) * float_not(imag_bit), -f_min1_pow(sign_bit) * static_cast<float>(imag_bit)};
+        return powers_of_i[get_phase_exponent()];
     }
 
-    bool Pauli::is_hermitian() const
+    template <f2_vector_like Bits>
+    unsigned int Basic_Pauli<Bits>::get_phase_exponent() const
+    {
+        return (2 * sign_bit + 3 * imag_bit) % 4;
+    }
+
+    template <f2_vector_like Bits>
+    bool Basic_Pauli<Bits>::is_hermitian() const
     {
         return imag_bit == f2_dot_product(x_vector, z_vector);
     }
 
-    bool Pauli::anticommutes_with(const Pauli &other_pauli) const
+    template <f2_vector_like Bits>
+    bool Basic_Pauli<Bits>::anticommutes_with(const Basic_Pauli &other_pauli) const
     {
         return f2_dot_product(x_vector, other_pauli.z_vector) ^ f2_dot_product(z_vector, other_pauli.x_vector);
     }
 
-    bool Pauli::commutes_with(const Pauli &other_pauli) const
+    template <f2_vector_like Bits>
+    bool Basic_Pauli<Bits>::commutes_with(const Basic_Pauli &other_pauli) const
     {
         return !anticommutes_with(other_pauli);
     }
 
-    std::vector<std::vector<std::complex<float>>> Pauli::get_matrix() const
+    template <f2_vector_like Bits>
+    std::vector<std::vector<std::complex<float>>> Basic_Pauli<Bits>::get_matrix() const
+        requires std::unsigned_integral<Bits>
     {
         const std::size_t size = integral_pow_2(number_qubits);
         std::vector<std::vector<std::complex<float>>> matrix(size, std::vector<std::complex<float>>(size, 0));
@@ -43,26 +90,76 @@ namespace fst
         return matrix;
     }
 
-    std::vector<std::complex<float>> Pauli::multiply_vector(const std::vector<std::complex<float>> &vector) const
+    template <f2_vector_like Bits>
+    void Basic_Pauli<Bits>::get_matrix(std::span<std::complex<float>> matrix) const
+        requires std::unsigned_integral<Bits>
+    {
+        const std::size_t size = integral_pow_2(number_qubits);
+
+        if (matrix.size() != size * size)
+        {
+            throw std::invalid_argument("The output for the matrix must have length 2^number_qubits * 2^number_qubits");
+        }
+
+        std::fill(matrix.begin(), matrix.end(), std::complex<float>{0, 0});
+
+        std::complex<float> phase = get_phase();
+
+        for (size_t col_index = 0; col_index < size; col_index++)
+        {
+            matrix[(col_index ^ x_vector) * size + col_index] =
+                phase * sign_f2_dot_product(col_index, z_vector);
+        }
+    }
+
+    template <f2_vector_like Bits>
+    std::vector<std::complex<float>> Basic_Pauli<Bits>::multiply_vector(const std::vector<std::complex<float>> &vector) const
+        requires std::unsigned_integral<Bits>
     {
         if (integral_pow_2(number_qubits) != vector.size())
         {
             throw std::invalid_argument("Invalid vector dimension for pauli-vector multiplication");
         }
         
+        std::vector<std::complex<float>> result(vector.size());
+        multiply_vector(vector, result);
+
+        return result;
+    }
+
+    template <f2_vector_like Bits>
+    void Basic_Pauli<Bits>::multiply_vector(std::span<const std::complex<float>> vector, std::span<std::complex<float>> result) const
+        requires std::unsigned_integral<Bits>
+    {
+        if (integral_pow_2(number_qubits) != vector.size() || vector.size() != result.size())
+        {
+            throw std::invalid_argument("Invalid vector dimension for pauli-vector multiplication");
+        }
+
         const size_t size = vector.size();
-        std::vector<std::complex<float>> result(size, 0);
         std::complex<float> phase = get_phase();
 
+        // Entries index and index ^ x_vector swap, so handle each pair together (reading both before
+        // writing either) so that the result can be the vector itself
         for (size_t index = 0; index < size; index++)
         {
-            result[index ^ x_vector] = phase * sign_f2_dot_product(index, z_vector) * vector[index];
-        }
+            const size_t partner = index ^ x_vector;
 
-        return result;
+            if (partner < index)
+            {
+                continue;
+            }
+
+            const std::complex<float> entry = vector[index];
+            const std::complex<float> partner_entry = vector[partner];
+
+            result[partner] = phase * sign_f2_dot_product(index, z_vector) * entry;
+            result[index] = phase * sign_f2_dot_product(partner, z_vector) * partner_entry;
+        }
     }
 
-    void Pauli::multiply_by_pauli_on_right(const Pauli &other_pauli)
+    template <f2_vector_like Bits>
+    void Basic_Pauli<Bits>::multiply_by_pauli_on_right(const Basic_Pauli &other_pauli)
     {
         if (number_qubits != other_pauli.number_qubits)
         {
@@ -77,27 +174,20 @@ namespace fst
         z_vector ^= other_pauli.z_vector;
     }
 
-    bool Pauli::has_eigenstate(const std::vector<std::complex<float>> &vector, const unsigned int eig_sign) const
+    template <f2_vector_like Bits>
+    bool Basic_Pauli<Bits>::has_eigenstate(std::span<const std::complex<float>> vector, const unsigned int eig_sign) const
+        requires std::unsigned_integral<Bits>
     {
-        if (integral_pow_2(number_qubits) != vector.size())
-        {
-            throw std::invalid_argument("Invalid vector dimension");
-        }
-        
-        std::complex<float> phase = get_phase();
-
-        const std::size_t size = integral_pow_2(number_qubits);
-        const std::complex<float> vector_phase = f_min1_pow(eig_sign) * phase;
-
-        for (size_t index = 0; index < size; index++)
-        {
-            std::complex<float> expected_phase = vector_phase * sign_f2_dot_product(index, z_vector) * vector[index];
-            if (vector[index ^ x_vector] != expected_phase)
-            {
-                return false;
-            }
-        }
+        return is_eigenstate(*this, vector, eig_sign);
+    }
 
-        return true;
+    template <f2_vector_like Bits>
+    bool Basic_Pauli<Bits>::has_eigenstate(std::span<const std::complex<double>> vector, const unsigned int eig_sign) const
+        requires std::unsigned_integral<Bits>
+    {
+        return is_eigenstate(*this, vector, eig_sign);
     }
+
+    template struct Basic_Pauli<std::size_t>;
+    template struct Basic_Pauli<F2_Vector>;
 }
\ No newline at end of file
@@ -1,7 +1,10 @@
 #ifndef _FAST_STABILISER_PAULI_H
 #define _FAST_STABILISER_PAULI_H
 
+#include "util/f2_vector.h"
+
 #include <complex>
+#include <span>
 #include <vector>
 
 //TODO: make sign_bit and imag_bit bools for memory efficiency. Update f2_dot_product etc. to also return bools
@@ -10,47 +13,84 @@ namespace fst
     /// The class used to represent a Pauli operator.
     /// Puali is (-1)^(sign_bit) * (-i)^(imag_bit) * X^(x_vector) * Z^(z_vector)
     /// The phase of the Pauli is (-1)^(sign_bit) * (-i)^(imag_bit)
-    struct Pauli
+    ///
+    /// Bits is the type used to store x_vector and z_vector: a single std::size_t for up to 64
+    /// qubits (the Pauli alias), or an F2_Vector for any number of qubits (the Wide_Pauli alias).
+    /// The methods working with state vectors and matrices are only available for the former.
+    template <f2_vector_like Bits>
+    struct Basic_Pauli
     {
         std::size_t number_qubits = 0;
-        std::size_t x_vector = 0;
-        std::size_t z_vector = 0;
+        Bits x_vector{};
+        Bits z_vector{};
 
         unsigned int sign_bit = 0;
         unsigned int imag_bit = 0;
 
         public:
-        Pauli() = default;
-        Pauli(const std::size_t number_qubits, const std::size_t x_vector, const std::size_t z_vector, const bool sign_bit, const bool imag_bit);
+        Basic_Pauli() = default;
+        Basic_Pauli(const std::size_t number_qubits, const Bits x_vector, const Bits z_vector, const bool sign_bit, const bool imag_bit);
 
         /// Returns whether the pauli operator is Hermitian
         bool is_hermitian() const;
 
         /// Given another Paulis, used to check whether it commutes/anticommutes
         /// with this Pauli
-        bool commutes_with(const Pauli &other_pauli) const;
-        bool anticommutes_with(const Pauli &other_pauli) const;
+        bool commutes_with(const Basic_Pauli &other_pauli) const;
+        bool anticommutes_with(const Basic_Pauli &other_pauli) const;
 
         /// Given a statevector x on the same number of qubits as the Pauli P, check
         /// whether or not Px = (-1)^(eig_sign) x, i.e. whether x is an eigenstate of P
         /// with eigenvalue (-1)^(eig_sign).
-        bool has_eigenstate(const std::vector<std::complex<float>> &vector, const unsigned int eign_sign) const;
+        bool has_eigenstate(std::span<const std::complex<float>> vector, const unsigned int eign_sign) const
+            requires std::unsigned_integral<Bits>;
+        bool has_eigenstate(std::span<const std::complex<double>> vector, const unsigned int eign_sign) const
+            requires std::unsigned_integral<Bits>;
 
         /// Returns the matrix of the Pauli (with respect to the computational basis)
-        std::vector<std::vector<std::complex<float>>> get_matrix() const;
+        std::vector<std::vector<std::complex<float>>> get_matrix() const
+            requires std::unsigned_integral<Bits>;
+
+        /// Writes the matrix of the Pauli in row-major order into matrix, which must have length 2^n * 2^n.
+        /// Throws std::invalid_argument if the length is wrong
+        void get_matrix(std::span<std::complex<float>> matrix) const
+            requires std::unsigned_integral<Bits>;
 
         /// Given a vector x on the same number of qubits as the Pauli P, return Px
-        std::vector<std::complex<float>> multiply_vector(const std::vector<std::complex<float>> &vector) const;
+        std::vector<std::complex<float>> multiply_vector(const std::vector<std::complex<float>> &vector) const
+            requires std::unsigned_integral<Bits>;
+
+        /// Given a vector x on the same number of qubits as the Pauli P, writes Px into result. The result
+        /// may be the same buffer as the vector (multiplying in place), but must not otherwise overlap it.
+        /// Throws std::invalid_argument if either length is not 2^n
+        void multiply_vector(std::span<const std::complex<float>> vector, std::span<std::complex<float>> result) const
+            requires std::unsigned_integral<Bits>;
 
         /// Given another pauli Q, multiply this Pauli on the right by Q
         /// Note, the current instance is set to the result.
-        void multiply_by_pauli_on_right(const Pauli &other_pauli);
+        void multiply_by_pauli_on_right(const Basic_Pauli &other_pauli);
 
         /// Gets the current phase of the pauli: (-1)^(sign_bit) * (-i)^(imag_bit)
         std::complex<float> get_phase() const;
 
-        bool operator==(const Pauli &other) const = default;
+        /// Gets the exponent k in Z_4 with get_phase() = i^k, i.e. 2 * sign_bit + 3 * imag_bit (mod 4)
+        unsigned int get_phase_exponent() const;
+
+        bool operator==(const Basic_Pauli &other) const = default;
     };
+
+    /// The result of measuring a Hermitian Pauli P on a stabiliser state, which is left in the (-1)^outcome
+    /// eigenspace of P. The outcome is deterministic when +P or -P was already in the stabiliser group
+    struct Measurement_Result
+    {
+        bool outcome = false;
+        bool deterministic = false;
+
+        bool operator==(const Measurement_Result &other) const = default;
+    };
+
+    using Pauli = Basic_Pauli<std::size_t>;
+    using Wide_Pauli = Basic_Pauli<F2_Vector>;
 }
 
-#endif
\ No newline at end of file
+#endif
@@ -6,16 +6,23 @@
 #include <pybind11/stl.h>
 
 #include "pauli.h"
+#include "util/f2_vector_pybind.h"
+#include "util/numpy_pybind.h"
 
 namespace py = pybind11;
 using namespace fst;
 
 // TODO: Export the operator ==
-// TODO: Return numpy arrays rather than arrays. Eliminate copying by making types opaque?
 namespace fst_pybind
 {
     void init_pauli(py::module_ &m)
     {
+        py::class_<Measurement_Result>(m, "Measurement_Result")
+            .def_readonly("outcome", &Measurement_Result::outcome, "bool\t\tThe state is left in the (-1)^outcome eigenspace of the measured Pauli")
+            .def_readonly("deterministic", &Measurement_Result::deterministic, "bool\tWhether the Pauli, up to sign, was already in the stabiliser group")
+            .def("__eq__", &Measurement_Result::operator==)
+            .doc() = "The result of measuring a Hermitian Pauli on a stabiliser state";
+
         py::class_<Pauli>(m, "Pauli")
             .def_readwrite("number_qubits", &Pauli::number_qubits, "int\t\tThe number of qubits")
             .def_readwrite("x_vector", &Pauli::x_vector, "int")
@@ -26,12 +33,41 @@ namespace fst_pybind
             .def("is_hermitian", &Pauli::is_hermitian, "Returns whether the pauli operator is Hermitian")
             .def("commutes_with", &Pauli::commutes_with, py::arg("other_pauli"), "Given another Pauli, used to check whether it commutes with this Pauli")
             .def("anticommutes_with", &Pauli::anticommutes_with, py::arg("other_pauli"), "Given another Pauli, used to check whether it anticommutes with this Pauli")
-            .def("has_eigenstate", &Pauli::has_eigenstate, py::arg("vector"), py::arg("eig_sign"), "Given a statevector x on the same number of qubits as the Pauli P, checks whether or not Px = (-1)^(eig_sign) x, i.e. whether x is an eigenstate of P with eigenvalue (-1)^(eig_sign)")
-            .def("get_matrix", &Pauli::get_matrix, "Returns the matrix of the Pauli (with respect to the computational basis)")
-            .def("multiply_vector", &Pauli::multiply_vector, py::arg("vector"), "Given a vector x on the same number of qubits as the Pauli P, returns Px")
+            .def("has_eigenstate", [](const Pauli &pauli, const Complex_Array &vector, const unsigned int eig_sign)
+            {
+                return pauli.has_eigenstate(as_span(vector), eig_sign);
+            }, py::arg("vector"), py::arg("eig_sign"), "Given a statevector x on the same number of qubits as the Pauli P, checks whether or not Px = (-1)^(eig_sign) x, i.e. whether x is an eigenstate of P with eigenvalue (-1)^(eig_sign)")
+            .def("has_eigenstate", [](const Pauli &pauli, const Double_Complex_Array &vector, const unsigned int eig_sign)
+            {
+                return pauli.has_eigenstate(as_span(vector), eig_sign);
+            }, py::arg("vector"), py::arg("eig_sign"))
+            .def("get_matrix", [](const Pauli &pauli, const py::object &out)
+            {
+                const py::ssize_t size = py::ssize_t(1) << pauli.number_qubits;
+                return write_array({size, size}, out, [&](std::span<std::complex<float>> matrix) { pauli.get_matrix(matrix); });
+            }, py::arg("out") = py::none(), "Returns the matrix of the Pauli (with respect to the computational basis), as a numpy array. If out (a C-contiguous complex64 array of the same size) is given, the matrix is written into it instead")
+            .def("multiply_vector", [](const Pauli &pauli, const Complex_Array &vector, const py::object &out)
+            {
+                return write_array({vector.size()}, out, [&](std::span<std::complex<float>> result) { pauli.multiply_vector(as_span(vector), result); });
+            }, py::arg("vector"), py::arg("out") = py::none(), "Given a vector x on the same number of qubits as the Pauli P, returns Px as a numpy array. If out (a C-contiguous complex64 array) is given, Px is written into it instead, which may be x itself")
             .def("multiply_by_pauli_on_right", &Pauli::multiply_by_pauli_on_right, py::arg("other_pauli"), "Given another pauli Q, multiplies this Pauli on the right by Q. Note, the current instance is set to the result")
             .def("get_phase", &Pauli::get_phase, "Gets the current phase of the pauli: (-1)^(sign_bit) * (-i)^(imag_bit)")
             .doc() = "The class used to represent a Pauli operator. A Pauli is (-1)^(sign_bit) * (-i)^(imag_bit) * X^(x_vector) * Z^(z_vector). The phase of the Pauli is (-1)^(sign_bit) * (-i)^(imag_bit)";
+
+        py::class_<Wide_Pauli>(m, "Wide_Pauli")
+            .def_readwrite("number_qubits", &Wide_Pauli::number_qubits, "int\t\tThe number of qubits")
+            .def_readwrite("x_vector", &Wide_Pauli::x_vector, "int")
+            .def_readwrite("z_vector", &Wide_Pauli::z_vector, "int")
+            .def_readwrite("sign_bit", &Wide_Pauli::sign_bit, "int")
+            .def_readwrite("imag_bit", &Wide_Pauli::imag_bit, "int")
+            .def(py::init<const std::size_t, const F2_Vector, const F2_Vector, const bool, const bool>(), py::arg("number_qubits"), py::arg("x_vector"), py::arg("z_vector"), py::arg("sign_bit"), py::arg("imag_bit"))
+            .def("is_hermitian", &Wide_Pauli::is_hermitian, "Returns whether the pauli operator is Hermitian")
+            .def("commutes_with", &Wide_Pauli::commutes_with, py::arg("other_pauli"), "Given another Wide_Pauli, used to check whether it commutes with this Pauli")
+            .def("anticommutes_with", &Wide_Pauli::anticommutes_with, py::arg("other_pauli"), "Given another Wide_Pauli, used to check whether it anticommutes with this Pauli")
+            .def("multiply_by_pauli_on_right", &Wide_Pauli::multiply_by_pauli_on_right, py::arg("other_pauli"), "Given another Wide_Pauli Q, multiplies this Pauli on the right by Q. Note, the current instance is set to the result")
+            .def("get_phase", &Wide_Pauli::get_phase, "Gets the current phase of the pauli: (-1)^(sign_bit) * (-i)^(imag_bit)")
+            .def("__eq__", &Wide_Pauli::operator==)
+            .doc() = "A Pauli on any number of qubits, as for Pauli, with x_vector and z_vector taken as Python ints of any size (bit q for qubit q). The methods working with state vectors and matrices are only on Pauli";
     }
 }
 
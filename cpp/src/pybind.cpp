@@ -1,31 +1,49 @@
 #include <pybind11/pybind11.h>
 
+#include "util/tolerance_pybind.h"
 #include "pauli/pauli_pybind.h"
 #include "stabiliser_state/check_matrix_pybind.h"
 #include "stabiliser_state/stabiliser_state_pybind.h"
 #include "stabiliser_state/stabiliser_state_from_statevector_pybind.h"
+#include "stabiliser_state/inner_product_pybind.h"
 #include "clifford/clifford_pybind.h"
 #include "clifford/clifford_from_matrix_pybind.h"
+#include "clifford/tableau_simulator_pybind.h"
+#include "clifford/pauli_frames_pybind.h"
+#include "util/simd_pybind.h"
+#include "util/parallel_pybind.h"
 
 namespace py = pybind11;
 using namespace fst;
 
 namespace fst_pybind {
 
+    void init_tolerance(py::module_ &);
     void init_pauli(py::module_ &);
     void init_check_matrix(py::module_ &);
     void init_stabiliser_state(py::module_ &);
     void init_stabiliser_state_from_statevector(py::module_ &);
+    void init_inner_product(py::module_ &);
     void init_clifford(py::module_ &);
     void init_clifford_from_matrix(py::module_ &);
+    void init_tableau_simulator(py::module_ &);
+    void init_pauli_frames(py::module_ &);
+    void init_simd(py::module_ &);
+    void init_parallel(py::module_ &);
     
     PYBIND11_MODULE(_stab_tools, m)
     {
+        init_tolerance(m);
         init_pauli(m);
         init_check_matrix(m);
         init_stabiliser_state(m);
         init_stabiliser_state_from_statevector(m);
+        init_inner_product(m);
         init_clifford(m);
         init_clifford_from_matrix(m);
+        init_tableau_simulator(m);
+        init_pauli_frames(m);
+        init_simd(m);
+        init_parallel(m);
     }
 }
\ No newline at end of file
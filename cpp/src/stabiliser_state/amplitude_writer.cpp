@@ -0,0 +1,337 @@
+#include "amplitude_writer.h"
+
+#include "util/f2_helper.h"
+#include "util/parallel.h"
+#include "util/simd.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#ifdef FST_X86_64
+#include <immintrin.h>
+#endif
+
+using namespace fst;
+
+namespace
+{
+	/// Blocks are at most 2^max_block_bits amplitudes, so the table of inner exponents stays in L1 cache
+	constexpr std::size_t max_block_bits = 12;
+
+	/// States on fewer qubits than this are written on a single thread
+	constexpr std::size_t parallel_minimum_qubits = 18;
+
+	/// A block of consecutive amplitudes, where the amplitude at output[u] is amplitudes[k] for the phase exponent
+	/// k = constant_exponent ^ inner_exponent(u) ^ 2 * (u.mask mod 2)
+	///
+	/// inner_indices stores each inner exponent k as the pair (2k, 2k + 1): the positions of the real and imaginary
+	/// parts of amplitudes[k] when the table is viewed as 8 floats. XORing k with e XORs both positions with 2e.
+	template <std::floating_point Scalar>
+	struct Block
+	{
+		std::complex<Scalar> *output;
+		const std::uint8_t *inner_indices;
+		std::size_t size;
+		unsigned int constant_exponent;
+		std::size_t mask;
+	};
+
+	template <std::floating_point Scalar>
+	void write_block_scalar(const Block<Scalar> &block, const std::array<std::complex<Scalar>, 4> &amplitudes)
+	{
+		for (std::size_t u = 0; u < block.size; u++)
+		{
+			const unsigned int inner_exponent = block.inner_indices[2 * u] >> 1;
+			block.output[u] = amplitudes[inner_exponent ^ block.constant_exponent ^ (f2_dot_product(u, block.mask) << 1)];
+		}
+	}
+
+#ifdef FST_X86_64
+	/// Returns 4 * (lane.mask mod 2), the change to the float positions of complex lane lane
+	int lane_parity_offset(const std::size_t lane, const std::size_t mask)
+	{
+		return static_cast<int>(4 * f2_dot_product(lane, mask));
+	}
+
+	FST_TARGET_AVX2 void write_block_avx2(const Block<float> &block, const float *amplitude_floats)
+	{
+		const __m256 table = _mm256_loadu_ps(amplitude_floats);
+
+		// 4 amplitudes per vector: the low 2 bits of u are the lane, the rest are constant across the vector
+		const int lane_1 = lane_parity_offset(1, block.mask);
+		const int lane_2 = lane_parity_offset(2, block.mask);
+		const int lane_3 = lane_parity_offset(3, block.mask);
+		const __m256i lane_offsets = _mm256_setr_epi32(0, 0, lane_1, lane_1, lane_2, lane_2, lane_3, lane_3);
+
+		for (std::size_t u = 0; u < block.size; u += 4)
+		{
+			const int offset = static_cast<int>(2 * block.constant_exponent) ^ lane_parity_offset(u, block.mask);
+			const __m256i offsets = _mm256_xor_si256(lane_offsets, _mm256_set1_epi32(offset));
+
+			const __m128i inner_indices = _mm_loadl_epi64(reinterpret_cast<const __m128i *>(block.inner_indices + 2 * u));
+			const __m256i indices = _mm256_xor_si256(_mm256_cvtepu8_epi32(inner_indices), offsets);
+
+			_mm256_storeu_ps(reinterpret_cast<float *>(block.output + u), _mm256_permutevar8x32_ps(table, indices));
+		}
+	}
+
+	FST_TARGET_AVX512 void write_block_avx512(const Block<float> &block, const float *amplitude_floats)
+	{
+		// Only the low 8 floats are ever indexed, the upper half just repeats them
+		std::array<float, 16> table_values;
+		std::copy_n(amplitude_floats, 8, table_values.begin());
+		std::copy_n(amplitude_floats, 8, table_values.begin() + 8);
+
+		const __m512 table = _mm512_loadu_ps(table_values.data());
+
+		// 8 amplitudes per vector: the low 3 bits of u are the lane, the rest are constant across the vector
+		std::array<int, 16> lane_offset_values;
+
+		for (std::size_t lane = 0; lane < 8; lane++)
+		{
+			lane_offset_values[2 * lane] = lane_offset_values[2 * lane + 1] = lane_parity_offset(lane, block.mask);
+		}
+
+		const __m512i lane_offsets = _mm512_loadu_si512(lane_offset_values.data());
+
+		for (std::size_t u = 0; u < block.size; u += 8)
+		{
+			const int offset = static_cast<int>(2 * block.constant_exponent) ^ lane_parity_offset(u, block.mask);
+			const __m512i offsets = _mm512_xor_si512(lane_offsets, _mm512_set1_epi32(offset));
+
+			// (The full masked forms are used since GCC 12 warns about the undefined register in the unmasked ones)
+			const __m128i inner_indices = _mm_loadu_si128(reinterpret_cast<const __m128i *>(block.inner_indices + 2 * u));
+			const __m512i indices = _mm512_xor_si512(_mm512_maskz_cvtepu8_epi32(0xffff, inner_indices), offsets);
+
+			_mm512_storeu_ps(reinterpret_cast<float *>(block.output + u), _mm512_mask_permutexvar_ps(table, 0xffff, indices, table));
+		}
+	}
+#endif
+
+	/// The vector kernels permute a table of floats, so double precision blocks always use the scalar kernel
+	template <std::floating_point Scalar>
+	void write_block(const Block<Scalar> &block, const std::array<std::complex<Scalar>, 4> &amplitudes, [[maybe_unused]] const Simd_Level simd_level)
+	{
+#ifdef FST_X86_64
+		if constexpr (std::is_same_v<Scalar, float>)
+		{
+			const float *amplitude_floats = reinterpret_cast<const float *>(amplitudes.data());
+
+			switch (simd_level)
+			{
+				case Simd_Level::avx512:
+					write_block_avx512(block, amplitude_floats);
+					return;
+				case Simd_Level::avx2:
+					write_block_avx2(block, amplitude_floats);
+					return;
+				default:
+					break;
+			}
+		}
+#endif
+		write_block_scalar(block, amplitudes);
+	}
+
+	template <std::floating_point Scalar>
+	void write_state_vector_templated(const Stabiliser_State &state, std::span<std::complex<Scalar>> state_vector)
+	{
+		state.check_dimensions();
+
+		if (state_vector.size() != integral_pow_2(state.number_qubits))
+		{
+			throw std::invalid_argument("The output for the state vector must have length 2^number_qubits");
+		}
+
+		// With the basis row reduced on the highest qubits first, a unit vector e_k is in its span exactly when it
+		// is one of the basis vectors, so the blocks below are as large as the support allows. Reducing a copy
+		// takes O(dim^2) word operations, so any basis (e.g. after measure) gets the vector kernels
+		if (!state.row_reduced)
+		{
+			Stabiliser_State reduced_state = state;
+			reduced_state.row_reduce_basis();
+			write_state_vector_templated(reduced_state, state_vector);
+
+			return;
+		}
+
+		const std::size_t dim = state.dim;
+
+		// The inner basis: inner_basis[k] is the index of the basis vector e_k
+		std::vector<std::size_t> inner_basis;
+		std::vector<bool> is_inner(dim, false);
+
+		while (inner_basis.size() < std::min(dim, max_block_bits))
+		{
+			const auto unit_vector = std::find(state.basis_vectors.begin(), state.basis_vectors.end(), integral_pow_2(inner_basis.size()));
+
+			if (unit_vector == state.basis_vectors.end())
+			{
+				break;
+			}
+
+			inner_basis.push_back(static_cast<std::size_t>(unit_vector - state.basis_vectors.begin()));
+			is_inner[inner_basis.back()] = true;
+		}
+
+		std::vector<std::size_t> outer_basis;
+
+		for (std::size_t j = 0; j < dim; j++)
+		{
+			if (!is_inner[j])
+			{
+				outer_basis.push_back(j);
+			}
+		}
+
+		const std::size_t block_bits = inner_basis.size();
+		const std::size_t block_size = integral_pow_2(block_bits);
+
+		// The quadratic form within the inner basis, and between each outer basis vector and the inner basis,
+		// as masks over the low block_bits qubits
+		std::vector<std::size_t> inner_form(block_bits, 0);
+		std::vector<std::size_t> cross_form(outer_basis.size(), 0);
+
+		for (std::size_t k = 0; k < block_bits; k++)
+		{
+			for (std::size_t l = 0; l < block_bits; l++)
+			{
+				inner_form[k] |= std::size_t(state.get_quadratic_form(inner_basis[k], inner_basis[l])) << l;
+			}
+
+			for (std::size_t f = 0; f < outer_basis.size(); f++)
+			{
+				cross_form[f] |= std::size_t(state.get_quadratic_form(outer_basis[f], inner_basis[k])) << k;
+			}
+		}
+
+		// The phase exponents of the inner combinations, through a Gray code over the inner basis
+		std::vector<std::uint8_t> inner_indices(2 * block_size);
+		inner_indices[1] = 1;
+
+		for (std::size_t iterate = 1, u = 0, exponent = 0; iterate < block_size; iterate++)
+		{
+			const std::size_t k = std::countr_zero(iterate);
+			const std::size_t j = inner_basis[k];
+
+			exponent ^= 2 * (bit_set_at(state.real_linear_part, j) ^ f2_dot_product(inner_form[k], u)) ^ bit_set_at(state.imaginary_part, j);
+			u ^= integral_pow_2(k);
+
+			inner_indices[2 * u] = static_cast<std::uint8_t>(2 * exponent);
+			inner_indices[2 * u + 1] = static_cast<std::uint8_t>(2 * exponent + 1);
+		}
+
+		const auto amplitudes = scaled_powers_of_i(std::complex<Scalar>(state.global_phase) / std::sqrt(Scalar(integral_pow_2(dim))));
+
+		Simd_Level simd_level = get_simd_level();
+
+		if (simd_level == Simd_Level::avx512 && block_size < 8)
+		{
+			simd_level = Simd_Level::avx2;
+		}
+
+		if (simd_level == Simd_Level::avx2 && block_size < 4)
+		{
+			simd_level = Simd_Level::scalar;
+		}
+
+		// Writes the blocks first_iterate, ..., last_iterate - 1 of the Gray code over the outer basis. Each step gives
+		// the block of indices (shift + outer combination) ^ (all inner combinations)
+		const auto write_blocks = [&](const std::size_t first_iterate, const std::size_t last_iterate)
+		{
+			// The Gray code at first_iterate, and the index, forms and phase of that outer combination
+			const std::size_t gray_code = first_iterate ^ (first_iterate >> 1);
+			std::size_t index = state.shift;
+			std::size_t outer_vector_index = 0;
+			std::size_t cross_mask = 0;
+
+			for (std::size_t f = 0; f < outer_basis.size(); f++)
+			{
+				if (bit_set_at(gray_code, f))
+				{
+					index ^= state.basis_vectors[outer_basis[f]];
+					outer_vector_index ^= integral_pow_2(outer_basis[f]);
+					cross_mask ^= cross_form[f];
+				}
+			}
+
+			unsigned int outer_exponent = state.get_phase_exponent(outer_vector_index);
+
+			for (std::size_t iterate = first_iterate;;)
+			{
+				const std::size_t low_bits = index & (block_size - 1);
+
+				// Amplitude u of the block has inner coordinates u ^ low_bits, and the quadratic form splits as
+				// Q(u ^ low_bits) = Q(u) + Q(low_bits) + u.(inner_form low_bits)
+				std::size_t mask = cross_mask;
+
+				for (std::size_t k = 0; k < block_bits; k++)
+				{
+					if (bit_set_at(low_bits, k))
+					{
+						mask ^= inner_form[k];
+					}
+				}
+
+				const unsigned int constant_exponent = outer_exponent ^ (inner_indices[2 * low_bits] >> 1) ^ (f2_dot_product(low_bits, cross_mask) << 1);
+				const Block<Scalar> block {state_vector.data() + (index ^ low_bits), inner_indices.data(), block_size, constant_exponent, mask};
+
+				write_block(block, amplitudes, simd_level);
+
+				if (++iterate == last_iterate)
+				{
+					break;
+				}
+
+				const std::size_t f = std::countr_zero(iterate);
+				const std::size_t j = outer_basis[f];
+
+				index ^= state.basis_vectors[j];
+				outer_exponent ^= 2 * (bit_set_at(state.real_linear_part, j) ^ f2_dot_product(state.quadratic_form[j], outer_vector_index)) ^ bit_set_at(state.imaginary_part, j);
+				outer_vector_index ^= integral_pow_2(j);
+				cross_mask ^= cross_form[f];
+			}
+		};
+
+		// Small states are written on the calling thread, where starting threads would cost more than the work
+		const std::size_t number_threads = state.number_qubits < parallel_minimum_qubits ? 1 : get_number_threads();
+
+		// Every entry is overwritten when the support is everything. Otherwise the zero-fill has to finish
+		// before any block is written, as a block can land in any part of the output
+		if (dim != state.number_qubits)
+		{
+			const std::size_t number_tasks = std::min(number_threads, state_vector.size());
+
+			parallel_for(number_tasks, [&](const std::size_t task)
+			{
+				const std::size_t first = task * state_vector.size() / number_tasks;
+				const std::size_t last = (task + 1) * state_vector.size() / number_tasks;
+				std::fill(state_vector.begin() + first, state_vector.begin() + last, std::complex<Scalar>{0, 0});
+			});
+		}
+
+		const std::size_t number_blocks = integral_pow_2(outer_basis.size());
+		const std::size_t number_tasks = std::min(number_threads, number_blocks);
+
+		parallel_for(number_tasks, [&](const std::size_t task)
+		{
+			write_blocks(task * number_blocks / number_tasks, (task + 1) * number_blocks / number_tasks);
+		});
+	}
+}
+
+void fst::write_state_vector(const Stabiliser_State &state, std::span<std::complex<float>> state_vector)
+{
+	write_state_vector_templated(state, state_vector);
+}
+
+void fst::write_state_vector(const Stabiliser_State &state, std::span<std::complex<double>> state_vector)
+{
+	write_state_vector_templated(state, state_vector);
+}
@@ -0,0 +1,30 @@
+#ifndef _FAST_STABILISER_AMPLITUDE_WRITER_H
+#define _FAST_STABILISER_AMPLITUDE_WRITER_H
+
+#include "stabiliser_state.h"
+
+#include <complex>
+#include <span>
+
+namespace fst
+{
+	/// Writes the state vector of the stabiliser state into state_vector, which must have length
+	/// 2^number_qubits. Entries outside the support of the state are set to zero.
+	///
+	/// The support is split into blocks of 2^b consecutive indices, where b is the number of low
+	/// qubits whose unit vectors are basis vectors (all of them, for a row reduced basis spanning
+	/// those qubits). Within a block the phase exponent of index u is
+	///     K ^ inner_exponents[u] ^ 2 * (u.d mod 2)
+	/// for a constant K and mask d per block, so each block is written with a table lookup per
+	/// amplitude, using AVX2 or AVX-512 when get_simd_level() allows.
+	///
+	/// The blocks are walked in Gray code order over the other basis vectors. For large states the
+	/// walk is split into get_number_threads() contiguous ranges, each starting from a phase computed
+	/// directly from the forms, and run through parallel_for.
+	///
+	/// Double precision output is written with the scalar kernel, from amplitudes computed in double.
+	void write_state_vector(const Stabiliser_State &state, std::span<std::complex<float>> state_vector);
+	void write_state_vector(const Stabiliser_State &state, std::span<std::complex<double>> state_vector);
+}
+
+#endif
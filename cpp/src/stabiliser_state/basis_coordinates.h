@@ -0,0 +1,114 @@
+#ifndef _FAST_STABILISER_BASIS_COORDINATES_H
+#define _FAST_STABILISER_BASIS_COORDINATES_H
+
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <optional>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace fst
+{
+	/// Writes vectors in the span of a list of (up to 64) vectors as a combination of them.
+	///
+	/// The list is reduced once, in O(d^2) word operations for d vectors, to rows with distinct pivot bits
+	/// that no other row has, each with the mask of the original vectors summing to it. Each query then takes
+	/// O(d) word operations: the coefficients of y are the combined masks of the rows whose pivot y has.
+	/// The vectors that are combinations of earlier ones are kept as dependencies, which span the
+	/// combinations of the list that sum to zero.
+	template <std::unsigned_integral Bits>
+	class Basis_Coordinates
+	{
+		public:
+		explicit Basis_Coordinates(const std::span<const Bits> vectors)
+		{
+			for (std::size_t j = 0; j < vectors.size(); j++)
+			{
+				Row row {vectors[j], std::size_t(1) << j, 0};
+
+				for (const Row &other_row : rows)
+				{
+					if (row.vector & other_row.pivot)
+					{
+						row.vector ^= other_row.vector;
+						row.combination ^= other_row.combination;
+					}
+				}
+
+				// A vector in the span of the previous ones gets no row, so is never needed in a combination
+				if (row.vector == 0)
+				{
+					dependencies.push_back(row.combination);
+					continue;
+				}
+
+				row.pivot = row.vector & (~row.vector + 1);
+
+				for (Row &other_row : rows)
+				{
+					if (other_row.vector & row.pivot)
+					{
+						other_row.vector ^= row.vector;
+						other_row.combination ^= row.combination;
+					}
+				}
+
+				rows.push_back(row);
+			}
+		}
+
+		/// Returns the remainder of y after adding the rows that clear its pivot bits, with the mask of the
+		/// vectors added. The remainder is the same for every y in a coset of the span, and zero on the span
+		std::pair<Bits, std::size_t> reduce(const Bits y) const
+		{
+			Bits remainder = y;
+			std::size_t coefficients = 0;
+
+			for (const Row &row : rows)
+			{
+				if (y & row.pivot)
+				{
+					remainder ^= row.vector;
+					coefficients ^= row.combination;
+				}
+			}
+
+			return {remainder, coefficients};
+		}
+
+		/// Returns the mask of the vectors summing to y (bit j for vectors[j]), or nothing if y is not in their span
+		std::optional<std::size_t> get_coefficients(const Bits y) const
+		{
+			const auto [remainder, coefficients] = reduce(y);
+
+			if (remainder != 0)
+			{
+				return std::nullopt;
+			}
+
+			return coefficients;
+		}
+
+		/// Returns one mask of vectors summing to zero for each vector in the span of the ones before it.
+		/// These are a basis of all such masks
+		const std::vector<std::size_t> &get_dependencies() const
+		{
+			return dependencies;
+		}
+
+		private:
+		struct Row
+		{
+			Bits vector;
+			std::size_t combination;
+			Bits pivot;
+		};
+
+		std::vector<Row> rows;
+		std::vector<std::size_t> dependencies;
+	};
+}
+
+#endif
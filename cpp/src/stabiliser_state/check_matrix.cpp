@@ -1,12 +1,94 @@
 #include "check_matrix.h"
 #include "stabiliser_state.h"
 #include "util/f2_helper.h"
+#include "util/f2_vector.h"
+#include "util/f2_matrix.h"
 
+#include <algorithm>
+#include <bit>
+#include <numeric>
 #include <stdexcept>
 
+namespace
+{
+    using word_type = fst::F2_Matrix::word_type;
+
+    /// The row operation for a tableau of Paulis with rows [x_vector words | z_vector words | phase word],
+    /// where the sign_bit and imag_bit are the first two bits of the phase word. Multiplies the target
+    /// Pauli on the right by the source Pauli, as Pauli::multiply_by_pauli_on_right does.
+    struct Multiply_Paulis
+    {
+        std::size_t pauli_words;
+
+        void operator()(std::span<word_type> target, std::span<const word_type> source) const noexcept
+        {
+            const std::size_t phase_word = 2 * pauli_words;
+            word_type product = 0;
+
+            for (std::size_t i = 0; i < pauli_words; i++)
+            {
+                product ^= target[pauli_words + i] & source[i];
+            }
+
+            const word_type sign_bit_update = (std::popcount(product) % 2) ^ (target[phase_word] & source[phase_word] & 2) >> 1;
+
+            for (std::size_t i = 0; i < target.size(); i++)
+            {
+                target[i] ^= source[i];
+            }
+
+            target[phase_word] ^= sign_bit_update;
+        }
+    };
+
+    /// The Gauss-Jordan elimination of the small-matrix branch of fst::row_reduce with Multiply_Paulis, for Paulis
+    /// on at most 64 qubits held as one word each of x bits, z bits, sign bits and imag bits. Each of the given rows
+    /// takes the highest set bit of column_mask in its x word (or z word) as its pivot, and every other row with that
+    /// bit is multiplied on the right by it. Returns the pivot of each of the rows, or -1 if it has none
+    template <bool on_x>
+    std::vector<int> eliminate_words(std::span<word_type> x, std::span<word_type> z, std::span<word_type> sign, std::span<word_type> imag, std::span<const std::size_t> rows, const word_type column_mask)
+    {
+        std::vector<int> pivots(rows.size(), -1);
+
+        for (std::size_t r = 0; r < rows.size(); r++)
+        {
+            const std::size_t row = rows[r];
+            const word_type pivot_bits = (on_x ? x[row] : z[row]) & column_mask;
+
+            if (pivot_bits == 0)
+            {
+                continue;
+            }
+
+            const int column = fst::integral_log_2(pivot_bits);
+
+            for (const std::size_t other : rows)
+            {
+                if (other == row)
+                {
+                    continue;
+                }
+
+                // All ones if the other row has the pivot, so the product is applied without branching
+                const word_type mask = word_type(0) - (((on_x ? x[other] : z[other]) >> column) & 1);
+
+                sign[other] ^= mask & (fst::f2_dot_product(z[other], x[row]) ^ (imag[other] & imag[row]) ^ sign[row]);
+                imag[other] ^= mask & imag[row];
+                x[other] ^= mask & x[row];
+                z[other] ^= mask & z[row];
+            }
+
+            pivots[r] = column;
+        }
+
+        return pivots;
+    }
+}
+
 namespace fst
 {
-    Check_Matrix::Check_Matrix(const std::vector<Pauli> paulis, const bool row_reduced)
+    template <f2_vector_like Bits>
+    Basic_Check_Matrix<Bits>::Basic_Check_Matrix(const std::vector<Pauli_Type> paulis, const bool row_reduced)
         : row_reduced(row_reduced), paulis(paulis)
     {
         number_qubits = paulis.size();
@@ -18,29 +100,34 @@ namespace fst
         }
     }
 
-    const std::vector<Pauli>& Check_Matrix::get_paulis() const
+    template <f2_vector_like Bits>
+    const std::vector<Basic_Pauli<Bits>>& Basic_Check_Matrix<Bits>::get_paulis() const
     {
         return paulis;
     }
 
-    void Check_Matrix::set_paulis(std::vector<Pauli> paulis_)
+    template <f2_vector_like Bits>
+    void Basic_Check_Matrix<Bits>::set_paulis(std::vector<Pauli_Type> paulis_)
     {
         row_reduced = false;
         paulis = std::move(paulis_);
         categorise_paulis();
     }
 
-    const std::vector<Pauli *>& Check_Matrix::get_z_only_stabilisers() const
+    template <f2_vector_like Bits>
+    const std::vector<Basic_Pauli<Bits> *>& Basic_Check_Matrix<Bits>::get_z_only_stabilisers() const
     {
         return z_only_stabilisers;
     }
 
-    const std::vector<Pauli *>& Check_Matrix::get_x_stabilisers() const
+    template <f2_vector_like Bits>
+    const std::vector<Basic_Pauli<Bits> *>& Basic_Check_Matrix<Bits>::get_x_stabilisers() const
     {
         return x_stabilisers;
     }
 
-    const std::vector<std::size_t> & Check_Matrix::get_z_only_pivots() const
+    template <f2_vector_like Bits>
+    const std::vector<std::size_t> & Basic_Check_Matrix<Bits>::get_z_only_pivots() const
     {
         if (row_reduced)
         {
@@ -50,11 +137,15 @@ namespace fst
         throw std::domain_error("Tried to access z_only pivots of a non-row reduced check matrix. Try row reducing first");
     }
 
-    void Check_Matrix::categorise_paulis()
+    template <f2_vector_like Bits>
+    void Basic_Check_Matrix<Bits>::categorise_paulis()
     {
+        z_only_stabilisers.clear();
+        x_stabilisers.clear();
+
         for (auto &pauli : paulis)
         {
-            if (pauli.x_vector == 0)
+            if (is_zero(pauli.x_vector))
             {
                 z_only_stabilisers.push_back(&pauli);
             }
@@ -64,22 +155,24 @@ namespace fst
         }
     }
 
-    Check_Matrix::Check_Matrix(Stabiliser_State &stabiliser_state)
+    template <f2_vector_like Bits>
+    Basic_Check_Matrix<Bits>::Basic_Check_Matrix(Basic_Stabiliser_State<Bits> &stabiliser_state)
     {
         number_qubits = stabiliser_state.number_qubits;
 
+        stabiliser_state.check_dimensions();
         stabiliser_state.row_reduce_basis();
 
         paulis.reserve(number_qubits);
 
-        std::vector<std::size_t> pivot_vectors;
+        std::vector<Bits> pivot_vectors;
         std::unordered_set<std::size_t> pivot_indices_set;
 
-        for(const auto basis_vector : stabiliser_state.basis_vectors)
+        for(const auto &basis_vector : stabiliser_state.basis_vectors)
         {
             std::size_t pivot_index = integral_log_2(basis_vector);
             pivot_indices_set.insert(pivot_index);
-            pivot_vectors.push_back(integral_pow_2(pivot_index));
+            pivot_vectors.push_back(unit_vector<Bits>(pivot_index));
         }
 
         add_x_stabilisers(pivot_vectors, stabiliser_state);
@@ -88,23 +181,27 @@ namespace fst
         row_reduced = true;
     }
 
-    void Check_Matrix::add_z_only_stabilisers(const std::vector<std::size_t> &pivot_vectors, const std::unordered_set<std::size_t> &pivot_indices_set, const Stabiliser_State &state)
+    template <f2_vector_like Bits>
+    void Basic_Check_Matrix<Bits>::add_z_only_stabilisers(const std::vector<Bits> &pivot_vectors, const std::unordered_set<std::size_t> &pivot_indices_set, const Basic_Stabiliser_State<Bits> &state)
     {
         for(std::size_t i = 0; i < number_qubits; i++)
         {
             if (!pivot_indices_set.contains(i))
             {
-                std::size_t alpha = integral_pow_2(i);
+                Bits alpha = unit_vector<Bits>(i);
 
                 // Make alpha perpendicular to the basis vectors
                 for (std::size_t j = 0; j < state.dim; j++)
                 {
-                    alpha |= bit_set_at(state.basis_vectors[j], i) * pivot_vectors[j];
+                    if (bit_set_at(state.basis_vectors[j], i))
+                    {
+                        alpha |= pivot_vectors[j];
+                    }
                 }
 
                 bool sign_bit = f2_dot_product(alpha, state.shift);
                 
-                Pauli pauli(number_qubits, 0, alpha, sign_bit, 0);
+                Pauli_Type pauli(number_qubits, Bits{}, alpha, sign_bit, 0);
                 paulis.push_back(pauli);
                 z_only_stabilisers.push_back(&paulis.back());
                 z_only_pivots.push_back(i);
@@ -113,109 +210,316 @@ namespace fst
         }
     }
 
-    void Check_Matrix::add_x_stabilisers(const std::vector<std::size_t> &pivot_vectors, const Stabiliser_State &state)
+    template <f2_vector_like Bits>
+    void Basic_Check_Matrix<Bits>::add_x_stabilisers(const std::vector<Bits> &pivot_vectors, const Basic_Stabiliser_State<Bits> &state)
     {
         for (std::size_t i = 0; i < state.dim; i++)
         {
             bool imag_bit = bit_set_at(state.imaginary_part, i);
             
-            std::size_t z_vector = 0;
+            Bits z_vector{};
 
             // Ensure that the z_vector has the correct inner product with all the basis vectors
             for (std::size_t j = 0; j < state.dim; j++)
             {
-                z_vector ^= pivot_vectors[j] * (state.quadratic_form.at(integral_pow_2(i) ^ integral_pow_2(j)) ^ ( (int) imag_bit & bit_set_at(state.imaginary_part, j) ));
+                if (state.get_quadratic_form(i, j) ^ (imag_bit & bit_set_at(state.imaginary_part, j)))
+                {
+                    z_vector ^= pivot_vectors[j];
+                }
             }
 
             bool sign_bit = bit_set_at(state.real_linear_part, i) ^ imag_bit ^ f2_dot_product(z_vector, state.shift);
 
-            Pauli pauli(number_qubits, state.basis_vectors[i], z_vector, sign_bit, imag_bit);
+            Pauli_Type pauli(number_qubits, state.basis_vectors[i], z_vector, sign_bit, imag_bit);
             paulis.push_back(pauli);
             x_stabilisers.push_back(&paulis.back());
         }
     }
 
-    std::vector<std::complex<float>> Check_Matrix::get_state_vector()
+    template <f2_vector_like Bits>
+    std::vector<std::complex<float>> Basic_Check_Matrix<Bits>::get_state_vector()
+        requires std::unsigned_integral<Bits>
     {
-        return Stabiliser_State(*this).get_state_vector();
+        return Basic_Stabiliser_State<Bits>(*this).get_state_vector();
     }
 
-    void Check_Matrix::row_reduce()
+    template <f2_vector_like Bits>
+    void Basic_Check_Matrix<Bits>::get_state_vector(std::span<std::complex<float>> state_vector)
+        requires std::unsigned_integral<Bits>
     {
-        if (row_reduced) {return;}
+        Basic_Stabiliser_State<Bits>(*this).get_state_vector(state_vector);
+    }
 
-        row_reduce_x_stabilisers();
-        row_reduce_z_only_stabilisers();
-        
-        set_z_only_pivots();
+    template <f2_vector_like Bits>
+    void Basic_Check_Matrix<Bits>::get_state_vector(std::span<std::complex<double>> state_vector)
+        requires std::unsigned_integral<Bits>
+    {
+        Basic_Stabiliser_State<Bits>(*this).get_state_vector(state_vector);
+    }
 
-        row_reduced = true;
+    template <f2_vector_like Bits>
+    std::pair<std::vector<Bits>, std::vector<std::complex<float>>> Basic_Check_Matrix<Bits>::get_sparse_state_vector()
+        requires std::unsigned_integral<Bits>
+    {
+        return Basic_Stabiliser_State<Bits>(*this).get_sparse_state_vector();
+    }
+
+    template <f2_vector_like Bits>
+    int Basic_Check_Matrix<Bits>::get_expectation_value(const Pauli_Type &pauli)
+        requires std::unsigned_integral<Bits>
+    {
+        return Basic_Stabiliser_State<Bits>(*this).get_expectation_value(pauli);
+    }
+
+    template <f2_vector_like Bits>
+    std::vector<int> Basic_Check_Matrix<Bits>::get_expectation_values(std::span<const Pauli_Type> paulis)
+        requires std::unsigned_integral<Bits>
+    {
+        return Basic_Stabiliser_State<Bits>(*this).get_expectation_values(paulis);
     }
 
-    void Check_Matrix::row_reduce_x_stabilisers()
+    template <f2_vector_like Bits>
+    Measurement_Result Basic_Check_Matrix<Bits>::measure(const Pauli_Type &pauli, const bool outcome)
     {
-        for (std::size_t i = 0; i < x_stabilisers.size(); i++)
+        if (pauli.number_qubits != number_qubits)
         {
-            Pauli *pauli = x_stabilisers[i];
-            int pivot_index = integral_log_2(pauli->x_vector);
+            throw std::invalid_argument("The Pauli must be on the same number of qubits as the check matrix");
+        }
 
-            if (pivot_index == -1)
-            {
-                x_stabilisers.erase(x_stabilisers.begin() + i);
-                z_only_stabilisers.push_back(pauli);
-                i--;
-            }
-            else
+        if (!pauli.is_hermitian())
+        {
+            throw std::invalid_argument("Only Hermitian Paulis can be measured");
+        }
+
+        const auto anticommuting = std::find_if(paulis.begin(), paulis.end(), [&](const Pauli_Type &generator) { return generator.anticommutes_with(pauli); });
+
+        if (anticommuting != paulis.end())
+        {
+            // The products of the other anticommuting generators with this one commute with P, and still generate the
+            // group with it
+            for (auto generator = anticommuting + 1; generator != paulis.end(); generator++)
             {
-                auto u_pivot_index = (std::size_t) pivot_index;
-                for (auto &other_pauli : x_stabilisers)
+                if (generator->anticommutes_with(pauli))
                 {
-                    if (other_pauli != pauli && bit_set_at(other_pauli->x_vector, u_pivot_index))
-                    {
-                        other_pauli->multiply_by_pauli_on_right(*pauli);
-                    }
+                    generator->multiply_by_pauli_on_right(*anticommuting);
                 }
             }
+
+            *anticommuting = pauli;
+            anticommuting->sign_bit ^= outcome;
+
+            row_reduced = false;
+            categorise_paulis();
+
+            return {outcome, false};
+        }
+
+        row_reduce();
+
+        // +-P is in the group, and the pivots pick out its factors: first the x_stabilisers whose pivot columns are
+        // set in its x_vector, then the z_only stabilisers whose pivots are set in what is left of its z_vector
+        Pauli_Type product(number_qubits, Bits{}, Bits{}, false, false);
+
+        if constexpr (!std::unsigned_integral<Bits>)
+        {
+            product.x_vector = F2_Vector::zeros(number_qubits);
+            product.z_vector = F2_Vector::zeros(number_qubits);
+        }
+
+        for (const Pauli_Type *generator : x_stabilisers)
+        {
+            if (bit_set_at(pauli.x_vector, static_cast<std::size_t>(integral_log_2(generator->x_vector))))
+            {
+                product.multiply_by_pauli_on_right(*generator);
+            }
         }
+
+        for (std::size_t i = 0; i < z_only_stabilisers.size(); i++)
+        {
+            if (bit_set_at(pauli.z_vector, z_only_pivots[i]) != bit_set_at(product.z_vector, z_only_pivots[i]))
+            {
+                product.multiply_by_pauli_on_right(*z_only_stabilisers[i]);
+            }
+        }
+
+        // P is +1 or -1 times the product, which has eigenvalue +1
+        return {(pauli.get_phase_exponent() + 4 - product.get_phase_exponent()) % 4 == 2, true};
     }
 
-    // TODO this repeats alot of code from reducing x_stabilisers, optimise?
-    void Check_Matrix::row_reduce_z_only_stabilisers()
+    template <f2_vector_like Bits>
+    Measurement_Result Basic_Check_Matrix<Bits>::measure(const Pauli_Type &pauli, Random_Generator &generator)
     {
-        for (std::size_t i = 0; i < z_only_stabilisers.size(); i++)
+        return measure(pauli, static_cast<bool>(generator() & 1));
+    }
+
+    template <f2_vector_like Bits>
+    void Basic_Check_Matrix<Bits>::row_reduce()
+    {
+        if (row_reduced) {return;}
+
+        std::vector<int> x_pivots;
+        std::vector<std::size_t> z_only_rows;
+        std::vector<int> z_pivots;
+
+        if constexpr (std::unsigned_integral<Bits>)
+        {
+            // Each Pauli fits in a word, so eliminate on the words directly: at these sizes copying the Paulis
+            // into a tableau and back costs more than the elimination itself
+            std::vector<word_type> x(paulis.size());
+            std::vector<word_type> z(paulis.size());
+            std::vector<word_type> sign(paulis.size());
+            std::vector<word_type> imag(paulis.size());
+
+            for (std::size_t i = 0; i < paulis.size(); i++)
+            {
+                x[i] = paulis[i].x_vector;
+                z[i] = paulis[i].z_vector;
+                sign[i] = paulis[i].sign_bit;
+                imag[i] = paulis[i].imag_bit;
+            }
+
+            std::vector<std::size_t> rows(paulis.size());
+            std::iota(rows.begin(), rows.end(), 0);
+
+            const word_type qubit_mask = number_qubits < F2_Matrix::word_size ? integral_pow_2(word_type(number_qubits)) - 1 : ~word_type(0);
+            x_pivots = eliminate_words<true>(x, z, sign, imag, rows, qubit_mask);
+
+            // The z_only stabilisers are reduced on the columns that are not pivots of the x_stabilisers, as below
+            word_type z_column_mask = qubit_mask;
+
+            for (std::size_t i = 0; i < paulis.size(); i++)
+            {
+                if (x_pivots[i] == -1)
+                {
+                    z_only_rows.push_back(i);
+                }
+                else
+                {
+                    z_column_mask &= ~integral_pow_2(word_type(x_pivots[i]));
+                }
+            }
+
+            z_pivots = eliminate_words<false>(x, z, sign, imag, z_only_rows, z_column_mask);
+
+            for (std::size_t i = 0; i < paulis.size(); i++)
+            {
+                paulis[i].x_vector = x[i];
+                paulis[i].z_vector = z[i];
+                paulis[i].sign_bit = static_cast<unsigned int>(sign[i]);
+                paulis[i].imag_bit = static_cast<unsigned int>(imag[i]);
+            }
+        }
+        else
         {
-            Pauli *pauli = z_only_stabilisers[i];
-            std::size_t pivot_index = integral_log_2(pauli->z_vector);
+            // Copy the Paulis into a tableau with contiguous rows: [x_vector words | z_vector words | phase word]
+            const std::size_t pauli_words = F2_Vector::number_words_for(number_qubits);
+            const std::size_t z_column = pauli_words * F2_Matrix::word_size;
+            const std::size_t phase_column = 2 * z_column;
+
+            F2_Matrix tableau(paulis.size(), phase_column + 2);
+
+            for (std::size_t i = 0; i < paulis.size(); i++)
+            {
+                tableau.set_row_bits(i, 0, number_qubits, paulis[i].x_vector);
+                tableau.set_row_bits(i, z_column, number_qubits, paulis[i].z_vector);
+                tableau.set(i, phase_column, paulis[i].sign_bit);
+                tableau.set(i, phase_column + 1, paulis[i].imag_bit);
+            }
+
+            const Multiply_Paulis multiply_paulis {pauli_words};
+
+            std::vector<std::size_t> rows(paulis.size());
+            std::iota(rows.begin(), rows.end(), 0);
+
+            std::vector<std::size_t> x_columns(number_qubits);
+            std::iota(x_columns.rbegin(), x_columns.rend(), 0);
+
+            x_pivots = fst::row_reduce(tableau, rows, x_columns, multiply_paulis);
+
+            // The rows left with no x component are the "z_only" stabilisers. Their pivots must not be
+            // pivot columns of the "x_stabilisers", so reduce them on the remaining columns only
+            std::vector<bool> is_x_pivot(number_qubits, false);
+
+            for (std::size_t i = 0; i < paulis.size(); i++)
+            {
+                if (x_pivots[i] == -1)
+                {
+                    z_only_rows.push_back(i);
+                }
+                else
+                {
+                    is_x_pivot[x_pivots[i]] = true;
+                }
+            }
+
+            std::vector<std::size_t> z_columns;
+
+            for (std::size_t i = number_qubits; i-- > 0;)
+            {
+                if (!is_x_pivot[i])
+                {
+                    z_columns.push_back(z_column + i);
+                }
+            }
+
+            z_pivots = fst::row_reduce(tableau, z_only_rows, z_columns, multiply_paulis);
 
-            for (auto &other_pauli : z_only_stabilisers)
+            // Number the z pivots by qubit, as the x pivots are
+            for (int &pivot : z_pivots)
             {
-                if (other_pauli != pauli && bit_set_at(other_pauli->z_vector, pivot_index))
+                if (pivot != -1)
                 {
-                    other_pauli->multiply_by_pauli_on_right(*pauli);
+                    pivot -= static_cast<int>(z_column);
                 }
             }
+
+            for (std::size_t i = 0; i < paulis.size(); i++)
+            {
+                paulis[i].x_vector = tableau.get_row_bits<Bits>(i, 0, number_qubits);
+                paulis[i].z_vector = tableau.get_row_bits<Bits>(i, z_column, number_qubits);
+                paulis[i].sign_bit = tableau.get(i, phase_column);
+                paulis[i].imag_bit = tableau.get(i, phase_column + 1);
+            }
+        }
+
+        categorise_paulis();
+
+        z_only_pivots.clear();
+        z_only_pivots.reserve(z_only_rows.size());
+
+        for (const int pivot : z_pivots)
+        {
+            if (pivot == -1)
+            {
+                throw std::invalid_argument("The Paulis in the check matrix are not independent");
+            }
+
+            z_only_pivots.push_back(static_cast<std::size_t>(pivot));
         }
+
+        row_reduced = true;
     }
 
-    void Check_Matrix::set_z_only_pivots()
+    template <f2_vector_like Bits>
+    void Basic_Check_Matrix<Bits>::set_z_only_pivots()
     {
         // Create a vector with 1s in all the (x_stabiliser) pivot indicies, and zeros elsewhere
-        std::size_t pivot_marker;
+        Bits pivot_marker{};
 
         for (const auto & pauli : x_stabilisers)
         {
-            pivot_marker ^= integral_pow_2((std::size_t) integral_log_2(pauli->x_vector));
+            pivot_marker ^= unit_vector<Bits>((std::size_t) integral_log_2(pauli->x_vector));
         }
 
-        // Flip all of the bits in the pivot marker
-        pivot_marker ^= (integral_pow_2(number_qubits) - 1);
-
         z_only_pivots.reserve(z_only_stabilisers.size());
 
         for (const auto & pauli : z_only_stabilisers)
         {
-            // Anding with the pivot marker sets all x-stabiliser pivot columns to zero, leaving just the z part
-            z_only_pivots.push_back( integral_log_2( pauli->z_vector & pivot_marker) );
+            // Removing the pivot marker sets all x-stabiliser pivot columns to zero, leaving just the z part
+            z_only_pivots.push_back( integral_log_2( pauli->z_vector ^ (pauli->z_vector & pivot_marker) ) );
         }
     }
-}
\ No newline at end of file
+
+    template struct Basic_Check_Matrix<std::size_t>;
+    template struct Basic_Check_Matrix<F2_Vector>;
+}
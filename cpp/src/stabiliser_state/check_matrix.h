@@ -2,31 +2,40 @@
 #define _FAST_STABILISER_CHECK_MATRIX_H
 
 #include "pauli/pauli.h"
+#include "util/random.h"
 
 #include <vector>
 #include <complex>
+#include <span>
 #include <unordered_set>
 
 namespace fst
 {
-    struct Stabiliser_State;
+    template <f2_vector_like Bits>
+    struct Basic_Stabiliser_State;
 
     /// The class used to represent a list of n commuting paulis, an alternative representation
     /// of a stabiliser state
-    struct Check_Matrix
+    ///
+    /// As for Basic_Pauli, Bits is std::size_t (the Check_Matrix alias, up to 64 qubits) or
+    /// F2_Vector (the Wide_Check_Matrix alias, any number of qubits).
+    template <f2_vector_like Bits>
+    struct Basic_Check_Matrix
     {
+        using Pauli_Type = Basic_Pauli<Bits>;
+
         std::size_t number_qubits = 0;
         
         // Get the list of Stabilisers
-        const std::vector<Pauli>& get_paulis() const;
+        const std::vector<Pauli_Type>& get_paulis() const;
         // Set the list of Stabilisers
         // TODO : use std::forward to reduce overhead?
-        void set_paulis(std::vector<Pauli> paulis_);
+        void set_paulis(std::vector<Pauli_Type> paulis_);
         
         /// Paulis are sorted into 2 types: "z_only", which have no X component, and "x_stabilisers",
         /// which may have both an x and z component
-        const std::vector<Pauli *>& get_z_only_stabilisers() const;
-        const std::vector<Pauli *>& get_x_stabilisers() const;
+        const std::vector<Pauli_Type *>& get_z_only_stabilisers() const;
+        const std::vector<Pauli_Type *>& get_x_stabilisers() const;
 
         /// IF THE CHECK MATRIX IS ROW REDUCED, then this returns a list of the pivot columns of the "z_only"
         /// stabilisers (correspdonding to the order of the z_only_stabiliser list). The pivot column of a "z_only"
@@ -36,12 +45,45 @@ namespace fst
         
         bool row_reduced;
 
-        explicit Check_Matrix(const std::vector<Pauli> paulis, const bool row_reduced = false);
-        explicit Check_Matrix(Stabiliser_State &stabiliser_state);
+        explicit Basic_Check_Matrix(const std::vector<Pauli_Type> paulis, const bool row_reduced = false);
+        explicit Basic_Check_Matrix(Basic_Stabiliser_State<Bits> &stabiliser_state);
 
         /// Return the state vector of length 2^n stabilised by each of the Paulis in the check matrix
-        std::vector<std::complex<float>> get_state_vector();
+        std::vector<std::complex<float>> get_state_vector()
+            requires std::unsigned_integral<Bits>;
+
+        /// Writes the state vector stabilised by the check matrix into state_vector, which must have
+        /// length 2^n, in single or double precision. Throws std::invalid_argument if the length is wrong
+        void get_state_vector(std::span<std::complex<float>> state_vector)
+            requires std::unsigned_integral<Bits>;
+        void get_state_vector(std::span<std::complex<double>> state_vector)
+            requires std::unsigned_integral<Bits>;
+
+        /// Returns the 2^dim non-zero amplitudes of the state stabilised by the check matrix, as the pair
+        /// (indices, amplitudes), without touching anything of size 2^n. See Basic_Stabiliser_State
+        std::pair<std::vector<Bits>, std::vector<std::complex<float>>> get_sparse_state_vector()
+            requires std::unsigned_integral<Bits>;
         
+        /// Returns the expectation value of a Hermitian Pauli (+1 or -1 if it is, up to sign, in the stabiliser group
+        /// generated by the check matrix, and 0 otherwise), or of each of a list of them, in polynomial time. The list
+        /// shares one conversion to Basic_Stabiliser_State. See Basic_Stabiliser_State::get_expectation_value
+        int get_expectation_value(const Pauli_Type &pauli)
+            requires std::unsigned_integral<Bits>;
+        std::vector<int> get_expectation_values(std::span<const Pauli_Type> paulis)
+            requires std::unsigned_integral<Bits>;
+
+        /// Measures the Hermitian Pauli P, leaving the check matrix generating the stabiliser group of the state in
+        /// the (-1)^outcome eigenspace of P. If P anticommutes with a generator, the outcome is random: it is the given
+        /// outcome, the other anticommuting generators are multiplied by that one, and it is replaced by (-1)^outcome P,
+        /// in O(n^2) word operations. Otherwise the outcome is deterministic, and is found by writing +-P as a product
+        /// of the row reduced generators (row reducing first, if needed). Throws std::invalid_argument if P is not
+        /// Hermitian or the number of qubits differs
+        Measurement_Result measure(const Pauli_Type &pauli, const bool outcome);
+
+        /// Measures P as above, with a random outcome if it is not deterministic. One bit is drawn from generator
+        /// for every measurement, so a stream of measurements depends only on its seed
+        Measurement_Result measure(const Pauli_Type &pauli, Random_Generator &generator);
+
         /// Row reduce the check_matrix, giving a new set of paulis that generate the same stabiliser group.
         /// The new paulis have the x_vectors of the "x_stabiliser" paulis, and z_vectors of the "z_only" stabilisers
         /// in reduced row echelon form. Note that the collection of all the paulis' z_vectors may NOT be in reduced row
@@ -50,22 +92,22 @@ namespace fst
 
         private:
 
-        std::vector<Pauli> paulis;
-        std::vector<Pauli *> z_only_stabilisers;
-        std::vector<Pauli *> x_stabilisers;
+        std::vector<Pauli_Type> paulis;
+        std::vector<Pauli_Type *> z_only_stabilisers;
+        std::vector<Pauli_Type *> x_stabilisers;
         
         std::vector<size_t> z_only_pivots;
                 
         void categorise_paulis();
         
-        void add_z_only_stabilisers(const std::vector<std::size_t> &pivot_vectors, const std::unordered_set<std::size_t> &pivot_indices_set, const Stabiliser_State &state);
-		void add_x_stabilisers(const std::vector<std::size_t> &pivot_vectors, const Stabiliser_State &state);  
-
-        void row_reduce_x_stabilisers();
-        void row_reduce_z_only_stabilisers();
+        void add_z_only_stabilisers(const std::vector<Bits> &pivot_vectors, const std::unordered_set<std::size_t> &pivot_indices_set, const Basic_Stabiliser_State<Bits> &state);
+		void add_x_stabilisers(const std::vector<Bits> &pivot_vectors, const Basic_Stabiliser_State<Bits> &state);  
 
         void set_z_only_pivots();
     };
+
+    using Check_Matrix = Basic_Check_Matrix<std::size_t>;
+    using Wide_Check_Matrix = Basic_Check_Matrix<F2_Vector>;
 }
 
-#endif
\ No newline at end of file
+#endif
@@ -6,11 +6,17 @@
 #include <pybind11/stl.h>
 
 #include "check_matrix.h"
+#include "stabiliser_state.h"
+#include "util/f2_vector_pybind.h"
+#include "util/numpy_pybind.h"
+#include "util/random_pybind.h"
+
+#include <cstdint>
+#include <optional>
 
 namespace py = pybind11;
 using namespace fst;
 
-// TODO: Return numpy arrays rather than arrays. Eliminate copying by making types opaque?
 namespace fst_pybind
 {
     void init_check_matrix(py::module_ &m)
@@ -22,9 +28,59 @@ namespace fst_pybind
             .def("get_paulis", &Check_Matrix::get_paulis, "Gets the list[Pauli] of stabilisers for the stabiliser state")
             .def(py::init<const std::vector<Pauli>, const bool>(), py::arg("paulis"), py::arg("row_reduced") = false)
             .def(py::init<Stabiliser_State &>(), py::arg("stabiliser_state"))
-            .def("get_state_vector", &Check_Matrix::get_state_vector, "Returns the state vector of length 2^n stabilised by each of the Paulis in the check matrix")
+            .def("get_state_vector", [](Check_Matrix &check_matrix, const py::object &out)
+            {
+                return write_array({py::ssize_t(1) << check_matrix.number_qubits}, out, [&](const auto state_vector) { check_matrix.get_state_vector(state_vector); });
+            }, py::arg("out") = py::none(), "Returns the state vector of length 2^n stabilised by each of the Paulis in the check matrix, as a complex64 numpy array. If out (a C-contiguous complex64 or complex128 array of length 2^n) is given, the state vector is written into it instead, in that precision")
+            .def("get_sparse_state_vector", [](Check_Matrix &check_matrix)
+            {
+                return sparse_to_numpy([&] { return check_matrix.get_sparse_state_vector(); });
+            }, "Returns the non-zero amplitudes of the state stabilised by the check matrix as a tuple (indices, amplitudes) of a uint64 and a complex64 numpy array, with amplitudes[k] at indices[k]. The indices are not sorted")
+            .def("get_expectation_value", &Check_Matrix::get_expectation_value, py::arg("pauli"), "Returns the expectation value of a Hermitian Pauli on the state stabilised by the check matrix: +1 or -1 if it is, up to sign, in the stabiliser group, and 0 otherwise")
+            .def("get_expectation_values", [](Check_Matrix &check_matrix, const std::vector<Pauli> &paulis)
+            {
+                std::vector<int> values;
+                {
+                    py::gil_scoped_release release;
+                    values = check_matrix.get_expectation_values(paulis);
+                }
+
+                return to_numpy(std::move(values), {static_cast<py::ssize_t>(paulis.size())});
+            }, py::arg("paulis"), "Returns the expectation values of each of a list of Hermitian Paulis as an int numpy array, sharing one conversion of the check matrix and splitting the Paulis between threads")
+            .def("measure", [](Check_Matrix &check_matrix, const Pauli &pauli, const std::optional<bool> outcome, const std::optional<std::uint64_t> seed)
+            {
+                if (outcome)
+                {
+                    return check_matrix.measure(pauli, *outcome);
+                }
+
+                Random_Generator generator = make_generator(seed);
+
+                return check_matrix.measure(pauli, generator);
+            }, py::arg("pauli"), py::arg("outcome") = py::none(), py::arg("seed") = py::none(), "Measures a Hermitian Pauli P, leaving the state in the (-1)^outcome eigenspace of P, and returns a Measurement_Result. If P (up to sign) is in the stabiliser group the outcome is deterministic and the state is unchanged. Otherwise the outcome is the given one (post-selecting on it), or if outcome is None it is uniformly random, drawn from seed (or std::random_device if seed is None). Raises ValueError if P is not Hermitian or is on a different number of qubits. The check matrix is updated in place, and stays row reduced only if the outcome was deterministic")
             .def("row_reduce", &Check_Matrix::row_reduce, "Row reduces the check matrix, giving a new set of Paulis that generates the same stabiliser group.\n\nPaulis are sorted into 2 types: \"z_only\", which have no X component, and \"x_stabilisers\", which may have both an x and z component. After performing this function, the x_vectors of the new \"x_stabiliser\" Paulis and the z_vectors of the new \"z_only\" stabilisers are in reduced row echelon form. Note that the collection of all the Paulis' z_vectors may NOT be in reduced row echelon form")
             .doc() = "The class used to represent a list of n commuting Paulis, an alternative representation of a stabiliser state";
+
+        py::class_<Wide_Check_Matrix>(m, "Wide_Check_Matrix")
+            .def_readwrite("number_qubits", &Wide_Check_Matrix::number_qubits, "int\t\tThe number of qubits")
+            .def_readwrite("row_reduced", &Wide_Check_Matrix::row_reduced, "bool")
+            .def("set_paulis", &Wide_Check_Matrix::set_paulis, py::arg("paulis"), "Sets the list of stabilisers for the stabiliser state")
+            .def("get_paulis", &Wide_Check_Matrix::get_paulis, "Gets the list[Wide_Pauli] of stabilisers for the stabiliser state")
+            .def(py::init<const std::vector<Wide_Pauli>, const bool>(), py::arg("paulis"), py::arg("row_reduced") = false)
+            .def(py::init<Wide_Stabiliser_State &>(), py::arg("stabiliser_state"))
+            .def("measure", [](Wide_Check_Matrix &check_matrix, const Wide_Pauli &pauli, const std::optional<bool> outcome, const std::optional<std::uint64_t> seed)
+            {
+                if (outcome)
+                {
+                    return check_matrix.measure(pauli, *outcome);
+                }
+
+                Random_Generator generator = make_generator(seed);
+
+                return check_matrix.measure(pauli, generator);
+            }, py::arg("pauli"), py::arg("outcome") = py::none(), py::arg("seed") = py::none(), "Measures a Hermitian Wide_Pauli, as for Check_Matrix.measure")
+            .def("row_reduce", &Wide_Check_Matrix::row_reduce, "Row reduces the check matrix, as for Check_Matrix.row_reduce")
+            .doc() = "A check matrix on any number of qubits, as for Check_Matrix, with its stabilisers as Wide_Paulis. The methods building state vectors are only on Check_Matrix";
     }
 }
 
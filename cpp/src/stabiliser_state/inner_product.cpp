@@ -0,0 +1,224 @@
+#include "inner_product.h"
+#include "basis_coordinates.h"
+#include "phase_form.h"
+#include "util/f2_helper.h"
+#include "util/parallel.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <optional>
+#include <stdexcept>
+
+namespace
+{
+	using namespace fst;
+
+	/// Each thread gets at least this many entries of the upper triangle of a Gram matrix
+	constexpr std::size_t minimum_pairs_per_task = 64;
+
+	/// The intersection of the supports of two states, as the point with coefficients bra_offset in the basis
+	/// of bra and ket_offset in the basis of ket, plus the span of the vectors with coefficients bra_directions[k]
+	/// and ket_directions[k]
+	struct Intersection
+	{
+		std::size_t bra_offset;
+		std::size_t ket_offset;
+		std::vector<std::size_t> bra_directions;
+		std::vector<std::size_t> ket_directions;
+	};
+
+	std::size_t combine(const Stabiliser_State &state, const std::size_t coefficients)
+	{
+		std::size_t vector = 0;
+
+		for (std::size_t rest = coefficients; rest != 0; rest &= rest - 1)
+		{
+			vector ^= state.basis_vectors[std::countr_zero(rest)];
+		}
+
+		return vector;
+	}
+
+	std::optional<Intersection> intersect_supports(const Stabiliser_State &bra, const Stabiliser_State &ket)
+	{
+		const Basis_Coordinates<std::size_t> bra_coordinates(std::span<const std::size_t>(bra.basis_vectors.data(), bra.dim));
+
+		// Reducing by the span of bra's basis is linear, and zero exactly on that span, so the combinations of ket's
+		// basis with zero remainder are the intersection of the spans
+		std::vector<std::size_t> remainders(ket.dim);
+
+		for (std::size_t j = 0; j < ket.dim; j++)
+		{
+			remainders[j] = bra_coordinates.reduce(ket.basis_vectors[j]).first;
+		}
+
+		const Basis_Coordinates<std::size_t> remainder_coordinates(remainders);
+		const std::optional<std::size_t> ket_offset = remainder_coordinates.get_coefficients(bra_coordinates.reduce(bra.shift ^ ket.shift).first);
+
+		if (!ket_offset)
+		{
+			return std::nullopt;
+		}
+
+		const std::size_t point = ket.shift ^ combine(ket, *ket_offset);
+		Intersection intersection {*bra_coordinates.get_coefficients(point ^ bra.shift), *ket_offset, {}, {}};
+
+		for (const std::size_t dependency : remainder_coordinates.get_dependencies())
+		{
+			intersection.bra_directions.push_back(*bra_coordinates.get_coefficients(combine(ket, dependency)));
+			intersection.ket_directions.push_back(dependency);
+		}
+
+		return intersection;
+	}
+
+	/// Adds the phase exponent of state (negated if conjugate) at the coefficients offset ^ (sum of t_k directions[k])
+	/// to the form, so that i^q(t) picks up the phase of the state at each point of the intersection
+	void add_phase_exponent(Phase_Form &form, const Stabiliser_State &state, const std::size_t offset, std::span<const std::size_t> directions, const bool conjugate)
+	{
+		// The sign exponent G is an F_2 valued quadratic form, with G(u + v) = G(u) + G(v) + B(u, v) for the bilinear
+		// form B(u, v) = u.(quadratic_form v), so composed with the affine map it is again a quadratic form. It is
+		// unchanged by conjugation, as -2 = 2 in Z_4
+		const auto sign = [&](const std::size_t coefficients)
+		{
+			return state.get_phase_exponent(coefficients) >> 1;
+		};
+
+		const auto bilinear_row = [&](const std::size_t coefficients)
+		{
+			std::size_t row = 0;
+
+			for (std::size_t rest = coefficients; rest != 0; rest &= rest - 1)
+			{
+				row ^= state.quadratic_form[std::countr_zero(rest)];
+			}
+
+			return row;
+		};
+
+		form.constant += 2 * sign(offset);
+
+		const std::size_t offset_row = bilinear_row(offset);
+		std::size_t imaginary_mask = 0;
+
+		for (std::size_t k = 0; k < directions.size(); k++)
+		{
+			const std::size_t row = bilinear_row(directions[k]);
+
+			form.linear[k] += 2 * (sign(directions[k]) ^ f2_dot_product(offset_row, directions[k]));
+
+			for (std::size_t j = 0; j < k; j++)
+			{
+				if (f2_dot_product(row, directions[j]))
+				{
+					form.flip_quadratic_form(j, k);
+				}
+			}
+
+			if (f2_dot_product(state.imaginary_part, directions[k]))
+			{
+				imaginary_mask |= integral_pow_2(k);
+			}
+		}
+
+		form.add_parity_term(conjugate ? 3 : 1, imaginary_mask, f2_dot_product(state.imaginary_part, offset));
+	}
+
+	std::complex<double> inner_product_double(const Stabiliser_State &bra, const Stabiliser_State &ket)
+	{
+		if (bra.number_qubits != ket.number_qubits)
+		{
+			throw std::invalid_argument("The states must be on the same number of qubits");
+		}
+
+		bra.check_dimensions();
+		ket.check_dimensions();
+
+		const std::optional<Intersection> intersection = intersect_supports(bra, ket);
+
+		if (!intersection)
+		{
+			return 0;
+		}
+
+		Phase_Form form(intersection->ket_directions.size());
+		add_phase_exponent(form, bra, intersection->bra_offset, intersection->bra_directions, true);
+		add_phase_exponent(form, ket, intersection->ket_offset, intersection->ket_directions, false);
+
+		// Each amplitude has magnitude 1 / sqrt(2^dim)
+		const int scale = -static_cast<int>(bra.dim + ket.dim);
+
+		return std::conj(std::complex<double>(bra.global_phase)) * std::complex<double>(ket.global_phase) * form.evaluate_sum(scale);
+	}
+
+	template <std::floating_point Scalar>
+	void write_gram_matrix(std::span<const Stabiliser_State> states, std::span<std::complex<Scalar>> matrix)
+	{
+		const std::size_t number_states = states.size();
+
+		if (matrix.size() != number_states * number_states)
+		{
+			throw std::invalid_argument("The Gram matrix must have length states.size()^2");
+		}
+
+		const std::size_t number_pairs = number_states * (number_states + 1) / 2;
+		const std::size_t number_tasks = std::min({get_number_threads(), number_states, (number_pairs + minimum_pairs_per_task - 1) / minimum_pairs_per_task});
+
+		parallel_for(number_tasks, [&](const std::size_t task)
+		{
+			// Row j has number_states - j entries in the upper triangle, so interleaving the rows balances the tasks
+			for (std::size_t j = task; j < number_states; j += number_tasks)
+			{
+				for (std::size_t k = j; k < number_states; k++)
+				{
+					const std::complex<double> product = inner_product_double(states[j], states[k]);
+
+					matrix[j * number_states + k] = std::complex<Scalar>(product);
+					matrix[k * number_states + j] = std::complex<Scalar>(std::conj(product));
+				}
+			}
+		});
+	}
+}
+
+namespace fst
+{
+	std::complex<float> inner_product(const Stabiliser_State &bra, const Stabiliser_State &ket)
+	{
+		return std::complex<float>(inner_product_double(bra, ket));
+	}
+
+	std::complex<float> inner_product(Check_Matrix &bra, Check_Matrix &ket)
+	{
+		return inner_product(Stabiliser_State(bra), Stabiliser_State(ket));
+	}
+
+	float fidelity(const Stabiliser_State &a, const Stabiliser_State &b)
+	{
+		return static_cast<float>(std::norm(inner_product_double(a, b)));
+	}
+
+	float fidelity(Check_Matrix &a, Check_Matrix &b)
+	{
+		return fidelity(Stabiliser_State(a), Stabiliser_State(b));
+	}
+
+	std::vector<std::complex<float>> gram_matrix(std::span<const Stabiliser_State> states)
+	{
+		std::vector<std::complex<float>> matrix(states.size() * states.size());
+		write_gram_matrix(states, std::span<std::complex<float>>(matrix));
+
+		return matrix;
+	}
+
+	void gram_matrix(std::span<const Stabiliser_State> states, std::span<std::complex<float>> matrix)
+	{
+		write_gram_matrix(states, matrix);
+	}
+
+	void gram_matrix(std::span<const Stabiliser_State> states, std::span<std::complex<double>> matrix)
+	{
+		write_gram_matrix(states, matrix);
+	}
+}
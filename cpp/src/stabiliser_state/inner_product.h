@@ -0,0 +1,42 @@
+#ifndef _FAST_STABILISER_INNER_PRODUCT_H
+#define _FAST_STABILISER_INNER_PRODUCT_H
+
+#include <complex>
+#include <span>
+#include <vector>
+
+#include "stabiliser_state.h"
+#include "check_matrix.h"
+
+namespace fst
+{
+	/// Returns the inner product <bra|ket> of two stabiliser states on the same number of qubits, including
+	/// their global phases, without building either state vector.
+	///
+	/// The supports are intersected as affine spaces, and the product of the conjugated amplitudes of bra and
+	/// the amplitudes of ket over the intersection is a sum of i^q(t) for a Z_4 valued quadratic form q. The
+	/// sum is evaluated by eliminating the variables of q one or two at a time, so this takes O(d^3) word
+	/// operations for states of dimension d.
+	///
+	/// Throws std::invalid_argument if the numbers of qubits differ
+	std::complex<float> inner_product(const Stabiliser_State &bra, const Stabiliser_State &ket);
+
+	/// As above, for the states of two check matrices, which are row reduced in place. The global phases
+	/// are those given by Stabiliser_State(check_matrix), so only the magnitude is independent of convention
+	std::complex<float> inner_product(Check_Matrix &bra, Check_Matrix &ket);
+
+	/// Returns the fidelity |<a|b>|^2 of two stabiliser states (or the states of two check matrices)
+	float fidelity(const Stabiliser_State &a, const Stabiliser_State &b);
+	float fidelity(Check_Matrix &a, Check_Matrix &b);
+
+	/// Returns the Gram matrix of the states, in row-major order, with <states[j]|states[k]> in row j and
+	/// column k. Only the upper triangle is computed, and the rows are split between threads with parallel_for
+	std::vector<std::complex<float>> gram_matrix(std::span<const Stabiliser_State> states);
+
+	/// Writes the Gram matrix as above into matrix, which must have length states.size()^2, in single or
+	/// double precision. Throws std::invalid_argument if the length is wrong
+	void gram_matrix(std::span<const Stabiliser_State> states, std::span<std::complex<float>> matrix);
+	void gram_matrix(std::span<const Stabiliser_State> states, std::span<std::complex<double>> matrix);
+}
+
+#endif
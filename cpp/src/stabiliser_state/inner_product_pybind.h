@@ -0,0 +1,35 @@
+#ifndef _FAST_STABILISER_INNER_PRODUCT_PYBIND_H
+#define _FAST_STABILISER_INNER_PRODUCT_PYBIND_H
+
+#include <pybind11/pybind11.h>
+#include <pybind11/complex.h>
+#include <pybind11/stl.h>
+
+#include "inner_product.h"
+#include "util/numpy_pybind.h"
+
+namespace py = pybind11;
+using namespace fst;
+
+namespace fst_pybind
+{
+    void init_inner_product(py::module_ &m)
+    {
+        m.def("inner_product", py::overload_cast<const Stabiliser_State &, const Stabiliser_State &>(&inner_product), py::arg("bra"), py::arg("ket"), "Returns the inner product <bra|ket> of two stabiliser states on the same number of qubits, including their global phases, in polynomial time (without building either state vector)");
+        m.def("inner_product", py::overload_cast<Check_Matrix &, Check_Matrix &>(&inner_product), py::arg("bra"), py::arg("ket"), "Returns the inner product <bra|ket> of the states of two check matrices, which are row reduced in place. The global phases are those of Stabiliser_State(check_matrix)");
+        m.def("fidelity", py::overload_cast<const Stabiliser_State &, const Stabiliser_State &>(&fidelity), py::arg("a"), py::arg("b"), "Returns the fidelity |<a|b>|^2 of two stabiliser states, in polynomial time");
+        m.def("fidelity", py::overload_cast<Check_Matrix &, Check_Matrix &>(&fidelity), py::arg("a"), py::arg("b"), "Returns the fidelity |<a|b>|^2 of the states of two check matrices, which are row reduced in place");
+        m.def("gram_matrix", [](const std::vector<Stabiliser_State> &states, const py::object &out)
+        {
+            const py::ssize_t number_states = static_cast<py::ssize_t>(states.size());
+
+            return write_array({number_states, number_states}, out, [&](const auto matrix)
+            {
+                py::gil_scoped_release release;
+                gram_matrix(states, matrix);
+            });
+        }, py::arg("states"), py::arg("out") = py::none(), "Returns the Gram matrix of a list of stabiliser states, with <states[j]|states[k]> in row j and column k, as a complex64 numpy array, splitting the rows between threads. If out (a C-contiguous complex64 or complex128 array of shape (len(states), len(states))) is given, the matrix is written into it instead, in that precision");
+    }
+}
+
+#endif
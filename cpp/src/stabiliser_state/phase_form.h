@@ -0,0 +1,234 @@
+#ifndef _FAST_STABILISER_PHASE_FORM_H
+#define _FAST_STABILISER_PHASE_FORM_H
+
+#include "stabiliser_state.h"
+#include "util/f2_helper.h"
+
+#include <array>
+#include <bit>
+#include <cmath>
+#include <complex>
+#include <cstddef>
+#include <numbers>
+#include <vector>
+
+namespace fst
+{
+	/// The powers of omega = e^(i pi / 4): omega^k is powers_of_omega[k] for k in Z_8
+	inline constexpr std::array<std::complex<double>, 8> powers_of_omega {{ {1, 0}, {std::numbers::sqrt2 / 2, std::numbers::sqrt2 / 2},
+		{0, 1}, {-std::numbers::sqrt2 / 2, std::numbers::sqrt2 / 2}, {-1, 0}, {-std::numbers::sqrt2 / 2, -std::numbers::sqrt2 / 2},
+		{0, -1}, {std::numbers::sqrt2 / 2, -std::numbers::sqrt2 / 2} }};
+
+	/// A Z_4 valued quadratic form on F_2^d (d at most 64)
+	///     q(t) = constant + sum_k linear[k] t_k + 2 sum_{j < k} Q(e_j, e_k) t_j t_k
+	/// where Q(e_j, e_k) is bit k of quadratic_form[j], stored symmetric with a zero diagonal as in
+	/// Basic_Stabiliser_State. The amplitude of a stabiliser state at the coefficients t is a constant
+	/// times i^q(t), and changes to the state (restricting or extending the support, or multiplying by a
+	/// phase) are substitutions into q.
+	struct Phase_Form
+	{
+		unsigned int constant = 0;
+		std::vector<unsigned int> linear;
+		std::vector<std::size_t> quadratic_form;
+
+		explicit Phase_Form(const std::size_t number_variables)
+			: linear(number_variables), quadratic_form(number_variables)
+		{
+		}
+
+		/// Flips Q(e_j, e_k) (and so Q(e_k, e_j)) for j != k
+		void flip_quadratic_form(const std::size_t j, const std::size_t k)
+		{
+			quadratic_form[j] ^= integral_pow_2(k);
+			quadratic_form[k] ^= integral_pow_2(j);
+		}
+
+		/// Adds a * y to q, where y in {0, 1} is the parity of constant_bit and the t_k with k in mask
+		void add_parity_term(const unsigned int a, const std::size_t mask, const bool constant_bit)
+		{
+			constant += a * constant_bit;
+
+			if (a % 2 == 0)
+			{
+				// (-1)^y is linear in t
+				for (std::size_t rest = mask; rest != 0; rest &= rest - 1)
+				{
+					linear[std::countr_zero(rest)] += a;
+				}
+
+				return;
+			}
+
+			// For the integer x = constant_bit + sum_{k in mask} t_k, y = x mod 2 and i^y = i^x (-1)^(x choose 2),
+			// where (x choose 2) mod 2 is the parity of the products of pairs of terms of x. As a is odd, i^(a y)
+			// is i^(a x) times the same sign
+			for (std::size_t rest = mask; rest != 0; rest &= rest - 1)
+			{
+				const std::size_t k = std::countr_zero(rest);
+
+				linear[k] += a + 2 * constant_bit;
+				quadratic_form[k] ^= mask ^ integral_pow_2(k);
+			}
+		}
+
+		/// Substitutes t_j = constant_bit + sum_{k in mask} t_k, for a mask without j, into q, leaving no terms in t_j
+		void substitute(const std::size_t j, const std::size_t mask, const bool constant_bit)
+		{
+			const std::size_t neighbours = quadratic_form[j];
+
+			// Each 2 t_j t_m becomes 2 t_m (constant_bit + sum_{k in mask} t_k), with t_m t_m = t_m
+			for (std::size_t rest = neighbours; rest != 0; rest &= rest - 1)
+			{
+				const std::size_t m = std::countr_zero(rest);
+
+				linear[m] += 2 * (constant_bit ^ bit_set_at(mask, m));
+				quadratic_form[m] ^= mask ^ integral_pow_2(j);
+			}
+
+			for (std::size_t rest = mask; rest != 0; rest &= rest - 1)
+			{
+				quadratic_form[std::countr_zero(rest)] ^= neighbours;
+			}
+
+			add_parity_term(linear[j] % 4, mask, constant_bit);
+
+			linear[j] = 0;
+			quadratic_form[j] = 0;
+		}
+
+		/// Adds a variable t_d with no terms, and returns d
+		std::size_t add_variable()
+		{
+			linear.push_back(0);
+			quadratic_form.push_back(0);
+
+			return linear.size() - 1;
+		}
+
+		/// Removes the variable t_j, which must have no terms, renumbering the ones after it
+		void remove_variable(const std::size_t j)
+		{
+			const std::size_t low_bits = integral_pow_2(j) - 1;
+
+			linear.erase(linear.begin() + j);
+			quadratic_form.erase(quadratic_form.begin() + j);
+
+			for (std::size_t &row : quadratic_form)
+			{
+				row = (row & low_bits) | ((row >> 1) & ~low_bits);
+			}
+		}
+
+		/// Returns q(t) mod 4, in O(d) word operations
+		unsigned int evaluate(const std::size_t t) const
+		{
+			unsigned int value = constant;
+
+			for (std::size_t rest = t; rest != 0; rest &= rest - 1)
+			{
+				const std::size_t k = std::countr_zero(rest);
+				value += linear[k] + 2 * f2_dot_product(quadratic_form[k], t & (integral_pow_2(k) - 1));
+			}
+
+			return value % 4;
+		}
+
+		/// Returns sqrt(2)^scale times the sum of i^q(t) over t in F_2^d. The variables are summed out one at a
+		/// time, each either leaving a form in the others or fixing another variable to a parity of the rest,
+		/// which is substituted in, so this takes O(d^3) word operations. The form is left unspecified
+		std::complex<double> evaluate_sum(const int scale)
+		{
+			// The sum is i^constant omega^eighth_root sqrt(2)^half_powers, for omega = e^(i pi / 4)
+			unsigned int eighth_root = 0;
+			int half_powers = scale;
+			std::size_t remaining = linear.size() == 64 ? ~std::size_t(0) : integral_pow_2(linear.size()) - 1;
+
+			while (remaining != 0)
+			{
+				const std::size_t k = std::countr_zero(remaining);
+				remaining ^= integral_pow_2(k);
+
+				const unsigned int a = linear[k] % 4;
+				const std::size_t neighbours = quadratic_form[k] & remaining;
+
+				if (a % 2 == 1)
+				{
+					// Summing over t_k gives 1 + i^a (-1)^y = (1 + i^a) i^(-a y), for y the parity of the neighbours,
+					// and 1 + i^a is sqrt(2) omega^(+-1)
+					eighth_root += a == 1 ? 1 : 7;
+					half_powers += 1;
+					add_parity_term(4 - a, neighbours, false);
+				}
+				else if (neighbours == 0)
+				{
+					// Summing over t_k gives 1 + (-1)^(a / 2)
+					if (a == 2)
+					{
+						return 0;
+					}
+
+					half_powers += 2;
+				}
+				else
+				{
+					// Summing over t_k gives 1 + (-1)^(a / 2 + y), which is 2 when y = a / 2 and 0 otherwise. So for
+					// a neighbour j, t_j becomes the parity of a / 2 and the other neighbours. Terms in the variables
+					// already summed out are left in the form, but never read
+					const std::size_t j = std::countr_zero(neighbours);
+					remaining ^= integral_pow_2(j);
+					half_powers += 2;
+
+					substitute(j, neighbours ^ integral_pow_2(j), a == 2);
+				}
+			}
+
+			const double magnitude = std::ldexp(half_powers & 1 ? std::numbers::sqrt2 : 1.0, (half_powers - (half_powers & 1)) / 2);
+
+			return magnitude * powers_of_omega[(2 * constant + eighth_root) % 8];
+		}
+	};
+
+	/// Returns the phase exponent of the state as a Phase_Form in the coefficients t of the basis. The imaginary part
+	/// (imaginary_part.t mod 2) is the sum of its t_k, less twice the sum of its pairs t_j t_k
+	template <std::unsigned_integral Bits>
+	Phase_Form get_phase_form(const Basic_Stabiliser_State<Bits> &state)
+	{
+		state.check_dimensions();
+
+		Phase_Form form(state.dim);
+
+		for (std::size_t k = 0; k < state.dim; k++)
+		{
+			form.linear[k] = 2 * bit_set_at(state.real_linear_part, k) + bit_set_at(state.imaginary_part, k);
+			form.quadratic_form[k] = state.quadratic_form[k] ^ (bit_set_at(state.imaginary_part, k) ? state.imaginary_part ^ integral_pow_2(k) : 0);
+		}
+
+		return form;
+	}
+
+	/// Sets the linear parts and quadratic form of the state from a Phase_Form in the coefficients of its basis,
+	/// inverting get_phase_form, and multiplies the global phase by i^constant
+	template <std::unsigned_integral Bits>
+	void set_phase_form(Basic_Stabiliser_State<Bits> &state, const Phase_Form &form)
+	{
+		state.real_linear_part = 0;
+		state.imaginary_part = 0;
+
+		for (std::size_t k = 0; k < state.dim; k++)
+		{
+			state.real_linear_part |= Bits((form.linear[k] >> 1) & 1) << k;
+			state.imaginary_part |= Bits(form.linear[k] & 1) << k;
+		}
+
+		state.quadratic_form.resize(state.dim);
+
+		for (std::size_t k = 0; k < state.dim; k++)
+		{
+			state.quadratic_form[k] = form.quadratic_form[k] ^ (bit_set_at(state.imaginary_part, k) ? state.imaginary_part ^ integral_pow_2(k) : 0);
+		}
+
+		state.global_phase = scaled_powers_of_i(state.global_phase)[form.constant % 4];
+	}
+}
+
+#endif
@@ -0,0 +1,82 @@
+#include "sampler.h"
+
+#include "util/f2_helper.h"
+#include "util/parallel.h"
+#include "util/random.h"
+
+#include <algorithm>
+#include <array>
+#include <vector>
+
+using namespace fst;
+
+namespace
+{
+	/// Each chunk of this many shots has its own random stream
+	constexpr std::size_t chunk_size = std::size_t(1) << 14;
+
+	constexpr std::size_t group_bits = 8;
+	constexpr std::size_t group_size = std::size_t(1) << group_bits;
+
+	/// Returns the tables of the combinations of each group of 8 basis vectors: entry u of table g is the sum of
+	/// basis_vectors[8g + k] over the bits k of u. The last group is padded with zero vectors, so every 8 bit index
+	/// is a uniform choice of combination
+	std::vector<std::array<std::size_t, group_size>> get_combination_tables(const Stabiliser_State &state)
+	{
+		std::vector<std::array<std::size_t, group_size>> tables((state.dim + group_bits - 1) / group_bits);
+
+		for (std::size_t g = 0; g < tables.size(); g++)
+		{
+			tables[g][0] = 0;
+
+			// Each entry adds its highest basis vector to an earlier entry
+			for (std::size_t u = 1; u < group_size; u++)
+			{
+				const std::size_t k = integral_log_2(u);
+				const std::size_t j = g * group_bits + k;
+
+				tables[g][u] = tables[g][u ^ integral_pow_2(k)] ^ (j < state.dim ? state.basis_vectors[j] : 0);
+			}
+		}
+
+		return tables;
+	}
+}
+
+namespace fst
+{
+	void write_samples(const Stabiliser_State &state, std::span<std::size_t> shots, const std::uint64_t seed)
+	{
+		state.check_dimensions();
+
+		const auto tables = get_combination_tables(state);
+		const std::size_t number_chunks = (shots.size() + chunk_size - 1) / chunk_size;
+		const std::size_t number_tasks = std::min(get_number_threads(), number_chunks);
+
+		parallel_for(number_tasks, [&](const std::size_t task)
+		{
+			const std::size_t last_chunk = (task + 1) * number_chunks / number_tasks;
+
+			for (std::size_t chunk = task * number_chunks / number_tasks; chunk < last_chunk; chunk++)
+			{
+				Random_Generator generator(seed, chunk);
+				const std::size_t last_shot = std::min(shots.size(), (chunk + 1) * chunk_size);
+
+				for (std::size_t shot = chunk * chunk_size; shot < last_shot; shot++)
+				{
+					// Only the low dim bits are used, one per table entry
+					std::uint64_t coefficients = generator();
+					std::size_t outcome = state.shift;
+
+					for (const auto &table : tables)
+					{
+						outcome ^= table[coefficients % group_size];
+						coefficients >>= group_bits;
+					}
+
+					shots[shot] = outcome;
+				}
+			}
+		});
+	}
+}
@@ -0,0 +1,22 @@
+#ifndef _FAST_STABILISER_SAMPLER_H
+#define _FAST_STABILISER_SAMPLER_H
+
+#include "stabiliser_state.h"
+
+#include <cstdint>
+#include <span>
+
+namespace fst
+{
+	/// Writes computational basis measurement outcomes of the stabiliser state into shots, one bit-packed
+	/// outcome (bit q for qubit q) per entry. The outcomes are uniform on the affine support, so each is the
+	/// shift plus a combination of the basis vectors given by dim random bits.
+	///
+	/// The combinations are looked up 8 basis vectors at a time, in tables of the 256 combinations of each
+	/// group (at most 16KB, so they stay in L1 cache), taking one random word and dim / 8 loads per shot.
+	/// The shots are split into fixed-size chunks, each with its own Random_Generator stream, and the chunks
+	/// are split between threads with parallel_for, so the output depends only on the seed
+	void write_samples(const Stabiliser_State &state, std::span<std::size_t> shots, const std::uint64_t seed);
+}
+
+#endif
@@ -1,24 +1,204 @@
 #include "stabiliser_state.h"
 #include "check_matrix.h"
+#include "amplitude_writer.h"
+#include "basis_coordinates.h"
+#include "phase_form.h"
+#include "sampler.h"
 #include "util/f2_helper.h"
+#include "util/f2_vector.h"
+#include "util/f2_matrix.h"
+#include "util/parallel.h"
 #include "pauli/pauli.h"
 
+#include <algorithm>
+#include <bit>
 #include <cmath>
+#include <iterator>
+#include <limits>
+#include <numeric>
+#include <optional>
+#include <stdexcept>
 // #include <iostream>
 
+namespace
+{
+	using namespace fst;
+
+	template <std::floating_point Scalar, std::unsigned_integral Bits>
+	void write_sparse_state_vector(const Basic_Stabiliser_State<Bits> &state, std::span<Bits> indices, std::span<std::complex<Scalar>> amplitudes)
+	{
+		state.check_dimensions();
+
+		const std::size_t support_size = integral_pow_2(state.dim);
+
+		if (indices.size() != support_size || amplitudes.size() != support_size)
+		{
+			throw std::invalid_argument("The outputs for the sparse state vector must have length 2^dim");
+		}
+
+		const auto phases = scaled_powers_of_i(std::complex<Scalar>(state.global_phase) / std::sqrt(Scalar(support_size)));
+		std::size_t position = 0;
+
+		state.for_each_amplitude([&](const Bits index, const unsigned int phase_exponent)
+		{
+			indices[position] = index;
+			amplitudes[position] = phases[phase_exponent];
+			position++;
+
+			return true;
+		});
+	}
+
+	/// Each thread gets at least this many basis states of a get_amplitudes call
+	constexpr std::size_t minimum_amplitudes_per_task = std::size_t(1) << 14;
+
+	/// Each thread gets at least this many Paulis of a get_expectation_values call
+	constexpr std::size_t minimum_paulis_per_task = std::size_t(1) << 12;
+
+	/// How P = phase X^x Z^z acts on the state. For x = sum_j a_j basis_vectors[j], and c the coefficients of a point of
+	/// the support, (P psi)(shift ^ Bc) = phase (-1)^(z.(shift ^ x ^ Bc)) psi(shift ^ B(c ^ a)). Writing out the phase
+	/// exponents, (P psi)(c) = i^exponent (-1)^(linear_form.c) psi(c). Without coefficients, x is not in the span of
+	/// the basis, so P moves the support off itself
+	template <std::unsigned_integral Bits>
+	struct Pauli_Action
+	{
+		std::optional<std::size_t> coefficients;
+		Bits linear_form = 0;
+		unsigned int exponent = 0;
+	};
+
+	template <std::unsigned_integral Bits>
+	Pauli_Action<Bits> get_pauli_action(const Basic_Stabiliser_State<Bits> &state, const Basis_Coordinates<Bits> &coordinates, const Basic_Pauli<Bits> &pauli)
+	{
+		if (pauli.number_qubits != state.number_qubits)
+		{
+			throw std::invalid_argument("The Pauli must be on the same number of qubits as the state");
+		}
+
+		if (!pauli.is_hermitian())
+		{
+			throw std::invalid_argument("The Pauli must be Hermitian to have a real expectation value");
+		}
+
+		Pauli_Action<Bits> action {coordinates.get_coefficients(pauli.x_vector)};
+
+		if (!action.coefficients)
+		{
+			return action;
+		}
+
+		// The phase exponent at c ^ a less the one at c is that at a, plus twice the bilinear form of the quadratic
+		// form in a and c, and (if the one at a is odd) twice the imaginary part at c
+		const unsigned int phase_exponent = state.get_phase_exponent(*action.coefficients);
+		action.linear_form = phase_exponent % 2 ? state.imaginary_part : 0;
+
+		for (std::size_t j = 0; j < state.dim; j++)
+		{
+			action.linear_form ^= Bits(f2_dot_product(state.quadratic_form[j], Bits(*action.coefficients)) ^ f2_dot_product(pauli.z_vector, state.basis_vectors[j])) << j;
+		}
+
+		action.exponent = (pauli.get_phase_exponent() + phase_exponent + 2 * f2_dot_product(pauli.z_vector, state.shift ^ pauli.x_vector)) % 4;
+
+		return action;
+	}
+
+	/// <psi|P|psi> is the sum over c of |psi(c)|^2 i^exponent (-1)^(linear_form.c), so is zero unless the linear form is
+	template <std::unsigned_integral Bits>
+	int expectation_value(const Basic_Stabiliser_State<Bits> &state, const Basis_Coordinates<Bits> &coordinates, const Basic_Pauli<Bits> &pauli)
+	{
+		const Pauli_Action<Bits> action = get_pauli_action(state, coordinates, pauli);
+
+		if (!action.coefficients || action.linear_form != 0)
+		{
+			return 0;
+		}
+
+		return action.exponent == 0 ? 1 : -1;
+	}
+
+	template <std::unsigned_integral Bits>
+	void write_expectation_values(const Basic_Stabiliser_State<Bits> &state, std::span<const Basic_Pauli<Bits>> paulis, std::span<int> values)
+	{
+		state.check_dimensions();
+
+		if (paulis.size() != values.size())
+		{
+			throw std::invalid_argument("There must be one output value per Pauli");
+		}
+
+		const Basis_Coordinates<Bits> coordinates(std::span<const Bits>(state.basis_vectors.data(), state.dim));
+		const std::size_t number_tasks = std::min(get_number_threads(), (paulis.size() + minimum_paulis_per_task - 1) / minimum_paulis_per_task);
+
+		parallel_for(number_tasks, [&](const std::size_t task)
+		{
+			const std::size_t last = (task + 1) * paulis.size() / number_tasks;
+
+			for (std::size_t k = task * paulis.size() / number_tasks; k < last; k++)
+			{
+				values[k] = expectation_value(state, coordinates, paulis[k]);
+			}
+		});
+	}
+
+	/// Returns the bits of x in mask, packed into the low bits in order
+	template <std::unsigned_integral Bits>
+	Bits compress_bits(const Bits x, const Bits mask)
+	{
+		Bits compressed = 0;
+		std::size_t k = 0;
+
+		for (Bits rest = mask; rest != 0; rest &= rest - 1, k++)
+		{
+			compressed |= Bits(bit_set_at(x, std::size_t(std::countr_zero(rest)))) << k;
+		}
+
+		return compressed;
+	}
+
+	template <std::floating_point Scalar, std::unsigned_integral Bits>
+	void write_amplitudes(const Basic_Stabiliser_State<Bits> &state, std::span<const Bits> xs, std::span<std::complex<Scalar>> amplitudes)
+	{
+		state.check_dimensions();
+
+		if (xs.size() != amplitudes.size())
+		{
+			throw std::invalid_argument("There must be one output amplitude per basis state");
+		}
+
+		const Basis_Coordinates<Bits> coordinates(std::span<const Bits>(state.basis_vectors.data(), state.dim));
+		const auto phases = scaled_powers_of_i(std::complex<Scalar>(state.global_phase) / std::sqrt(Scalar(integral_pow_2(state.dim))));
+
+		const std::size_t number_tasks = std::min(get_number_threads(), (xs.size() + minimum_amplitudes_per_task - 1) / minimum_amplitudes_per_task);
+
+		parallel_for(number_tasks, [&](const std::size_t task)
+		{
+			const std::size_t last = (task + 1) * xs.size() / number_tasks;
+
+			for (std::size_t k = task * xs.size() / number_tasks; k < last; k++)
+			{
+				const std::optional<std::size_t> coefficients = coordinates.get_coefficients(xs[k] ^ state.shift);
+				amplitudes[k] = coefficients ? phases[state.get_phase_exponent(*coefficients)] : std::complex<Scalar>(0);
+			}
+		});
+	}
+}
+
 namespace fst
 {
-	Stabiliser_State::Stabiliser_State(const std::size_t number_qubits, const std::size_t dim)
-		: number_qubits(number_qubits), dim(dim)
+	template <f2_vector_like Bits>
+	Basic_Stabiliser_State<Bits>::Basic_Stabiliser_State(const std::size_t number_qubits, const std::size_t dim)
+		: number_qubits(number_qubits), dim(dim), quadratic_form(dim)
 	{
 	}
 
-	Stabiliser_State::Stabiliser_State(const std::size_t number_qubits)
-		: Stabiliser_State(number_qubits, number_qubits)
+	template <f2_vector_like Bits>
+	Basic_Stabiliser_State<Bits>::Basic_Stabiliser_State(const std::size_t number_qubits)
+		: Basic_Stabiliser_State(number_qubits, number_qubits)
 	{
 	}
 
-	Stabiliser_State::Stabiliser_State(Check_Matrix &check_matrix)
+	template <f2_vector_like Bits>
+	Basic_Stabiliser_State<Bits>::Basic_Stabiliser_State(Basic_Check_Matrix<Bits> &check_matrix)
 	{
 		number_qubits = check_matrix.number_qubits;
 
@@ -31,7 +211,8 @@ namespace fst
 		row_reduced = true;
 	}
 
-	void Stabiliser_State::set_support_from_cm(const Check_Matrix &check_matrix)
+	template <f2_vector_like Bits>
+	void Basic_Stabiliser_State<Bits>::set_support_from_cm(const Basic_Check_Matrix<Bits> &check_matrix)
 	{
 		// std::cout << "dim of V is " << dim << "\n";
 		basis_vectors.reserve(dim);
@@ -41,115 +222,518 @@ namespace fst
             basis_vectors.push_back(pauli->x_vector);
         }
 
-		shift = 0;
+		shift = Bits{};
 
 		for (std::size_t i = 0; i < number_qubits - dim; i++)
 		{
-			shift |= integral_pow_2( check_matrix.get_z_only_pivots()[i] ) * (check_matrix.get_z_only_stabilisers()[i]->sign_bit);
+			if (check_matrix.get_z_only_stabilisers()[i]->sign_bit)
+			{
+				shift |= unit_vector<Bits>( check_matrix.get_z_only_pivots()[i] );
+			}
 		}
 	}
 
-	void Stabiliser_State::set_linear_and_quadratic_forms_from_cm(const Check_Matrix &check_matrix)
+	template <f2_vector_like Bits>
+	void Basic_Stabiliser_State<Bits>::set_linear_and_quadratic_forms_from_cm(const Basic_Check_Matrix<Bits> &check_matrix)
 	{
-		quadratic_form.reserve(dim*(dim+1)/2 + 1);
-		quadratic_form[0] = 0;
+		quadratic_form.assign(dim, Bits{});
 
 		for (std::size_t j = 0; j < dim; j++)
         {
-            std::size_t v_j = basis_vectors[j];
-            Pauli *p_j = check_matrix.get_x_stabilisers()[j];
-            std::size_t beta_j = p_j->z_vector;
+            const Bits &v_j = basis_vectors[j];
+            const Basic_Pauli<Bits> *p_j = check_matrix.get_x_stabilisers()[j];
+            const Bits &beta_j = p_j->z_vector;
             std::size_t imag_bit = p_j->imag_bit;
 
-            imaginary_part |= integral_pow_2(j) * imag_bit;
-            real_linear_part |= integral_pow_2(j) * (p_j->sign_bit ^ f2_dot_product(beta_j, v_j ^ shift));
+            if (imag_bit)
+            {
+                imaginary_part |= unit_vector<Bits>(j);
+            }
+
+            if (p_j->sign_bit ^ f2_dot_product(beta_j, v_j ^ shift))
+            {
+                real_linear_part |= unit_vector<Bits>(j);
+            }
 
             for (std::size_t i = 0; i < j; i++)
             {
-                std::size_t v_i = basis_vectors[i];
+                const Bits &v_i = basis_vectors[i];
                 std::size_t other_imag_bit = check_matrix.get_x_stabilisers()[i]->imag_bit; // TODO we are accessing the imag_bits alot, optimise?
 
-				quadratic_form[integral_pow_2(i) | integral_pow_2(j)] = f2_dot_product(beta_j, v_i) ^ imag_bit*other_imag_bit;
+				set_quadratic_form(i, j, f2_dot_product(beta_j, v_i) ^ imag_bit*other_imag_bit);
             }
         }
 	}
 
-	std::vector<std::complex<float>> Stabiliser_State::get_state_vector() const
+	template <f2_vector_like Bits>
+	std::vector<std::complex<float>> Basic_Stabiliser_State<Bits>::get_state_vector() const
+		requires std::unsigned_integral<Bits>
 	{
-		const std::size_t support_size = integral_pow_2(dim);
-		std::vector<std::complex<float>> state_vector(integral_pow_2(number_qubits), 0);
+		std::vector<std::complex<float>> state_vector(integral_pow_2(number_qubits));
+		write_state_vector(*this, state_vector);
+
+		return state_vector;
+	}
+
+	template <f2_vector_like Bits>
+	void Basic_Stabiliser_State<Bits>::get_state_vector(std::span<std::complex<float>> state_vector) const
+		requires std::unsigned_integral<Bits>
+	{
+		write_state_vector(*this, state_vector);
+	}
+
+	template <f2_vector_like Bits>
+	void Basic_Stabiliser_State<Bits>::get_state_vector(std::span<std::complex<double>> state_vector) const
+		requires std::unsigned_integral<Bits>
+	{
+		write_state_vector(*this, state_vector);
+	}
+
+	template <f2_vector_like Bits>
+	std::pair<std::vector<Bits>, std::vector<std::complex<float>>> Basic_Stabiliser_State<Bits>::get_sparse_state_vector() const
+		requires std::unsigned_integral<Bits>
+	{
+		check_dimensions();
+
+		std::vector<Bits> indices(integral_pow_2(dim));
+		std::vector<std::complex<float>> amplitudes(integral_pow_2(dim));
+		write_sparse_state_vector(*this, std::span<Bits>(indices), std::span<std::complex<float>>(amplitudes));
+
+		return {std::move(indices), std::move(amplitudes)};
+	}
+
+	template <f2_vector_like Bits>
+	void Basic_Stabiliser_State<Bits>::get_sparse_state_vector(std::span<Bits> indices, std::span<std::complex<float>> amplitudes) const
+		requires std::unsigned_integral<Bits>
+	{
+		write_sparse_state_vector(*this, indices, amplitudes);
+	}
+
+	template <f2_vector_like Bits>
+	void Basic_Stabiliser_State<Bits>::get_sparse_state_vector(std::span<Bits> indices, std::span<std::complex<double>> amplitudes) const
+		requires std::unsigned_integral<Bits>
+	{
+		write_sparse_state_vector(*this, indices, amplitudes);
+	}
+
+	template <f2_vector_like Bits>
+	std::vector<Bits> Basic_Stabiliser_State<Bits>::sample(const std::size_t number_shots, const std::uint64_t seed) const
+		requires std::unsigned_integral<Bits>
+	{
+		std::vector<Bits> shots(number_shots);
+		write_samples(*this, shots, seed);
+
+		return shots;
+	}
+
+	template <f2_vector_like Bits>
+	void Basic_Stabiliser_State<Bits>::sample(std::span<Bits> shots, const std::uint64_t seed) const
+		requires std::unsigned_integral<Bits>
+	{
+		write_samples(*this, shots, seed);
+	}
+
+	template <f2_vector_like Bits>
+	Basic_Affine_Space<Bits> Basic_Stabiliser_State<Bits>::get_marginal_support(const Bits qubit_mask) const
+		requires std::unsigned_integral<Bits>
+	{
+		check_dimensions();
+
+		if (number_qubits < std::numeric_limits<Bits>::digits && (qubit_mask >> number_qubits) != 0)
+		{
+			throw std::invalid_argument("The qubits of the marginal must be less than the number of qubits");
+		}
+
+		const std::size_t marginal_qubits = std::popcount(qubit_mask);
+
+		// The projections of the basis vectors span the projected space, and are reduced to rows[j] with
+		// leading bit j, so the nonzero rows are independent
+		std::vector<Bits> rows(marginal_qubits);
+
+		for (std::size_t j = 0; j < dim; j++)
+		{
+			Bits vector = compress_bits(basis_vectors[j], qubit_mask);
+
+			while (vector != 0 && rows[integral_log_2(vector)] != 0)
+			{
+				vector ^= rows[integral_log_2(vector)];
+			}
+
+			if (vector != 0)
+			{
+				rows[integral_log_2(vector)] = vector;
+			}
+		}
+
+		Basic_Affine_Space<Bits> support {marginal_qubits, compress_bits(shift, qubit_mask), {}};
+		std::copy_if(rows.begin(), rows.end(), std::back_inserter(support.basis_vectors), [](const Bits row) { return row != 0; });
+
+		return support;
+	}
+
+	template <f2_vector_like Bits>
+	std::vector<float> Basic_Stabiliser_State<Bits>::get_marginal_probabilities(const Bits qubit_mask) const
+		requires std::unsigned_integral<Bits>
+	{
+		std::vector<float> probabilities(integral_pow_2(std::size_t(std::popcount(qubit_mask))));
+		get_marginal_probabilities(qubit_mask, probabilities);
+
+		return probabilities;
+	}
+
+	template <f2_vector_like Bits>
+	void Basic_Stabiliser_State<Bits>::get_marginal_probabilities(const Bits qubit_mask, std::span<float> probabilities) const
+		requires std::unsigned_integral<Bits>
+	{
+		const Basic_Affine_Space<Bits> support = get_marginal_support(qubit_mask);
+
+		if (probabilities.size() != integral_pow_2(support.number_qubits))
+		{
+			throw std::invalid_argument("The marginal probabilities must have length 2^k, for k qubits in the mask");
+		}
+
+		std::fill(probabilities.begin(), probabilities.end(), 0.0f);
 
-		std::size_t vector_index = 0;
-		bool imag_exponent = 0;
-		std::size_t total_index = shift;
-		std::complex<float> phase = global_phase / float(std::sqrt(support_size));
+		const std::size_t support_size = integral_pow_2(support.basis_vectors.size());
+		const float probability = 1.0f / static_cast<float>(support_size);
+		Bits outcome = support.shift;
 
-		state_vector[total_index] = phase;
+		probabilities[outcome] = probability;
 
+		// Walk the support in Gray code order, as in for_each_amplitude
 		for (std::size_t iterate = 1; iterate < support_size; iterate++)
 		{
-			// Iterate through the Gray code
-			std::size_t new_vector_index = iterate ^ (iterate >> 1);
-			std::size_t flipped_bit = integral_log_2(vector_index ^ new_vector_index);
+			outcome ^= support.basis_vectors[std::countr_zero(iterate)];
+			probabilities[outcome] = probability;
+		}
+	}
+
+	template <f2_vector_like Bits>
+	std::complex<float> Basic_Stabiliser_State<Bits>::get_amplitude(const Bits x) const
+		requires std::unsigned_integral<Bits>
+	{
+		std::complex<float> amplitude;
+		write_amplitudes(*this, std::span<const Bits>(&x, 1), std::span<std::complex<float>>(&amplitude, 1));
+
+		return amplitude;
+	}
+
+	template <f2_vector_like Bits>
+	std::vector<std::complex<float>> Basic_Stabiliser_State<Bits>::get_amplitudes(std::span<const Bits> xs) const
+		requires std::unsigned_integral<Bits>
+	{
+		std::vector<std::complex<float>> amplitudes(xs.size());
+		write_amplitudes(*this, xs, std::span<std::complex<float>>(amplitudes));
+
+		return amplitudes;
+	}
+
+	template <f2_vector_like Bits>
+	void Basic_Stabiliser_State<Bits>::get_amplitudes(std::span<const Bits> xs, std::span<std::complex<float>> amplitudes) const
+		requires std::unsigned_integral<Bits>
+	{
+		write_amplitudes(*this, xs, amplitudes);
+	}
+
+	template <f2_vector_like Bits>
+	void Basic_Stabiliser_State<Bits>::get_amplitudes(std::span<const Bits> xs, std::span<std::complex<double>> amplitudes) const
+		requires std::unsigned_integral<Bits>
+	{
+		write_amplitudes(*this, xs, amplitudes);
+	}
+
+	template <f2_vector_like Bits>
+	int Basic_Stabiliser_State<Bits>::get_expectation_value(const Basic_Pauli<Bits> &pauli) const
+		requires std::unsigned_integral<Bits>
+	{
+		int value;
+		write_expectation_values(*this, std::span<const Basic_Pauli<Bits>>(&pauli, 1), std::span<int>(&value, 1));
 
-			total_index ^= basis_vectors[flipped_bit];
-			float real_linear_phase_update = f_min1_pow(bit_set_at(real_linear_part, flipped_bit));
+		return value;
+	}
+
+	template <f2_vector_like Bits>
+	std::vector<int> Basic_Stabiliser_State<Bits>::get_expectation_values(std::span<const Basic_Pauli<Bits>> paulis) const
+		requires std::unsigned_integral<Bits>
+	{
+		std::vector<int> values(paulis.size());
+		write_expectation_values(*this, paulis, std::span<int>(values));
+
+		return values;
+	}
+
+	template <f2_vector_like Bits>
+	void Basic_Stabiliser_State<Bits>::get_expectation_values(std::span<const Basic_Pauli<Bits>> paulis, std::span<int> values) const
+		requires std::unsigned_integral<Bits>
+	{
+		write_expectation_values(*this, paulis, values);
+	}
+
+	template <f2_vector_like Bits>
+	Measurement_Result Basic_Stabiliser_State<Bits>::measure(const Basic_Pauli<Bits> &pauli, const bool outcome)
+		requires std::unsigned_integral<Bits>
+	{
+		check_dimensions();
+
+		const Basis_Coordinates<Bits> coordinates {std::span<const Bits>(basis_vectors)};
+		const Pauli_Action<Bits> action = get_pauli_action(*this, coordinates, pauli);
+
+		if (action.coefficients && action.linear_form == 0)
+		{
+			return {action.exponent == 2, true};
+		}
+
+		Phase_Form form = get_phase_form(*this);
+
+		if (!action.coefficients)
+		{
+			// (I + (-1)^outcome P) psi / sqrt(2) also has the points shift ^ x ^ Bc, where it is (-1)^outcome times
+			// phase (-1)^(z.(shift ^ Bc)) psi(c), so x becomes a new basis vector
+			const std::size_t j = form.add_variable();
+			form.linear[j] = pauli.get_phase_exponent() + 2 * (outcome ^ f2_dot_product(pauli.z_vector, shift));
 
-			bool new_imag_exponent = bit_set_at(imaginary_part, flipped_bit) ^ imag_exponent;
-			// multiply by i if going from 1 to i, multiply by -i if going from i to 1
-			std::complex<float> imaginary_phase_update {(float) 1-(imag_exponent^new_imag_exponent), (float) (imag_exponent^new_imag_exponent)*(1-2*imag_exponent)};
+			for (std::size_t k = 0; k < dim; k++)
+			{
+				if (f2_dot_product(pauli.z_vector, basis_vectors[k]))
+				{
+					form.flip_quadratic_form(k, j);
+				}
+			}
 
-			bool quadratic_update_exponent = 0;
+			basis_vectors.push_back(pauli.x_vector);
+			dim++;
+		}
+		else
+		{
+			// (I + (-1)^outcome P) psi(c) / sqrt(2) is psi(c) (1 + i^a (-1)^y) / sqrt(2) for y = linear_form.c
+			const unsigned int a = (action.exponent + 2 * outcome) % 4;
 
-			for (std::size_t j = 0; j < dim; j++)
+			if (a % 2 == 1)
 			{
-				quadratic_update_exponent ^= (quadratic_form.at(integral_pow_2(flipped_bit) ^ integral_pow_2(j)) & bit_set_at(vector_index, j));
+				// This is psi(c) omega^(+-1) i^(-a y), for omega = e^(i pi / 4)
+				form.add_parity_term(4 - a, action.linear_form, false);
+				global_phase *= std::complex<float>(powers_of_omega[a == 1 ? 1 : 7]);
 			}
+			else
+			{
+				// This is sqrt(2) psi(c) when y = a / 2, and 0 otherwise, so for j in the linear form, c_j becomes
+				// a / 2 plus the rest of y. Adding basis_vectors[j] to the others in the linear form, and to the shift
+				// if a / 2 = 1, writes the remaining points in terms of the other coefficients
+				const std::size_t j = std::countr_zero(action.linear_form);
+				const std::size_t rest = action.linear_form ^ integral_pow_2(Bits(j));
+
+				form.substitute(j, rest, a == 2);
+				form.remove_variable(j);
 
-			float quadratic_phase_update = f_min1_pow(quadratic_update_exponent);
+				for (std::size_t k = 0; k < dim; k++)
+				{
+					if (bit_set_at(rest, k))
+					{
+						basis_vectors[k] ^= basis_vectors[j];
+					}
+				}
 
-			phase *= real_linear_phase_update * imaginary_phase_update * quadratic_phase_update;
+				if (a == 2)
+				{
+					shift ^= basis_vectors[j];
+				}
 
-			state_vector[total_index] = phase;
-			vector_index = new_vector_index;
-			imag_exponent = new_imag_exponent;
+				basis_vectors.erase(basis_vectors.begin() + j);
+				dim--;
+			}
 		}
-		
-		return state_vector;
+
+		set_phase_form(*this, form);
+		row_reduced = false;
+
+		return {outcome, false};
 	}
 
-	void Stabiliser_State::row_reduce_basis()
+	template <f2_vector_like Bits>
+	Measurement_Result Basic_Stabiliser_State<Bits>::measure(const Basic_Pauli<Bits> &pauli, Random_Generator &generator)
+		requires std::unsigned_integral<Bits>
+	{
+		return measure(pauli, static_cast<bool>(generator() & 1));
+	}
+
+	template <f2_vector_like Bits>
+	unsigned int Basic_Stabiliser_State<Bits>::get_phase_exponent(const std::size_t coefficients) const
+		requires std::unsigned_integral<Bits>
+	{
+		check_dimensions();
+
+		// Each pair {j, k} in the combination appears twice in the sum, as (j, k) and (k, j)
+		std::size_t quadratic_form_sum = 0;
+
+		for (std::size_t j = 0; j < dim; j++)
+		{
+			if (bit_set_at(coefficients, j))
+			{
+				quadratic_form_sum += std::popcount(quadratic_form[j] & coefficients);
+			}
+		}
+
+		const unsigned int sign = f2_dot_product(real_linear_part, Bits(coefficients)) ^ ((quadratic_form_sum / 2) % 2);
+
+		return 2 * sign + f2_dot_product(imaginary_part, Bits(coefficients));
+	}
+
+	template <f2_vector_like Bits>
+	void Basic_Stabiliser_State<Bits>::check_dimensions() const
+	{
+		if (basis_vectors.size() != dim || quadratic_form.size() != dim || dim > number_qubits)
+		{
+			throw std::invalid_argument("The state must have dim basis vectors and rows of the quadratic form, with dim at most the number of qubits");
+		}
+
+		if constexpr (std::unsigned_integral<Bits>)
+		{
+			if (number_qubits > std::numeric_limits<Bits>::digits)
+			{
+				throw std::invalid_argument("The number of qubits must fit in the bits of an index");
+			}
+		}
+	}
+
+	template <f2_vector_like Bits>
+	void Basic_Stabiliser_State<Bits>::check_quadratic_form_indices(const std::size_t i, const std::size_t j) const
+	{
+		std::size_t end = std::min(dim, quadratic_form.size());
+
+		if constexpr (std::unsigned_integral<Bits>)
+		{
+			end = std::min<std::size_t>(end, std::numeric_limits<Bits>::digits);
+		}
+
+		if (i >= end || j >= end)
+		{
+			throw std::out_of_range("The indices of the quadratic form must be less than dim, and than the number of its rows");
+		}
+	}
+
+	template <f2_vector_like Bits>
+	bool Basic_Stabiliser_State<Bits>::get_quadratic_form(const std::size_t i, const std::size_t j) const
+	{
+		check_quadratic_form_indices(i, j);
+
+		return bit_set_at(quadratic_form[i], j);
+	}
+
+	template <f2_vector_like Bits>
+	void Basic_Stabiliser_State<Bits>::set_quadratic_form(const std::size_t i, const std::size_t j, const bool value)
+	{
+		check_quadratic_form_indices(i, j);
+
+		if (i == j)
+		{
+			throw std::invalid_argument("The diagonal of the quadratic form is the real_linear_part, so cannot be set");
+		}
+
+		if (get_quadratic_form(i, j) != value)
+		{
+			quadratic_form[i] ^= unit_vector<Bits>(j);
+			quadratic_form[j] ^= unit_vector<Bits>(i);
+		}
+	}
+
+	template <f2_vector_like Bits>
+	void Basic_Stabiliser_State<Bits>::row_reduce_basis()
 	{
 		if (row_reduced) {return;}
 
-		for(std::size_t i = 0; i < dim; i++)
+		check_dimensions();
+
+		// Reduce the basis with an identity matrix alongside it, which then records the change of basis
+		const std::size_t change_of_basis_column = F2_Vector::number_words_for(number_qubits) * F2_Matrix::word_size;
+		F2_Matrix basis(dim, change_of_basis_column + dim);
+
+		for (std::size_t j = 0; j < dim; j++)
 		{
-			std::size_t v_i = basis_vectors[i];
-			std::size_t pivot_index = integral_log_2(v_i);
+			basis.set_row_bits(j, 0, number_qubits, basis_vectors[j]);
+			basis.flip(j, change_of_basis_column + j);
+		}
+
+		std::vector<std::size_t> rows(dim);
+		std::iota(rows.begin(), rows.end(), 0);
+
+		std::vector<std::size_t> columns(number_qubits);
+		std::iota(columns.rbegin(), columns.rend(), 0);
 
-			for(std::size_t j = 0; j < dim; j++)
+		row_reduce(basis, rows, columns);
+
+		F2_Matrix change_of_basis(dim, dim);
+
+		for (std::size_t j = 0; j < dim; j++)
+		{
+			basis_vectors[j] = basis.get_row_bits<Bits>(j, 0, number_qubits);
+
+			for (std::size_t k = 0; k < dim; k++)
 			{
-				if (i != j && bit_set_at(basis_vectors[j], pivot_index))
-				{
-                    add_vi_to_vj(i, j, v_i);
-                }
+				change_of_basis.set(j, k, basis.get(j, change_of_basis_column + k));
 			}
 		}
+
+		apply_change_of_basis(change_of_basis);
+
 		row_reduced = true;
-    }
+	}
 
-    void Stabiliser_State::add_vi_to_vj(const std::size_t i, const std::size_t j, const std::size_t v_i)
-    {
-        basis_vectors[j] ^= v_i;
+	template <f2_vector_like Bits>
+	void Basic_Stabiliser_State<Bits>::apply_change_of_basis(const F2_Matrix &change_of_basis)
+	{
+		// In coordinates x with respect to the basis, the real part of the phase is (-1)^(x^T U x), where U is the
+		// upper triangular matrix with the real linear part on the diagonal and the quadratic form above it.
+		// The old coordinates are T^T times the new ones, so in the new coordinates U becomes T U T^T
+		F2_Matrix form(dim, dim);
 
-        imaginary_part ^= integral_pow_2(j) * bit_set_at(imaginary_part, i);
-		real_linear_part ^= integral_pow_2(j) * bit_set_at(real_linear_part, j);
+		for (std::size_t j = 0; j < dim; j++)
+		{
+			form.set(j, j, bit_set_at(real_linear_part, j));
 
-        for (std::size_t k = 0; k < dim; k++)
-        {
-            quadratic_form[integral_pow_2(k) ^ integral_pow_2(j)] ^= (quadratic_form[integral_pow_2(k) ^ integral_pow_2(i)] & (k!=j));
-        }
+			for (std::size_t k = j + 1; k < dim; k++)
+			{
+				form.set(j, k, bit_set_at(quadratic_form[j], k));
+			}
+		}
+
+		const F2_Matrix new_form = change_of_basis * form * change_of_basis.transpose();
+
+		// The imaginary part only depends on x.imaginary_part mod 2, so is linear in the coordinates
+		Bits new_imaginary_part{};
+		real_linear_part = Bits{};
+		quadratic_form.assign(dim, Bits{});
+
+		for (std::size_t j = 0; j < dim; j++)
+		{
+			bool imag_bit = 0;
+
+			for (std::size_t k = 0; k < dim; k++)
+			{
+				imag_bit ^= change_of_basis.get(j, k) & bit_set_at(imaginary_part, k);
+			}
+
+			if (imag_bit)
+			{
+				new_imaginary_part |= unit_vector<Bits>(j);
+			}
+
+			if (new_form.get(j, j))
+			{
+				real_linear_part |= unit_vector<Bits>(j);
+			}
+
+			for (std::size_t k = 0; k < dim; k++)
+			{
+				if (k != j && new_form.get(j, k) ^ new_form.get(k, j))
+				{
+					quadratic_form[j] |= unit_vector<Bits>(k);
+				}
+			}
+		}
+
+		imaginary_part = std::move(new_imaginary_part);
+	}
 
-        quadratic_form[integral_pow_2(j)] ^= quadratic_form[integral_pow_2(i)];
-    }
+	template struct Basic_Stabiliser_State<std::size_t>;
+	template struct Basic_Stabiliser_State<F2_Vector>;
 }
@@ -2,16 +2,33 @@
 #define _FAST_STABILISER_STABILISER_STATE_H
 
 #include "pauli/pauli.h"
+#include "util/random.h"
 
+#include <bit>
+#include <cstdint>
+#include <span>
 #include <vector>
 #include <complex>
-#include <unordered_map>
+#include <utility>
 
-// TODO: enforce quadratic_form[0] = 0
-// TODO: make quadratic_form opaque so it behaves as you expect (and reduce copying)
 namespace fst
 {
-	struct Check_Matrix;
+	template <f2_vector_like Bits>
+	struct Basic_Check_Matrix;
+
+	class F2_Matrix;
+
+	/// The affine space shift + span(basis_vectors) of bit strings on number_qubits qubits, with the basis
+	/// vectors independent
+	template <f2_vector_like Bits>
+	struct Basic_Affine_Space
+	{
+		std::size_t number_qubits = 0;
+		Bits shift{};
+		std::vector<Bits> basis_vectors;
+
+		bool operator==(const Basic_Affine_Space &other) const = default;
+	};
 
 	/// The class used to represent a stabiliser state
 	///
@@ -20,47 +37,223 @@ namespace fst
 	/// More precisely, it is stored as a list of basis vectors for a vector space,
 	/// a constant vector that is added to every element of the vector space to reach,
 	/// the affine space, and a quadratic and linear form defined on the vector space.
-	struct Stabiliser_State
+	///
+	/// As for Basic_Pauli, Bits is std::size_t (the Stabiliser_State alias, up to 64 qubits) or
+	/// F2_Vector (the Wide_Stabiliser_State alias, any number of qubits).
+	template <f2_vector_like Bits>
+	struct Basic_Stabiliser_State
 	{
 		std::size_t number_qubits = 0;
-		std::vector<std::size_t> basis_vectors;
+		std::vector<Bits> basis_vectors;
 		std::size_t dim = 0;
-		std::size_t shift = 0;
+		Bits shift{};
 
-		std::size_t real_linear_part = 0;
-		std::size_t imaginary_part = 0;
+		Bits real_linear_part{};
+		Bits imaginary_part{};
 		
-		/// The quadratic form is stored as map. It should always have quadratic_form[0] = 0
-		/// Q(e_i, e_j) is stored as quadratic_form[2^i ^ 2^j] 
-		std::unordered_map<std::size_t, bool> quadratic_form;
+		/// The (rest of the) quadratic form, stored as a symmetric bit matrix with one row per
+		/// basis vector: Q(e_i, e_j) is bit j of quadratic_form[i]. The diagonal is always zero
+		/// (the diagonal part is the real_linear_part)
+		std::vector<Bits> quadratic_form;
 		std::complex<float> global_phase = 1.0;
 		
 		bool row_reduced = false;
 
-		Stabiliser_State() = default;
-		Stabiliser_State(const std::size_t number_qubits, const std::size_t dim);
-		explicit Stabiliser_State(const std::size_t number_qubits);
+		Basic_Stabiliser_State() = default;
+		Basic_Stabiliser_State(const std::size_t number_qubits, const std::size_t dim);
+		explicit Basic_Stabiliser_State(const std::size_t number_qubits);
 		
-		explicit Stabiliser_State(Check_Matrix &check_matrix);
+		explicit Basic_Stabiliser_State(Basic_Check_Matrix<Bits> &check_matrix);
 
 		/// Return the state vector of length 2^n of the stabiliser state (with respect
 		/// to the computational basis)
-		std::vector<std::complex<float>> get_state_vector() const;
+		std::vector<std::complex<float>> get_state_vector() const
+			requires std::unsigned_integral<Bits>;
+
+		/// Writes the state vector into state_vector, which must have length 2^n, so that a buffer
+		/// can be reused across calls, in single or double precision. Throws std::invalid_argument if the
+		/// length is wrong
+		void get_state_vector(std::span<std::complex<float>> state_vector) const
+			requires std::unsigned_integral<Bits>;
+		void get_state_vector(std::span<std::complex<double>> state_vector) const
+			requires std::unsigned_integral<Bits>;
+
+		/// Returns the 2^dim non-zero amplitudes of the state, as the pair (indices, amplitudes) with
+		/// amplitudes[k] at indices[k]. Nothing of size 2^n is touched, so this works for states on any
+		/// number of qubits Bits can index. The indices are in the order of the walk in for_each_amplitude,
+		/// not sorted
+		std::pair<std::vector<Bits>, std::vector<std::complex<float>>> get_sparse_state_vector() const
+			requires std::unsigned_integral<Bits>;
+
+		/// Writes the non-zero amplitudes as above into indices and amplitudes, which must both have length
+		/// 2^dim. Throws std::invalid_argument if a length is wrong
+		void get_sparse_state_vector(std::span<Bits> indices, std::span<std::complex<float>> amplitudes) const
+			requires std::unsigned_integral<Bits>;
+		void get_sparse_state_vector(std::span<Bits> indices, std::span<std::complex<double>> amplitudes) const
+			requires std::unsigned_integral<Bits>;
+
+		/// Returns number_shots computational basis measurement outcomes of the state, each bit-packed into
+		/// one word (bit q for qubit q), from the pseudo-random stream given by seed. See write_samples
+		std::vector<Bits> sample(const std::size_t number_shots, const std::uint64_t seed) const
+			requires std::unsigned_integral<Bits>;
+
+		/// Writes one measurement outcome as above into each entry of shots
+		void sample(std::span<Bits> shots, const std::uint64_t seed) const
+			requires std::unsigned_integral<Bits>;
+
+		/// Returns the support of the marginal distribution of computational basis measurements on the qubits in
+		/// qubit_mask, which is uniform on it. Qubit q of the mask becomes qubit k of the result when it is the k-th
+		/// qubit of the mask, counting from the lowest. The support is the projection of the affine support of the
+		/// state, so this takes O(dim * popcount(qubit_mask)) word operations.
+		/// Throws std::invalid_argument if the mask has a qubit that is not less than number_qubits
+		Basic_Affine_Space<Bits> get_marginal_support(const Bits qubit_mask) const
+			requires std::unsigned_integral<Bits>;
+
+		/// Returns the marginal distribution on the qubits in qubit_mask as the 2^k probabilities (for k qubits in the
+		/// mask) of the outcomes, numbered as for get_marginal_support. This is only for small k, as it touches each
+		/// of the 2^k entries once, and throws std::invalid_argument as for get_marginal_support
+		std::vector<float> get_marginal_probabilities(const Bits qubit_mask) const
+			requires std::unsigned_integral<Bits>;
+
+		/// Writes the marginal distribution as above into probabilities, which must have length 2^k. Throws
+		/// std::invalid_argument if the length is wrong
+		void get_marginal_probabilities(const Bits qubit_mask, std::span<float> probabilities) const
+			requires std::unsigned_integral<Bits>;
+
+		/// Returns the amplitude <x|psi> of the basis state x, without building the state vector. This
+		/// solves for x ^ shift as a combination of the basis vectors, so takes O(dim^2) word operations
+		std::complex<float> get_amplitude(const Bits x) const
+			requires std::unsigned_integral<Bits>;
+
+		/// Returns the amplitudes of each of the basis states xs, as for get_amplitude. The basis is
+		/// reduced once, so each amplitude takes O(dim) word operations, and the basis states are split
+		/// between threads with parallel_for
+		std::vector<std::complex<float>> get_amplitudes(std::span<const Bits> xs) const
+			requires std::unsigned_integral<Bits>;
+
+		/// Writes the amplitudes of xs into amplitudes, which must have the same length, in single or
+		/// double precision. Throws std::invalid_argument if the length is wrong
+		void get_amplitudes(std::span<const Bits> xs, std::span<std::complex<float>> amplitudes) const
+			requires std::unsigned_integral<Bits>;
+		void get_amplitudes(std::span<const Bits> xs, std::span<std::complex<double>> amplitudes) const
+			requires std::unsigned_integral<Bits>;
+
+		/// Returns the expectation value <psi|P|psi> of a Hermitian Pauli P on the same number of qubits, which is
+		/// +1 or -1 if +P or -P is in the stabiliser group of the state, and 0 otherwise. This needs the x_vector of
+		/// P in the span of the basis, and then a check of a linear form, so takes O(dim^2) word operations.
+		/// Throws std::invalid_argument if P is not Hermitian or the number of qubits differs
+		int get_expectation_value(const Basic_Pauli<Bits> &pauli) const
+			requires std::unsigned_integral<Bits>;
+
+		/// Returns the expectation values of each of the Paulis, as for get_expectation_value. The basis is
+		/// reduced once, so each Pauli takes O(dim) word operations, and the Paulis are split between threads
+		/// with parallel_for
+		std::vector<int> get_expectation_values(std::span<const Basic_Pauli<Bits>> paulis) const
+			requires std::unsigned_integral<Bits>;
+
+		/// Writes the expectation values of the Paulis into values, which must have the same length. Throws
+		/// std::invalid_argument if the length is wrong, or as for get_expectation_value
+		void get_expectation_values(std::span<const Basic_Pauli<Bits>> paulis, std::span<int> values) const
+			requires std::unsigned_integral<Bits>;
+
+		/// Measures the Hermitian Pauli P, collapsing the state into the (-1)^outcome eigenspace of P, with its
+		/// global phase that of (I + (-1)^outcome P) |psi> / sqrt(2). If the outcome is not deterministic, it is
+		/// the given outcome, and otherwise that is ignored. Either P moves the support off itself, which adds a
+		/// basis vector, or the support is halved, or only the phases change, each in O(dim^2) word operations.
+		/// Throws std::invalid_argument as for get_expectation_value
+		Measurement_Result measure(const Basic_Pauli<Bits> &pauli, const bool outcome)
+			requires std::unsigned_integral<Bits>;
+
+		/// Measures P as above, with a random outcome if it is not deterministic. One bit is drawn from generator
+		/// for every measurement, so a stream of measurements depends only on its seed
+		Measurement_Result measure(const Basic_Pauli<Bits> &pauli, Random_Generator &generator)
+			requires std::unsigned_integral<Bits>;
+
+		/// Returns the phase exponent k in Z_4 of the amplitude global_phase / sqrt(2^dim) * i^k at
+		/// shift ^ (sum of basis_vectors[j] for j in the bits of coefficients), as in for_each_amplitude
+		unsigned int get_phase_exponent(const std::size_t coefficients) const
+			requires std::unsigned_integral<Bits>;
+
+		/// Walks the support of the state in Gray code order, calling visit(index, phase_exponent) for
+		/// each of the 2^dim computational basis states in it, where the amplitude at index is
+		/// global_phase / sqrt(2^dim) * i^phase_exponent, with phase_exponent in Z_4.
+		/// Each step is a constant number of word operations. visit returns false to stop the walk
+		/// early, and this returns whether the whole support was visited.
+		template <class Visitor>
+		bool for_each_amplitude(Visitor &&visit) const
+			requires std::unsigned_integral<Bits>
+		{
+			check_dimensions();
+
+			const std::size_t support_size = integral_pow_2(dim);
+
+			std::size_t vector_index = 0;
+			Bits total_index = shift;
+
+			// The amplitude is (-1)^sign_exponent * i^imag_exponent, times the constant factor
+			unsigned int sign_exponent = 0;
+			unsigned int imag_exponent = 0;
+
+			if (!visit(total_index, 0u))
+			{
+				return false;
+			}
+
+			for (std::size_t iterate = 1; iterate < support_size; iterate++)
+			{
+				// Iterate through the Gray code, in which step iterate flips bit countr_zero(iterate)
+				const std::size_t flipped_bit = std::countr_zero(iterate);
+
+				total_index ^= basis_vectors[flipped_bit];
+
+				// Q(e_flipped_bit, e_flipped_bit) = 0, so the quadratic form changes by Q(e_flipped_bit, vector_index)
+				sign_exponent ^= bit_set_at(real_linear_part, flipped_bit) ^ f2_dot_product(quadratic_form[flipped_bit], vector_index);
+				imag_exponent ^= bit_set_at(imaginary_part, flipped_bit);
+				vector_index ^= integral_pow_2(flipped_bit);
+
+				if (!visit(total_index, 2 * sign_exponent + imag_exponent))
+				{
+					return false;
+				}
+			}
+
+			return true;
+		}
+
+		/// Returns Q(e_i, e_j). Throws std::out_of_range if i or j is not less than dim
+		bool get_quadratic_form(const std::size_t i, const std::size_t j) const;
+
+		/// Sets Q(e_i, e_j) (and so Q(e_j, e_i)) to value. i and j must be different. Throws std::out_of_range
+		/// as for get_quadratic_form
+		void set_quadratic_form(const std::size_t i, const std::size_t j, const bool value);
+
+		/// Throws std::invalid_argument unless there are dim basis vectors and dim rows of the quadratic form,
+		/// with dim at most the number of qubits. The fields are public, so everything reading the basis or
+		/// the quadratic form checks this first
+		void check_dimensions() const;
 		
 		/// Row reduces the basis to reduced row-echelon form. Note that the quadratic form and 
 		/// the real and imaginary linear parts are also updated, so the instance represents the
 		/// same stabiliser state
 		void row_reduce_basis();
 
-		bool operator==(const Stabiliser_State &other) const = default;
+		bool operator==(const Basic_Stabiliser_State &other) const = default;
 		
 		private:
 
-		void set_support_from_cm(const Check_Matrix &check_matrix);
-		void set_linear_and_quadratic_forms_from_cm(const Check_Matrix &check_matrix);
+		void check_quadratic_form_indices(const std::size_t i, const std::size_t j) const;
 
-		void add_vi_to_vj(const std::size_t i, const std::size_t j, const std::size_t v_i);
+		void set_support_from_cm(const Basic_Check_Matrix<Bits> &check_matrix);
+		void set_linear_and_quadratic_forms_from_cm(const Basic_Check_Matrix<Bits> &check_matrix);
+
+		/// Given the matrix T with new_basis_vectors[j] = sum_k T[j][k] basis_vectors[k], updates the
+		/// quadratic form and linear parts to be written in terms of the new basis
+		void apply_change_of_basis(const F2_Matrix &change_of_basis);
 	};
+
+	using Stabiliser_State = Basic_Stabiliser_State<std::size_t>;
+	using Wide_Stabiliser_State = Basic_Stabiliser_State<F2_Vector>;
+	using Affine_Space = Basic_Affine_Space<std::size_t>;
 }
 
 #endif
\ No newline at end of file
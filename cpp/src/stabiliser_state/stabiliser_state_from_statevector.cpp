@@ -1,71 +1,183 @@
 #include "stabiliser_state_from_statevector.h"
 
 #include "util/f2_helper.h"
+#include "util/parallel.h"
+#include "util/simd.h"
 
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <limits>
 #include <optional>
+#include <stdexcept>
+#include <type_traits>
 #include <vector>
 
+#ifdef FST_X86_64
+#include <immintrin.h>
+#endif
+
 using namespace fst;
 
 namespace
 {
-	template <bool assume_valid, bool return_state>
-	auto stabiliser_from_statevector_internal(const std::span<const std::complex<float>> statevector)
-		-> std::conditional_t<return_state, std::optional<fst::Stabiliser_State>, bool>
+	/// The number of amplitudes tested for being non-zero at once, as the bits of a mask
+	constexpr std::size_t scan_chunk_size = 64;
+
+	/// Returns the mask of which of the (at most scan_chunk_size) amplitudes in the chunk are non-zero. The loop has no
+	/// branches, so compiles to vector compares
+	template <std::floating_point Scalar>
+	std::uint64_t get_non_zero_mask(const std::span<const std::complex<Scalar>> chunk)
 	{
-		const std::size_t state_vector_size = statevector.size();
+		std::uint64_t mask = 0;
 
-		if (!is_power_of_2(state_vector_size))
+		for (std::size_t k = 0; k < chunk.size(); k++)
 		{
-			return {};
+			mask |= std::uint64_t(chunk[k] != Scalar(0)) << k;
 		}
 
-		const std::size_t number_qubits = integral_log_2(state_vector_size);
-		std::size_t shift = 0;
+		return mask;
+	}
 
-		while (shift < state_vector_size && statevector[shift] == .0f)
-		{
-			++shift;
-		}
+#ifdef FST_X86_64
+	/// As get_non_zero_mask, for a whole chunk of single precision amplitudes. Each amplitude is a 64 bit lane, which is
+	/// zero exactly when both parts are +-0 once their sign bits are cleared
+	FST_TARGET_AVX2 std::uint64_t get_non_zero_mask_avx2(const std::complex<float> *chunk)
+	{
+		const __m256i magnitude_bits = _mm256_set1_epi32(0x7fffffff);
+		std::uint64_t mask = 0;
 
-		if (shift == state_vector_size)
+		for (std::size_t k = 0; k < scan_chunk_size; k += 4)
 		{
-			return {};
+			const __m256i magnitudes = _mm256_and_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(chunk + k)), magnitude_bits);
+			const __m256i is_zero = _mm256_cmpeq_epi64(magnitudes, _mm256_setzero_si256());
+
+			mask |= std::uint64_t(~_mm256_movemask_pd(_mm256_castsi256_pd(is_zero)) & 0xf) << k;
 		}
 
-		std::vector<std::size_t> vector_space_indices;
-		vector_space_indices.reserve(state_vector_size + 1);
-		vector_space_indices.push_back(0);
+		return mask;
+	}
+#endif
+
+	/// The support of a state vector, as found by scan_support
+	struct Support
+	{
+		std::size_t shift = 0;
+		std::vector<std::size_t> basis_vectors;
+		std::size_t size = 0;
+	};
+
+	/// Scans the state vector once for its support, keeping O(n) state.
+	///
+	/// If the support is an affine space with shift its smallest index, then listing it in increasing order gives
+	/// shift ^ (sum of b_j for j in the bits of k) at position k, where b_j is its basis in reduced row echelon form
+	/// (each b_j has a leading bit no other has, and which shift does not have). So b_j is shift ^ the index at
+	/// position 2^j, and only those positions are recorded. For any other support the result is wrong, but the
+	/// support size is then either not a power of 2 or the state fails verification
+	template <std::floating_point Scalar>
+	Support scan_support(const std::span<const std::complex<Scalar>> statevector)
+	{
+		Support support;
 
-		// TODO: create seperate array of the statevector entries here as well, so we don't have to keep XORing with shift later on
+		[[maybe_unused]] const bool use_avx2 = std::is_same_v<Scalar, float> && get_simd_level() != Simd_Level::scalar;
 
-		for (std::size_t index = shift + 1; index < state_vector_size; index++)
+		for (std::size_t chunk_start = 0; chunk_start < statevector.size(); chunk_start += scan_chunk_size)
 		{
-			if (statevector[index] != .0f)
+			const std::span<const std::complex<Scalar>> chunk = statevector.subspan(chunk_start, std::min(scan_chunk_size, statevector.size() - chunk_start));
+			std::uint64_t mask;
+
+#ifdef FST_X86_64
+			if constexpr (std::is_same_v<Scalar, float>)
+			{
+				mask = use_avx2 && chunk.size() == scan_chunk_size ? get_non_zero_mask_avx2(chunk.data()) : get_non_zero_mask(chunk);
+			}
+			else
+#endif
+			{
+				mask = get_non_zero_mask(chunk);
+			}
+
+			// Positions 0 (the shift) and 2^j of the support are recorded, and they are sparse, so most chunks are only counted
+			for (std::size_t next_position = support.size == 0 ? 0 : std::bit_ceil(support.size);
+				 support.size + std::popcount(mask) > next_position;
+				 next_position = std::bit_ceil(support.size + 1))
 			{
-				vector_space_indices.push_back(shift ^ index);
+				// Drop the non-zero entries before next_position, leaving it as the lowest set bit of the mask
+				for (; support.size < next_position; support.size++)
+				{
+					mask &= mask - 1;
+				}
+
+				const std::size_t index = chunk_start + std::countr_zero(mask);
+
+				if (support.size == 0)
+				{
+					support.shift = index;
+				}
+				else
+				{
+					support.basis_vectors.push_back(support.shift ^ index);
+				}
 			}
+
+			support.size += std::popcount(mask);
 		}
 
-		const std::size_t support_size = vector_space_indices.size();
+		return support;
+	}
+
+	/// Finds the stabiliser state with the given support (as found by scan_support, or listed by a sparse input), or
+	/// nothing if there is none.
+	///
+	/// amplitude_at(index, coefficients) returns the amplitude at index, where index is shift ^ (sum of b_j for j in
+	/// the bits of coefficients), or zero if the input has none there
+	template <bool assume_valid, bool return_state, std::floating_point Scalar, class Amplitude_At>
+	auto stabiliser_from_support(const std::size_t number_qubits, Support &&support, const Amplitude_At &amplitude_at, const Tolerance &tolerance)
+		-> std::conditional_t<return_state, std::optional<fst::Stabiliser_State>, bool>
+	{
+		using Complex = std::complex<Scalar>;
 
-		if (!is_power_of_2(support_size))
+		if (support.size == 0 || !is_power_of_2(support.size))
 		{
 			return {};
 		}
 
+		const std::size_t shift = support.shift;
+		const std::size_t support_size = support.size;
 		const std::size_t dimension = integral_log_2(support_size);
-		const float normalisation_factor = (float) std::sqrt(support_size);
-		const std::complex<float> first_entry = statevector[shift];
-		const std::complex<float> global_phase = normalisation_factor * first_entry;
 
-		if (std::abs(std::norm(global_phase) - 1) >= 0.125)
+		if constexpr (!assume_valid)
+		{
+			// Distinct leading bits make the basis independent, so the verification below visits support_size distinct
+			// indices, all non-zero, and so the whole support
+			for (std::size_t j = 1; j < dimension; j++)
+			{
+				if (std::bit_width(support.basis_vectors[j]) <= std::bit_width(support.basis_vectors[j - 1]))
+				{
+					return {};
+				}
+			}
+		}
+
+		const Scalar normalisation_factor = std::sqrt(Scalar(support_size));
+		const Complex first_entry = amplitude_at(shift, 0);
+		const Complex global_phase = normalisation_factor * first_entry;
+
+		if (std::abs(std::norm(global_phase) - 1) >= tolerance.phase)
 		{
 			return {};
 		}
 
-		std::vector<std::size_t> basis_vectors;
-		basis_vectors.reserve(dimension);
+		// first_entry * i^k, exactly
+		const auto expected_amplitudes = scaled_powers_of_i(first_entry);
+
+		// Whether the ratio of two amplitudes is i^phase_exponent, up to the tolerance
+		const auto is_ratio = [&](const Complex ratio, const unsigned int phase_exponent)
+		{
+			return std::norm(ratio - Complex(powers_of_i[phase_exponent])) < tolerance.phase;
+		};
+
+		const std::vector<std::size_t> &basis_vectors = support.basis_vectors;
 
 		std::size_t real_linear_part = 0;
 		std::size_t imaginary_part = 0;
@@ -74,34 +186,31 @@ namespace
 		{
 			const std::size_t weight_one_string = integral_pow_2(j);
 
-			const std::size_t basis_vector = vector_space_indices[weight_one_string];
-			basis_vectors.push_back(basis_vector);
+			const std::size_t basis_vector = basis_vectors[j];
 
-			std::complex<float> phase = statevector[basis_vector ^ shift] / first_entry;
+			const Complex phase = amplitude_at(basis_vector ^ shift, weight_one_string) / first_entry;
 
-			if (std::norm(phase + 1.0f) < 0.125)
+			if (is_ratio(phase, 2))
 			{
 				real_linear_part ^= weight_one_string;
 			}
-			else if (std::norm(phase - std::complex<float>{0, 1}) < 0.125)
+			else if (is_ratio(phase, 1))
 			{
 				imaginary_part ^= weight_one_string;
 			}
-			else if (std::norm(phase - std::complex<float>{0, -1}) < 0.125)
+			else if (is_ratio(phase, 3))
 			{
 				real_linear_part ^= weight_one_string;
 				imaginary_part ^= weight_one_string;
 			}
-			else if (std::norm(phase - 1.0f) >= 0.125)
+			else if (!is_ratio(phase, 0))
 			{
 				return {};
 			}
 		}
 
-		std::unordered_map<std::size_t, bool> quadratic_form;
-		quadratic_form.reserve(dimension * (dimension + 1)/2 + 1);
-
-		quadratic_form[0] = 0;
+		// Row i of the quadratic form has bit j set when Q(e_i, e_j) = 1
+		std::vector<std::size_t> quadratic_form(dimension, 0);
 
 		for (std::size_t j = 0; j < dimension; j++)
 		{
@@ -109,110 +218,294 @@ namespace
 			{
 				const std::size_t vector_index = integral_pow_2(i) | integral_pow_2(j);
 
-				const float real_linear_eval = sign_f2_dot_product(vector_index, real_linear_part);
-				const std::complex<float> imag_linear_eval = imag_f2_dot_product(vector_index, imaginary_part);
-				const std::complex<float> linear_eval = real_linear_eval * imag_linear_eval;
+				// The linear part contributes (-1)^(real_linear_part) * i^(imaginary_part)
+				const unsigned int linear_exponent = 2 * f2_dot_product(vector_index, real_linear_part) + f2_dot_product(vector_index, imaginary_part);
 
-				const std::size_t total_index = vector_space_indices[vector_index] ^ shift;
+				const std::size_t total_index = basis_vectors[i] ^ basis_vectors[j] ^ shift;
 
-				const std::complex<float> quadratic_form_eval = statevector[total_index] / (first_entry * linear_eval);
+				const Complex quadratic_form_eval = amplitude_at(total_index, vector_index) / expected_amplitudes[linear_exponent];
 
-				if (std::norm(quadratic_form_eval + 1.0f) < 0.125)
+				if (is_ratio(quadratic_form_eval, 2))
 				{
-					quadratic_form[vector_index] = 1;
+					quadratic_form[i] |= integral_pow_2(j);
+					quadratic_form[j] |= integral_pow_2(i);
 				}
-				else if(std::norm(quadratic_form_eval - 1.0f) < 0.125)
-				{
-					quadratic_form[vector_index] = 0;
-				}
-				else
+				else if (!is_ratio(quadratic_form_eval, 0))
 				{
 					return {};
 				}
 			}
 		}
 
+		Stabiliser_State state(number_qubits, dimension);
+		state.shift = shift;
+		state.basis_vectors = std::move(support.basis_vectors);
+		state.real_linear_part = real_linear_part;
+		state.imaginary_part = imaginary_part;
+		state.quadratic_form = std::move(quadratic_form);
+		state.global_phase = std::complex<float>(global_phase);
+		state.row_reduced = true;
+
 		if constexpr (!assume_valid)
 		{
-			// TODO this duplicates alot of code from the get_state_vector() method of stabiliser_state. Fix
-			std::size_t vector_index = 0;
-			bool imag_exponent = 0;
-			std::size_t total_index = shift;
-			std::complex<float> phase = global_phase / float(std::sqrt(support_size));
+			// The expected amplitudes are exactly first_entry * i^k, so the tolerance only has to absorb
+			// rounding in the input, not error accumulated along the walk. Step iterate of the walk is at the
+			// combination of basis vectors given by the Gray code iterate ^ (iterate >> 1)
+			std::size_t iterate = 0;
 
-			for (std::size_t iterate = 1; iterate < support_size; iterate++)
+			const bool is_valid = state.for_each_amplitude([&](const std::size_t index, const unsigned int phase_exponent)
 			{
-				// Iterate through the Gray code
-				std::size_t new_vector_index = iterate ^ (iterate >> 1);
-				std::size_t flipped_bit = integral_log_2(vector_index ^ new_vector_index);
+				const Complex amplitude = amplitude_at(index, iterate ^ (iterate >> 1));
+				iterate++;
+
+				return amplitude != Scalar(0) && std::norm(expected_amplitudes[phase_exponent] - amplitude) < tolerance.amplitude;
+			});
 
-				total_index ^= basis_vectors[flipped_bit];
-				float real_linear_phase_update = f_min1_pow(bit_set_at(real_linear_part, flipped_bit));
+			if (!is_valid)
+			{
+				return {};
+			}
+		}
 
-				bool new_imag_exponent = bit_set_at(imaginary_part, flipped_bit) ^ imag_exponent;
-				// multiply by i if going from 1 to i, multiply by -i if going from i to 1
-				std::complex<float> imaginary_phase_update {(float) 1-(imag_exponent^new_imag_exponent), (float) (imag_exponent^new_imag_exponent)*(1-2*imag_exponent)};
+		if constexpr (return_state)
+		{
+			return state;
+		}
+		else
+		{
+			return true;
+		}
+	}
 
-				bool quadratic_update_exponent = 0;
+	template <bool assume_valid, bool return_state, std::floating_point Scalar>
+	auto stabiliser_from_statevector_internal(const std::span<const std::complex<Scalar>> statevector, const Tolerance &tolerance)
+		-> std::conditional_t<return_state, std::optional<fst::Stabiliser_State>, bool>
+	{
+		if (!is_power_of_2(statevector.size()))
+		{
+			return {};
+		}
 
-				for (std::size_t j = 0; j < dimension; j++)
-				{
-					quadratic_update_exponent ^= (quadratic_form.at(integral_pow_2(flipped_bit) ^ integral_pow_2(j)) & bit_set_at(vector_index, j));
-				}
+		return stabiliser_from_support<assume_valid, return_state, Scalar>(integral_log_2(statevector.size()), scan_support(statevector), [&](const std::size_t index, std::size_t)
+		{
+			return statevector[index];
+		}, tolerance);
+	}
 
-				float quadratic_phase_update = f_min1_pow(quadratic_update_exponent);
+	/// As stabiliser_from_statevector_internal, for the state with amplitudes[k] at indices[k], and zero elsewhere.
+	/// Throws std::invalid_argument if the input is malformed
+	template <bool assume_valid, bool return_state, std::floating_point Scalar>
+	auto stabiliser_from_sparse_internal(const std::size_t number_qubits, const std::span<const std::size_t> indices, const std::span<const std::complex<Scalar>> amplitudes, const Tolerance &tolerance)
+		-> std::conditional_t<return_state, std::optional<fst::Stabiliser_State>, bool>
+	{
+		if (indices.size() != amplitudes.size())
+		{
+			throw std::invalid_argument("There must be one amplitude per index");
+		}
 
-				phase *= real_linear_phase_update * imaginary_phase_update * quadratic_phase_update;
+		if (number_qubits > std::numeric_limits<std::size_t>::digits)
+		{
+			throw std::invalid_argument("Sparse state vectors are limited to as many qubits as there are bits in std::size_t");
+		}
 
-				if (std::norm(phase - statevector[total_index]) >= 0.001)
-				{
-					return {};
-				}
+		// The positions of the amplitudes, in increasing order of index. Repeats are checked for before the zero
+		// amplitudes are dropped, so an index repeated with a zero amplitude is still rejected
+		std::vector<std::size_t> order(indices.size());
 
-				vector_index = new_vector_index;
-				imag_exponent = new_imag_exponent;
+		for (std::size_t k = 0; k < indices.size(); k++)
+		{
+			if (number_qubits < std::numeric_limits<std::size_t>::digits && indices[k] >> number_qubits != 0)
+			{
+				throw std::invalid_argument("Each index must be less than 2^number_qubits");
 			}
+
+			order[k] = k;
 		}
 
-		if constexpr (return_state)
+		const auto index_of = [&](const std::size_t position) { return indices[position]; };
+
+		if (!std::ranges::is_sorted(order, {}, index_of))
 		{
-			Stabiliser_State state(number_qubits, dimension);
-			state.shift = shift;
-			state.basis_vectors = std::move(basis_vectors);
-			state.real_linear_part = real_linear_part;
-			state.imaginary_part = imaginary_part;
-			state.quadratic_form = std::move(quadratic_form);
-			state.global_phase = global_phase;
-			state.row_reduced = true;
-			return state;
+			std::ranges::sort(order, {}, index_of);
 		}
-		else
+
+		if (std::ranges::adjacent_find(order, {}, index_of) != order.end())
 		{
-			return true;
+			throw std::invalid_argument("The indices must be distinct");
+		}
+
+		std::erase_if(order, [&](const std::size_t position) { return amplitudes[position] == Scalar(0); });
+
+		// The sorted support is laid out as described at scan_support, so the basis is at positions 2^j, and the index
+		// for a combination of the basis is at the position given by its coefficients, if the input is valid
+		Support support;
+		support.size = order.size();
+
+		if (!order.empty())
+		{
+			support.shift = indices[order[0]];
+
+			for (std::size_t position = 1; position < order.size(); position *= 2)
+			{
+				support.basis_vectors.push_back(support.shift ^ indices[order[position]]);
+			}
 		}
+
+		return stabiliser_from_support<assume_valid, return_state, Scalar>(number_qubits, std::move(support), [&](const std::size_t index, const std::size_t coefficients)
+		{
+			const bool is_at_position = coefficients < order.size() && indices[order[coefficients]] == index;
+			return is_at_position ? amplitudes[order[coefficients]] : std::complex<Scalar>(0);
+		}, tolerance);
 	}
-}
 
-fst::Stabiliser_State fst::stabiliser_from_statevector(const std::vector<std::complex<float>> &statevector, bool assume_valid)
-{
-	std::optional<Stabiliser_State> state = assume_valid
-												? stabiliser_from_statevector_internal<true, true>(statevector)
-												: stabiliser_from_statevector_internal<false, true>(statevector);
+	/// Each thread gets at least this many amplitudes of a batch, so small batches stay on the calling thread
+	constexpr std::size_t minimum_amplitudes_per_task = std::size_t(1) << 16;
+
+	/// Calls convert_row(row, statevector) for each row of the batch, split between threads
+	template <std::floating_point Scalar, class Row_Converter>
+	void for_each_row(std::span<const std::complex<Scalar>> statevectors, const std::size_t number_qubits, const std::size_t number_rows, const Row_Converter &convert_row)
+	{
+		const std::size_t row_size = integral_pow_2(number_qubits);
+		const std::size_t minimum_rows_per_task = std::max<std::size_t>(minimum_amplitudes_per_task / row_size, 1);
+		const std::size_t number_tasks = std::min(get_number_threads(), (number_rows + minimum_rows_per_task - 1) / minimum_rows_per_task);
+
+		parallel_for(number_tasks, [&](const std::size_t task)
+		{
+			const std::size_t last_row = (task + 1) * number_rows / number_tasks;
+
+			for (std::size_t row = task * number_rows / number_tasks; row < last_row; row++)
+			{
+				convert_row(row, statevectors.subspan(row * row_size, row_size));
+			}
+		});
+	}
+
+	template <std::floating_point Scalar>
+	fst::Stabiliser_State stabiliser_from_statevector_templated(std::span<const std::complex<Scalar>> statevector, bool assume_valid, const Tolerance &tolerance)
+	{
+		std::optional<Stabiliser_State> state = assume_valid
+													? stabiliser_from_statevector_internal<true, true>(statevector, tolerance)
+													: stabiliser_from_statevector_internal<false, true>(statevector, tolerance);
+
+		if (!state)
+		{
+			throw std::invalid_argument("State was not a stabiliser state");
+		}
+
+		return *std::move(state);
+	}
+
+	template <std::floating_point Scalar>
+	fst::Stabiliser_State stabiliser_from_sparse_templated(std::span<const std::size_t> indices, std::span<const std::complex<Scalar>> amplitudes, const std::size_t number_qubits, bool assume_valid, const Tolerance &tolerance)
+	{
+		std::optional<Stabiliser_State> state = assume_valid
+													? stabiliser_from_sparse_internal<true, true>(number_qubits, indices, amplitudes, tolerance)
+													: stabiliser_from_sparse_internal<false, true>(number_qubits, indices, amplitudes, tolerance);
+
+		if (!state)
+		{
+			throw std::invalid_argument("State was not a stabiliser state");
+		}
+
+		return *std::move(state);
+	}
+
+	template <std::floating_point Scalar>
+	std::vector<std::optional<fst::Stabiliser_State>> stabiliser_from_statevector_batch_templated(std::span<const std::complex<Scalar>> statevectors, const std::size_t number_qubits, bool assume_valid, const Tolerance &tolerance)
+	{
+		if (statevectors.size() % integral_pow_2(number_qubits) != 0)
+		{
+			throw std::invalid_argument("The batch must consist of whole state vectors of length 2^number_qubits");
+		}
+
+		std::vector<std::optional<Stabiliser_State>> states(statevectors.size() / integral_pow_2(number_qubits));
+
+		for_each_row(statevectors, number_qubits, states.size(), [&](const std::size_t row, const std::span<const std::complex<Scalar>> statevector)
+		{
+			states[row] = assume_valid
+							? stabiliser_from_statevector_internal<true, true>(statevector, tolerance)
+							: stabiliser_from_statevector_internal<false, true>(statevector, tolerance);
+		});
 
-	if (!state)
+		return states;
+	}
+
+	template <std::floating_point Scalar>
+	void is_stabiliser_state_batch_templated(std::span<const std::complex<Scalar>> statevectors, const std::size_t number_qubits, std::span<bool> results, const Tolerance &tolerance)
 	{
-		throw std::invalid_argument("State was not a stabiliser state");
+		if (statevectors.size() != results.size() * integral_pow_2(number_qubits))
+		{
+			throw std::invalid_argument("The batch must consist of one state vector of length 2^number_qubits per result");
+		}
+
+		for_each_row(statevectors, number_qubits, results.size(), [&](const std::size_t row, const std::span<const std::complex<Scalar>> statevector)
+		{
+			results[row] = stabiliser_from_statevector_internal<false, false>(statevector, tolerance);
+		});
 	}
+}
+
+fst::Stabiliser_State fst::stabiliser_from_statevector(std::span<const std::complex<float>> statevector, bool assume_valid, const Tolerance &tolerance)
+{
+	return stabiliser_from_statevector_templated(statevector, assume_valid, tolerance);
+}
+
+fst::Stabiliser_State fst::stabiliser_from_statevector(std::span<const std::complex<double>> statevector, bool assume_valid, const Tolerance &tolerance)
+{
+	return stabiliser_from_statevector_templated(statevector, assume_valid, tolerance);
+}
+
+bool fst::is_stabiliser_state(std::span<const std::complex<float>> statevector, const Tolerance &tolerance)
+{
+	return stabiliser_from_statevector_internal<false, false>(statevector, tolerance);
+}
 
-	return *std::move(state);
+bool fst::is_stabiliser_state(std::span<const std::complex<double>> statevector, const Tolerance &tolerance)
+{
+	return stabiliser_from_statevector_internal<false, false>(statevector, tolerance);
+}
+
+fst::Stabiliser_State fst::stabiliser_from_statevector(std::span<const std::size_t> indices, std::span<const std::complex<float>> amplitudes, const std::size_t number_qubits, bool assume_valid, const Tolerance &tolerance)
+{
+	return stabiliser_from_sparse_templated(indices, amplitudes, number_qubits, assume_valid, tolerance);
 }
 
-bool fst::is_stabiliser_state(const std::vector<std::complex<float>> &statevector)
+fst::Stabiliser_State fst::stabiliser_from_statevector(std::span<const std::size_t> indices, std::span<const std::complex<double>> amplitudes, const std::size_t number_qubits, bool assume_valid, const Tolerance &tolerance)
 {
-	return stabiliser_from_statevector_internal<false, false>(statevector);
+	return stabiliser_from_sparse_templated(indices, amplitudes, number_qubits, assume_valid, tolerance);
 }
 
-fst::Stabiliser_State fst::stab_in_the_dark(const std::vector<std::complex<float>> &statevector)
+bool fst::is_stabiliser_state(std::span<const std::size_t> indices, std::span<const std::complex<float>> amplitudes, const std::size_t number_qubits, const Tolerance &tolerance)
+{
+	return stabiliser_from_sparse_internal<false, false>(number_qubits, indices, amplitudes, tolerance);
+}
+
+bool fst::is_stabiliser_state(std::span<const std::size_t> indices, std::span<const std::complex<double>> amplitudes, const std::size_t number_qubits, const Tolerance &tolerance)
+{
+	return stabiliser_from_sparse_internal<false, false>(number_qubits, indices, amplitudes, tolerance);
+}
+
+fst::Stabiliser_State fst::stab_in_the_dark(std::span<const std::complex<float>> statevector)
 {
 	return stabiliser_from_statevector(statevector, true);
 }
+
+std::vector<std::optional<fst::Stabiliser_State>> fst::stabiliser_from_statevector_batch(std::span<const std::complex<float>> statevectors, const std::size_t number_qubits, bool assume_valid, const Tolerance &tolerance)
+{
+	return stabiliser_from_statevector_batch_templated(statevectors, number_qubits, assume_valid, tolerance);
+}
+
+std::vector<std::optional<fst::Stabiliser_State>> fst::stabiliser_from_statevector_batch(std::span<const std::complex<double>> statevectors, const std::size_t number_qubits, bool assume_valid, const Tolerance &tolerance)
+{
+	return stabiliser_from_statevector_batch_templated(statevectors, number_qubits, assume_valid, tolerance);
+}
+
+void fst::is_stabiliser_state_batch(std::span<const std::complex<float>> statevectors, const std::size_t number_qubits, std::span<bool> results, const Tolerance &tolerance)
+{
+	is_stabiliser_state_batch_templated(statevectors, number_qubits, results, tolerance);
+}
+
+void fst::is_stabiliser_state_batch(std::span<const std::complex<double>> statevectors, const std::size_t number_qubits, std::span<bool> results, const Tolerance &tolerance)
+{
+	is_stabiliser_state_batch_templated(statevectors, number_qubits, results, tolerance);
+}
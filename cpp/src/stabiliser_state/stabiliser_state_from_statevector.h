@@ -2,22 +2,61 @@
 #define _FAST_STABILISER_STABILISER_STATE_FROM_VECTOR_H
 
 #include <complex>
+#include <optional>
+#include <span>
+#include <vector>
 
 #include "stabiliser_state.h"
+#include "util/tolerance.h"
 
 namespace fst
 {
 	/// Convert a state vector of complex amplitudes into a stabiliser state object.
 	///
 	/// Assuming valid is faster, but will result in undefined behaviour if the state vector is not in fact a
-	/// valid stabaliser state
-	Stabiliser_State stabiliser_from_statevector(const std::vector<std::complex<float>> &statevector, bool assume_valid = false);
+	/// valid stabaliser state. The tolerance sets how close to a stabiliser state the input must be. Each
+	/// function reading amplitudes takes single or double precision input, and works in that precision
+	///
+	/// The support is found in one pass over the input (vectorised with AVX2 for single precision), keeping only
+	/// the basis vectors, so no memory is allocated in proportion to the input
+	Stabiliser_State stabiliser_from_statevector(std::span<const std::complex<float>> statevector, bool assume_valid = false, const Tolerance &tolerance = {});
+	Stabiliser_State stabiliser_from_statevector(std::span<const std::complex<double>> statevector, bool assume_valid = false, const Tolerance &tolerance = {});
 
 	/// ;)
-	Stabiliser_State stab_in_the_dark(const std::vector<std::complex<float>> &statevector);
+	Stabiliser_State stab_in_the_dark(std::span<const std::complex<float>> statevector);
 
 	/// Test wheter a state vector of complex amplitudes corresponds to a stabiliser state.
-	bool is_stabiliser_state(const std::vector<std::complex<float>> &statevector);
+	bool is_stabiliser_state(std::span<const std::complex<float>> statevector, const Tolerance &tolerance = {});
+	bool is_stabiliser_state(std::span<const std::complex<double>> statevector, const Tolerance &tolerance = {});
+
+	/// Convert a sparse state vector on number_qubits qubits, with amplitudes[k] at indices[k] and zero elsewhere, into
+	/// a stabiliser state object. The indices may come in any order, and zero amplitudes are ignored. This takes time
+	/// proportional to the number of amplitudes (times a log, if the indices are not sorted), and memory proportional
+	/// to the number of indices, so works for any number of qubits up to 64.
+	///
+	/// Throws std::invalid_argument, as above, if the amplitudes are not a stabiliser state, and also if the lengths
+	/// differ, an index is repeated, or an index is not less than 2^number_qubits
+	Stabiliser_State stabiliser_from_statevector(std::span<const std::size_t> indices, std::span<const std::complex<float>> amplitudes, const std::size_t number_qubits, bool assume_valid = false, const Tolerance &tolerance = {});
+	Stabiliser_State stabiliser_from_statevector(std::span<const std::size_t> indices, std::span<const std::complex<double>> amplitudes, const std::size_t number_qubits, bool assume_valid = false, const Tolerance &tolerance = {});
+
+	/// Test whether a sparse state vector (given as for stabiliser_from_statevector) is a stabiliser state
+	bool is_stabiliser_state(std::span<const std::size_t> indices, std::span<const std::complex<float>> amplitudes, const std::size_t number_qubits, const Tolerance &tolerance = {});
+	bool is_stabiliser_state(std::span<const std::size_t> indices, std::span<const std::complex<double>> amplitudes, const std::size_t number_qubits, const Tolerance &tolerance = {});
+
+	/// Converts a batch of state vectors on number_qubits qubits, stored one after another (i.e. a row-major
+	/// batch by 2^n array), giving std::nullopt for each row that is not a stabiliser state (which, as above,
+	/// is undefined behaviour if assume_valid). The rows are split between threads with parallel_for.
+	///
+	/// Throws std::invalid_argument if the length is not a multiple of 2^number_qubits
+	std::vector<std::optional<Stabiliser_State>> stabiliser_from_statevector_batch(std::span<const std::complex<float>> statevectors, const std::size_t number_qubits, bool assume_valid = false, const Tolerance &tolerance = {});
+	std::vector<std::optional<Stabiliser_State>> stabiliser_from_statevector_batch(std::span<const std::complex<double>> statevectors, const std::size_t number_qubits, bool assume_valid = false, const Tolerance &tolerance = {});
+
+	/// Tests whether each row of a batch of state vectors (stored as for stabiliser_from_statevector_batch)
+	/// is a stabiliser state, writing one result per row into results.
+	///
+	/// Throws std::invalid_argument if the length is not results.size() * 2^number_qubits
+	void is_stabiliser_state_batch(std::span<const std::complex<float>> statevectors, const std::size_t number_qubits, std::span<bool> results, const Tolerance &tolerance = {});
+	void is_stabiliser_state_batch(std::span<const std::complex<double>> statevectors, const std::size_t number_qubits, std::span<bool> results, const Tolerance &tolerance = {});
 }
 
 #endif
\ No newline at end of file
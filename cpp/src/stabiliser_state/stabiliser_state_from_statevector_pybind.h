@@ -6,19 +6,77 @@
 #include <pybind11/stl.h>
 
 #include "stabiliser_state_from_statevector.h"
+#include "util/numpy_pybind.h"
 
 namespace py = pybind11;
 using namespace fst;
 
-// Eliminate copying by making types opaque, accept np arrays?
 namespace fst_pybind
 {
+    /// Defines the conversions reading state vectors from an Array, so they can be overloaded for complex64
+    /// and complex128 input
+    template <class Array>
+    void def_stabiliser_state_from_statevector(py::module_ &m)
+    {
+        m.def("stabiliser_state_from_statevector", [](const Array &statevector, const bool assume_valid, const Tolerance &tolerance)
+        {
+            return stabiliser_from_statevector(as_span(statevector), assume_valid, tolerance);
+        }, py::arg("statevector"), py::arg("assume_valid") = false, py::arg("tolerance") = Tolerance{}, "Converts a state vector of complex amplitudes into a stabiliser state object. Assuming valid is faster, but will result in undefined behaviour if the state vector is not in fact a valid stabiliser state. The tolerance sets how close to a stabiliser state the input must be. complex128 input is read in place and checked in double precision");
+        m.def("is_stabiliser_state", [](const Array &statevector, const Tolerance &tolerance)
+        {
+            return is_stabiliser_state(as_span(statevector), tolerance);
+        }, py::arg("statevector"), py::arg("tolerance") = Tolerance{}, "Tests whether a state vector of complex amplitudes corresponds to a stabiliser state, up to the tolerance");
+        m.def("stabiliser_state_from_statevector", [](const Index_Array &indices, const Array &amplitudes, const std::size_t number_qubits, const bool assume_valid, const Tolerance &tolerance)
+        {
+            return stabiliser_from_statevector(as_span(indices), as_span(amplitudes), number_qubits, assume_valid, tolerance);
+        }, py::arg("indices"), py::arg("amplitudes"), py::arg("number_qubits"), py::arg("assume_valid") = false, py::arg("tolerance") = Tolerance{}, "Converts a sparse state vector on number_qubits qubits (up to 64), with amplitudes[k] at indices[k] and zero elsewhere, into a stabiliser state object. The indices may be in any order. This takes time proportional to the number of amplitudes, so never builds the dense state vector. Raises ValueError if the lengths differ, an index is repeated or out of range, or the state is not a stabiliser state");
+        m.def("is_stabiliser_state", [](const Index_Array &indices, const Array &amplitudes, const std::size_t number_qubits, const Tolerance &tolerance)
+        {
+            return is_stabiliser_state(as_span(indices), as_span(amplitudes), number_qubits, tolerance);
+        }, py::arg("indices"), py::arg("amplitudes"), py::arg("number_qubits"), py::arg("tolerance") = Tolerance{}, "Tests whether a sparse state vector (given as for stabiliser_state_from_statevector) corresponds to a stabiliser state, up to the tolerance");
+        m.def("stabiliser_state_from_statevector_batch", [](const Array &statevectors, const bool assume_valid, const Tolerance &tolerance)
+        {
+            const std::size_t number_qubits = get_batch_number_qubits(statevectors);
+            std::vector<std::optional<Stabiliser_State>> states;
+            {
+                py::gil_scoped_release release;
+                states = stabiliser_from_statevector_batch(as_span(statevectors), number_qubits, assume_valid, tolerance);
+            }
+
+            py::array_t<bool> is_valid(std::vector<py::ssize_t>{static_cast<py::ssize_t>(states.size())});
+            bool *is_valid_data = is_valid.mutable_data();
+
+            for (std::size_t row = 0; row < states.size(); row++)
+            {
+                is_valid_data[row] = states[row].has_value();
+            }
+
+            return py::make_tuple(is_valid, py::cast(std::move(states)));
+        }, py::arg("statevectors"), py::arg("assume_valid") = false, py::arg("tolerance") = Tolerance{}, "Converts each row of a 2 dimensional array of state vectors (one of length 2^n per row) into a stabiliser state, splitting the rows between threads. Returns a tuple (is_valid, states) of a numpy bool array, and a list holding a Stabiliser_State for each valid row and None otherwise. Assuming valid is faster, but will result in undefined behaviour if a row is not in fact a valid stabiliser state");
+        m.def("is_stabiliser_state_batch", [](const Array &statevectors, const Tolerance &tolerance)
+        {
+            const std::size_t number_qubits = get_batch_number_qubits(statevectors);
+            py::array_t<bool> results(std::vector<py::ssize_t>{statevectors.shape(0)});
+            std::span<bool> results_span(results.mutable_data(), static_cast<std::size_t>(statevectors.shape(0)));
+            {
+                py::gil_scoped_release release;
+                is_stabiliser_state_batch(as_span(statevectors), number_qubits, results_span, tolerance);
+            }
+
+            return results;
+        }, py::arg("statevectors"), py::arg("tolerance") = Tolerance{}, "Tests whether each row of a 2 dimensional array of state vectors (one of length 2^n per row) is a stabiliser state, splitting the rows between threads. Returns a numpy bool array with one entry per row");
+    }
+
     void init_stabiliser_state_from_statevector(py::module_ &m)
     {
-        m.def("stabiliser_state_from_statevector", &stabiliser_from_statevector, py::arg("statevector"), py::arg("assume_valid") = false, "Converts a state vector of complex amplitudes into a stabiliser state object. Assuming valid is faster, but will result in undefined behaviour if the state vector is not in fact a valid stabiliser state");
-        m.def("is_stabiliser_state", &is_stabiliser_state, py::arg("statevector"), "Tests whether a state vector of complex amplitudes corresponds to a stabiliser state");
-        m.def("stab_in_the_dark", &stab_in_the_dark, py::arg("statevector"), ";)");
+        def_stabiliser_state_from_statevector<Complex_Array>(m);
+        def_stabiliser_state_from_statevector<Double_Complex_Array>(m);
+
+        m.def("stab_in_the_dark", [](const Complex_Array &statevector)
+        {
+            return stab_in_the_dark(as_span(statevector));
+        }, py::arg("statevector"), ";)");
     }
 }
 
-#endif
\ No newline at end of file
+#endif
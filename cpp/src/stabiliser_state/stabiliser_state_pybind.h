@@ -6,6 +6,12 @@
 #include <pybind11/stl.h>
 
 #include "stabiliser_state.h"
+#include "util/f2_vector_pybind.h"
+#include "util/numpy_pybind.h"
+#include "util/random_pybind.h"
+
+#include <cstdint>
+#include <optional>
 
 namespace py = pybind11;
 using namespace fst;
@@ -16,21 +22,114 @@ namespace fst_pybind
 {
     void init_stabiliser_state(py::module_ &m)
     {
+        py::class_<Affine_Space>(m, "Affine_Space")
+            .def_readonly("number_qubits", &Affine_Space::number_qubits, "int\t\tThe number of qubits")
+            .def_readonly("shift", &Affine_Space::shift, "int\t\tA constant vector that shifts the vector space to the affine space")
+            .def_readonly("basis_vectors", &Affine_Space::basis_vectors, "list[int]\tIndependent basis vectors for the vector space")
+            .doc() = "The affine space shift + span(basis_vectors) of bit strings on number_qubits qubits";
+
         py::class_<Stabiliser_State>(m, "Stabiliser_State")
             .def_readwrite("number_qubits", &Stabiliser_State::number_qubits, "int\t\tThe number of qubits")
             .def_readwrite("basis_vectors", &Stabiliser_State::basis_vectors, "list[int]\tBasis vectors for the vector space")
-            .def_readwrite("dim", &Stabiliser_State::dim, "int\t\tThe dimension of the vector space")
+            .def_readwrite("dim", &Stabiliser_State::dim, "int\t\tThe dimension of the vector space. basis_vectors and quadratic_form must have dim entries, which everything reading them checks (raising ValueError)")
             .def_readwrite("shift", &Stabiliser_State::shift, "int\t\tA constant vector that shifts the vector space to the affine space")
             .def_readwrite("real_linear_part", &Stabiliser_State::real_linear_part, "int\t\tThe diagonal part of the quadratic form")
             .def_readwrite("imaginary_part", &Stabiliser_State::imaginary_part, "int\t\tThe linear form")
-            .def_readwrite("quadratic_form", &Stabiliser_State::quadratic_form, "dict[int]\tThe (rest of the) quadratic form. The quadratic form is stored as a map. It should always have quadratic_form[0] = 0. Q(e_i, e_j) is stored as quadratic_form[2^i ^ 2^j]")
+            .def_readwrite("quadratic_form", &Stabiliser_State::quadratic_form, "list[int]\tThe (rest of the) quadratic form, as a symmetric bit matrix with one row per basis vector. Q(e_i, e_j) is bit j of quadratic_form[i], and the diagonal is always zero")
             .def_readwrite("global_phase", &Stabiliser_State::global_phase, "complex\t\tThe global phase")
             .def_readwrite("row_reduced", &Stabiliser_State::row_reduced, "bool\t\tWhether the matrix of basis vectors is row reduced")
             .def(py::init<const std::size_t>(), "number_qubits"_a) // TODO: Do we want this?
             .def(py::init<Check_Matrix &>(), "check_matrix"_a)
-            .def("get_state_vector", &Stabiliser_State::get_state_vector, "Returns the state vector of length 2^n of the stabiliser state (with respect to the computational basis), as type list[complex]")
+            .def("get_state_vector", [](const Stabiliser_State &state, const py::object &out)
+            {
+                return write_array({py::ssize_t(1) << state.number_qubits}, out, [&](const auto state_vector) { state.get_state_vector(state_vector); });
+            }, "out"_a = py::none(), "Returns the state vector of length 2^n of the stabiliser state (with respect to the computational basis), as a complex64 numpy array. If out (a C-contiguous complex64 or complex128 array of length 2^n) is given, the state vector is written into it instead, in that precision")
+            .def("get_sparse_state_vector", [](const Stabiliser_State &state)
+            {
+                return sparse_to_numpy([&] { return state.get_sparse_state_vector(); });
+            }, "Returns the 2^dim non-zero amplitudes of the state as a tuple (indices, amplitudes) of a uint64 and a complex64 numpy array, with amplitudes[k] at indices[k]. Nothing of size 2^n is built, so this works for states on up to 64 qubits. The indices are not sorted")
+            .def("sample", [](const Stabiliser_State &state, const std::size_t number_shots, const std::optional<std::uint64_t> seed, const bool packed) -> py::array
+            {
+                const std::uint64_t stream_seed = get_seed(seed);
+
+                std::vector<std::size_t> shots;
+                {
+                    py::gil_scoped_release release;
+                    shots = state.sample(number_shots, stream_seed);
+                }
+
+                if (packed)
+                {
+                    return to_numpy(std::move(shots), {static_cast<py::ssize_t>(number_shots)});
+                }
+
+                py::array_t<std::uint8_t> bits(std::vector<py::ssize_t>{static_cast<py::ssize_t>(number_shots), static_cast<py::ssize_t>(state.number_qubits)});
+                std::uint8_t *bits_data = bits.mutable_data();
+
+                for (std::size_t shot = 0; shot < number_shots; shot++)
+                {
+                    for (std::size_t qubit = 0; qubit < state.number_qubits; qubit++)
+                    {
+                        bits_data[shot * state.number_qubits + qubit] = bit_set_at(shots[shot], qubit);
+                    }
+                }
+
+                return bits;
+            }, "number_shots"_a, "seed"_a = py::none(), "packed"_a = true, "Returns number_shots computational basis measurement outcomes of the state, sampled uniformly from its affine support without building the state vector, and split between threads. If packed, this is a uint64 numpy array with one outcome per entry (bit q for qubit q), and otherwise a uint8 array of shape (number_shots, number_qubits) of the bits. The same seed always gives the same outcomes; if seed is None, one is drawn from std::random_device")
+            .def("measure", [](Stabiliser_State &state, const Pauli &pauli, const std::optional<bool> outcome, const std::optional<std::uint64_t> seed)
+            {
+                if (outcome)
+                {
+                    return state.measure(pauli, *outcome);
+                }
+
+                Random_Generator generator = make_generator(seed);
+
+                return state.measure(pauli, generator);
+            }, "pauli"_a, "outcome"_a = py::none(), "seed"_a = py::none(), "Measures a Hermitian Pauli P, leaving the state in the (-1)^outcome eigenspace of P, and returns a Measurement_Result. If P (up to sign) is in the stabiliser group the outcome is deterministic and the state is unchanged. Otherwise the outcome is the given one (post-selecting on it), or if outcome is None it is uniformly random, drawn from seed (or std::random_device if seed is None). Raises ValueError if P is not Hermitian or is on a different number of qubits. The state is updated in place, including its global phase: for a random outcome it becomes (I + (-1)^outcome P)|psi> / sqrt(2)")
+            .def("get_marginal_support", &Stabiliser_State::get_marginal_support, "qubit_mask"_a, "Returns the Affine_Space on which the marginal distribution of computational basis measurements of the qubits in qubit_mask is uniform, in polynomial time. Qubit q of the mask becomes qubit k of the result when it is the k-th qubit of the mask, counting from the lowest")
+            .def("get_marginal_probabilities", [](const Stabiliser_State &state, const std::size_t qubit_mask)
+            {
+                return to_numpy(state.get_marginal_probabilities(qubit_mask), {py::ssize_t(1) << std::popcount(qubit_mask)});
+            }, "qubit_mask"_a, "Returns the marginal distribution of computational basis measurements of the k qubits in qubit_mask, as a float32 numpy array of the 2^k probabilities of the outcomes (numbered as for get_marginal_support). This takes time polynomial in the number of qubits, plus 2^k")
+            .def("get_amplitude", &Stabiliser_State::get_amplitude, "x"_a, "Returns the amplitude <x|psi> of the computational basis state x (zero if x is outside the support), without building the state vector")
+            .def("get_amplitudes", [](const Stabiliser_State &state, const Index_Array &xs, const py::object &out)
+            {
+                return write_array({py::ssize_t(xs.size())}, out, [&](const auto amplitudes) { state.get_amplitudes(as_span(xs), amplitudes); });
+            }, "xs"_a, "out"_a = py::none(), "Returns the amplitudes <x|psi> of each of the computational basis states xs (cast to uint64), as a complex64 numpy array. If out (a C-contiguous complex64 or complex128 array of the same length as xs) is given, the amplitudes are written into it instead, in that precision")
+            .def("get_expectation_value", &Stabiliser_State::get_expectation_value, "pauli"_a, "Returns the expectation value <psi|P|psi> of a Hermitian Pauli P, which is +1 or -1 if +P or -P is in the stabiliser group and 0 otherwise, in polynomial time. Raises ValueError if P is not Hermitian or is on a different number of qubits")
+            .def("get_expectation_values", [](const Stabiliser_State &state, const std::vector<Pauli> &paulis)
+            {
+                std::vector<int> values;
+                {
+                    py::gil_scoped_release release;
+                    values = state.get_expectation_values(paulis);
+                }
+
+                return to_numpy(std::move(values), {static_cast<py::ssize_t>(paulis.size())});
+            }, "paulis"_a, "Returns the expectation values of each of a list of Hermitian Paulis as an int numpy array, as for get_expectation_value. The basis is reduced once, and the Paulis are split between threads")
+            .def("get_quadratic_form", &Stabiliser_State::get_quadratic_form, "i"_a, "j"_a, "Returns Q(e_i, e_j), as a bool. Raises IndexError if i or j is not less than dim")
+            .def("set_quadratic_form", &Stabiliser_State::set_quadratic_form, "i"_a, "j"_a, "value"_a, "Sets Q(e_i, e_j) (and so Q(e_j, e_i)) to value. i and j must be different, and less than dim (raising IndexError otherwise)")
             .def("row_reduce_basis", &Stabiliser_State::row_reduce_basis, "Row reduces the basis to reduced row-echelon form. Note that the quadratic form and the real and imaginary linear parts are also updated, so the instance represents the same stabiliser state")
             .doc() = "The class used to represent a stabiliser state. The state is stored using the ideas of Dehaene & De Moore, as an affine space, and a quadratic and linear form over that space. More precisely, it is stored as a list of basis vectors for a vector space, a constant vector that is added to every element of the vector space to reach, the affine space, and a quadratic and linear form defined on the vector space";
+
+        py::class_<Wide_Stabiliser_State>(m, "Wide_Stabiliser_State")
+            .def_readwrite("number_qubits", &Wide_Stabiliser_State::number_qubits, "int\t\tThe number of qubits")
+            .def_readwrite("basis_vectors", &Wide_Stabiliser_State::basis_vectors, "list[int]\tBasis vectors for the vector space")
+            .def_readwrite("dim", &Wide_Stabiliser_State::dim, "int\t\tThe dimension of the vector space")
+            .def_readwrite("shift", &Wide_Stabiliser_State::shift, "int\t\tA constant vector that shifts the vector space to the affine space")
+            .def_readwrite("real_linear_part", &Wide_Stabiliser_State::real_linear_part, "int\t\tThe diagonal part of the quadratic form")
+            .def_readwrite("imaginary_part", &Wide_Stabiliser_State::imaginary_part, "int\t\tThe linear form")
+            .def_readwrite("quadratic_form", &Wide_Stabiliser_State::quadratic_form, "list[int]\tThe (rest of the) quadratic form, as for Stabiliser_State")
+            .def_readwrite("global_phase", &Wide_Stabiliser_State::global_phase, "complex\t\tThe global phase")
+            .def_readwrite("row_reduced", &Wide_Stabiliser_State::row_reduced, "bool\t\tWhether the matrix of basis vectors is row reduced")
+            .def(py::init<const std::size_t>(), "number_qubits"_a)
+            .def(py::init<Wide_Check_Matrix &>(), "check_matrix"_a)
+            .def("get_quadratic_form", &Wide_Stabiliser_State::get_quadratic_form, "i"_a, "j"_a, "Returns Q(e_i, e_j), as for Stabiliser_State")
+            .def("set_quadratic_form", &Wide_Stabiliser_State::set_quadratic_form, "i"_a, "j"_a, "value"_a, "Sets Q(e_i, e_j), as for Stabiliser_State")
+            .def("row_reduce_basis", &Wide_Stabiliser_State::row_reduce_basis, "Row reduces the basis, as for Stabiliser_State")
+            .def("__eq__", &Wide_Stabiliser_State::operator==)
+            .doc() = "A stabiliser state on any number of qubits, as for Stabiliser_State, with its bit vectors as Python ints of any size. The methods reading amplitudes, sampling and measuring are only on Stabiliser_State; convert to a Wide_Check_Matrix to measure";
     }
 }
 
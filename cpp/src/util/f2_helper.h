@@ -1,6 +1,7 @@
 #ifndef _FAST_STABILISER_F2_HELPER_H
 #define _FAST_STABILISER_F2_HELPER_H
 
+#include <array>
 #include <bit>
 #include <complex>
 #include <concepts>
@@ -87,6 +88,18 @@ namespace fst
 		const unsigned int dot_product = f2_dot_product(x, y);
 		return {float_not(dot_product), static_cast<float>(dot_product)};
 	}
+
+	/// The powers of i: i^k is powers_of_i[k] for k in Z_4. Phases that are powers of i
+	/// are tracked as exponents in Z_4, and only looked up here when an amplitude is written
+	inline constexpr std::array<std::complex<float>, 4> powers_of_i {{ {1, 0}, {0, 1}, {-1, 0}, {0, -1} }};
+
+	/// Returns the table of scale * i^k for k in Z_4 (in the precision of scale). Multiplying by a
+	/// power of i only swaps and negates the components, so each entry is exact
+	template <std::floating_point T>
+	constexpr std::array<std::complex<T>, 4> scaled_powers_of_i(const std::complex<T> scale) noexcept
+	{
+		return {scale, {-scale.imag(), scale.real()}, -scale, {scale.imag(), -scale.real()}};
+	}
 }
 
 #endif
\ No newline at end of file
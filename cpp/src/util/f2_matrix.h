@@ -0,0 +1,422 @@
+#ifndef _FAST_STABILISER_F2_MATRIX_H
+#define _FAST_STABILISER_F2_MATRIX_H
+
+#include "f2_helper.h"
+#include "f2_vector.h"
+
+#include <algorithm>
+#include <bit>
+#include <concepts>
+#include <numeric>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace fst
+{
+	/// A dense matrix over F_2. Each row is bit-packed into 64-bit words (as for F2_Vector), and
+	/// all the rows are stored in one contiguous buffer, so adding one row to another is a short
+	/// run of word XORs with no indirection.
+	class F2_Matrix
+	{
+		public:
+		using word_type = F2_Vector::word_type;
+		static constexpr std::size_t word_size = F2_Vector::word_size;
+
+		F2_Matrix() = default;
+
+		F2_Matrix(const std::size_t number_rows, const std::size_t number_columns)
+			: number_rows(number_rows), number_columns(number_columns), words_per_row(F2_Vector::number_words_for(number_columns)),
+			  word_storage(number_rows * words_per_row, 0)
+		{}
+
+		static F2_Matrix identity(const std::size_t size)
+		{
+			F2_Matrix matrix(size, size);
+
+			for (std::size_t i = 0; i < size; i++)
+			{
+				matrix.flip(i, i);
+			}
+
+			return matrix;
+		}
+
+		std::size_t rows() const noexcept { return number_rows; }
+		std::size_t columns() const noexcept { return number_columns; }
+		std::size_t row_words() const noexcept { return words_per_row; }
+
+		std::span<word_type> row(const std::size_t row_index) noexcept
+		{
+			return {word_storage.data() + row_index * words_per_row, words_per_row};
+		}
+
+		std::span<const word_type> row(const std::size_t row_index) const noexcept
+		{
+			return {word_storage.data() + row_index * words_per_row, words_per_row};
+		}
+
+		bool get(const std::size_t row_index, const std::size_t column) const noexcept
+		{
+			return bit_set_at(word_storage[row_index * words_per_row + column / word_size], column % word_size);
+		}
+
+		void flip(const std::size_t row_index, const std::size_t column) noexcept
+		{
+			word_storage[row_index * words_per_row + column / word_size] ^= word_type(1) << (column % word_size);
+		}
+
+		void set(const std::size_t row_index, const std::size_t column, const bool value) noexcept
+		{
+			if (get(row_index, column) != value)
+			{
+				flip(row_index, column);
+			}
+		}
+
+		/// Returns number_bits (at most 64) consecutive entries of the row, starting at column
+		/// first_column, as the bits of a word
+		word_type get_bits(const std::size_t row_index, const std::size_t first_column, const std::size_t number_bits) const noexcept
+		{
+			const word_type *words = word_storage.data() + row_index * words_per_row + first_column / word_size;
+			const std::size_t offset = first_column % word_size;
+
+			word_type bits = words[0] >> offset;
+
+			if (offset + number_bits > word_size)
+			{
+				bits |= words[1] << (word_size - offset);
+			}
+
+			return number_bits == word_size ? bits : bits & ((word_type(1) << number_bits) - 1);
+		}
+
+		/// Adds (XORs) row source into row target
+		void add_row(const std::size_t source, const std::size_t target) noexcept
+		{
+			const word_type *source_words = word_storage.data() + source * words_per_row;
+			word_type *target_words = word_storage.data() + target * words_per_row;
+
+			for (std::size_t i = 0; i < words_per_row; i++)
+			{
+				target_words[i] ^= source_words[i];
+			}
+		}
+
+		/// Writes the first number_bits entries of bits into the row, starting at column first_column.
+		/// first_column must be a multiple of 64.
+		template <f2_vector_like Bits>
+		void set_row_bits(const std::size_t row_index, const std::size_t first_column, const std::size_t number_bits, const Bits &bits) noexcept
+		{
+			word_type *words = word_storage.data() + row_index * words_per_row + first_column / word_size;
+
+			if constexpr (std::unsigned_integral<Bits>)
+			{
+				words[0] = static_cast<word_type>(bits);
+			}
+			else
+			{
+				const std::size_t number_words = std::min(bits.number_words(), F2_Vector::number_words_for(number_bits));
+				std::copy_n(bits.words().begin(), number_words, words);
+			}
+		}
+
+		/// Reads number_bits entries of the row, starting at column first_column, into an F_2 vector.
+		/// first_column must be a multiple of 64.
+		template <f2_vector_like Bits>
+		Bits get_row_bits(const std::size_t row_index, const std::size_t first_column, const std::size_t number_bits) const
+		{
+			const word_type *words = word_storage.data() + row_index * words_per_row + first_column / word_size;
+
+			if constexpr (std::unsigned_integral<Bits>)
+			{
+				return static_cast<Bits>(words[0]);
+			}
+			else
+			{
+				F2_Vector bits = F2_Vector::zeros(number_bits);
+				std::copy_n(words, bits.number_words(), bits.words().begin());
+				return bits;
+			}
+		}
+
+		F2_Matrix transpose() const
+		{
+			F2_Matrix transposed(number_columns, number_rows);
+
+			for (std::size_t i = 0; i < number_rows; i++)
+			{
+				for (std::size_t j = 0; j < number_columns; j++)
+				{
+					if (get(i, j))
+					{
+						transposed.flip(j, i);
+					}
+				}
+			}
+
+			return transposed;
+		}
+
+		/// Matrix product over F_2: row i of the result is the sum of the rows of rhs picked out
+		/// by the entries of row i of lhs
+		friend F2_Matrix operator*(const F2_Matrix &lhs, const F2_Matrix &rhs)
+		{
+			F2_Matrix product(lhs.number_rows, rhs.number_columns);
+
+			for (std::size_t i = 0; i < lhs.number_rows; i++)
+			{
+				word_type *product_words = product.word_storage.data() + i * product.words_per_row;
+
+				for (std::size_t k = 0; k < lhs.number_columns; k++)
+				{
+					if (lhs.get(i, k))
+					{
+						const word_type *rhs_words = rhs.word_storage.data() + k * rhs.words_per_row;
+
+						for (std::size_t w = 0; w < rhs.words_per_row; w++)
+						{
+							product_words[w] ^= rhs_words[w];
+						}
+					}
+				}
+			}
+
+			return product;
+		}
+
+		bool operator==(const F2_Matrix &other) const = default;
+
+		private:
+		std::size_t number_rows = 0;
+		std::size_t number_columns = 0;
+		std::size_t words_per_row = 0;
+		std::vector<word_type> word_storage;
+	};
+
+	/// Combines two rows of an F2_Matrix by adding them, the default row operation for row_reduce
+	struct Add_Rows
+	{
+		void operator()(std::span<F2_Matrix::word_type> target, std::span<const F2_Matrix::word_type> source) const noexcept
+		{
+			for (std::size_t i = 0; i < target.size(); i++)
+			{
+				target[i] ^= source[i];
+			}
+		}
+	};
+
+	/// Below this many rows, row_reduce uses plain Gauss-Jordan elimination
+	inline constexpr std::size_t four_russians_minimum_rows = 128;
+
+	/// Row reduces the given rows of the matrix, so that every row is either zero in all of the
+	/// pivot_columns, or has a pivot: a column in pivot_columns where it is the only row (of those
+	/// given) with a 1. pivot_columns must be in descending order, and the pivots are the leading
+	/// columns of the row space in that order, so the result is in reduced row echelon form (up to
+	/// the order of the rows).
+	///
+	/// Returns the pivot column of each of the rows (in the order given), or -1 if it has none.
+	/// Rows are reduced in place and are not reordered.
+	///
+	/// combine_rows(target, source) is called for every row operation, and must update target to the
+	/// "sum" of target and source. It must at least add the rows over F_2, but may track other data
+	/// stored alongside the bits (e.g. the phase of a Pauli), as long as the operation is associative
+	/// and commutative.
+	///
+	/// This uses the Method of Four Russians: the pivot columns are handled k at a time, and each row
+	/// is cleared on all k columns at once with a single row operation, by looking up the combination
+	/// of the k pivot rows it needs in a table of all 2^k such combinations. Small matrices (fewer
+	/// than four_russians_minimum_rows rows) use ordinary Gauss-Jordan elimination instead.
+	template <class Combine_Rows = Add_Rows>
+	std::vector<int> row_reduce(F2_Matrix &matrix, const std::span<const std::size_t> rows, const std::span<const std::size_t> pivot_columns, Combine_Rows combine_rows = {})
+	{
+		using word_type = F2_Matrix::word_type;
+
+		const std::size_t number_rows = rows.size();
+		std::vector<int> pivots(number_rows, -1);
+
+		if (number_rows == 0)
+		{
+			return pivots;
+		}
+
+		// For small matrices building the tables costs more than it saves, so use plain Gauss-Jordan,
+		// finding each row's pivot as its highest set bit among the pivot columns
+		if (number_rows < four_russians_minimum_rows)
+		{
+			std::vector<word_type> column_mask(matrix.row_words(), 0);
+
+			for (const std::size_t column : pivot_columns)
+			{
+				column_mask[column / F2_Matrix::word_size] |= word_type(1) << (column % F2_Matrix::word_size);
+			}
+
+			for (std::size_t r = 0; r < number_rows; r++)
+			{
+				const auto row = std::as_const(matrix).row(rows[r]);
+				std::size_t word = column_mask.size();
+
+				while (word > 0 && (row[word - 1] & column_mask[word - 1]) == 0)
+				{
+					word--;
+				}
+
+				if (word == 0)
+				{
+					continue;
+				}
+
+				const std::size_t column = (word - 1) * F2_Matrix::word_size + integral_log_2(row[word - 1] & column_mask[word - 1]);
+
+				for (std::size_t other = 0; other < number_rows; other++)
+				{
+					if (other != r && matrix.get(rows[other], column))
+					{
+						combine_rows(matrix.row(rows[other]), row);
+					}
+				}
+
+				pivots[r] = static_cast<int>(column);
+			}
+
+			return pivots;
+		}
+
+		// Four Russians block size: larger blocks need fewer passes over the rows, but a bigger table
+		const std::size_t block_size = std::clamp<std::size_t>(static_cast<std::size_t>(integral_log_2(number_rows)), 1, 8);
+
+		std::vector<std::size_t> candidates(number_rows);
+		std::iota(candidates.begin(), candidates.end(), 0);
+
+		std::vector<word_type> block_bits(number_rows);
+		std::vector<word_type> candidate_bits;
+		std::vector<std::size_t> block_pivot_rows;
+		std::vector<std::size_t> block_pivot_bits;
+		std::vector<std::size_t> pivot_row_at_bit(block_size);
+		std::vector<bool> is_block_pivot(number_rows, false);
+		F2_Matrix table(integral_pow_2(block_size), matrix.columns());
+
+		for (std::size_t block_start = 0; block_start < pivot_columns.size() && !candidates.empty(); block_start += block_size)
+		{
+			const auto block = pivot_columns.subspan(block_start, std::min(block_size, pivot_columns.size() - block_start));
+
+			// The bits of each row on the block's columns. Bit t is column block[t], unless the block is
+			// a run of descending columns, when the bits can be read straight out of the row
+			const std::size_t lowest_column = block.back();
+			const bool contiguous = block.front() == lowest_column + block.size() - 1
+				&& std::adjacent_find(block.begin(), block.end(), [](const std::size_t a, const std::size_t b) { return a != b + 1; }) == block.end();
+
+			const auto bit_of = [&](const std::size_t t) { return contiguous ? block[t] - lowest_column : t; };
+
+			for (std::size_t r = 0; r < number_rows; r++)
+			{
+				if (contiguous)
+				{
+					block_bits[r] = matrix.get_bits(rows[r], lowest_column, block.size());
+				}
+				else
+				{
+					block_bits[r] = 0;
+
+					for (std::size_t t = 0; t < block.size(); t++)
+					{
+						block_bits[r] |= word_type(matrix.get(rows[r], block[t])) << t;
+					}
+				}
+			}
+
+			// Find the pivots by eliminating on just the block's bits of the candidate rows
+			candidate_bits.clear();
+
+			for (const std::size_t candidate : candidates)
+			{
+				candidate_bits.push_back(block_bits[candidate]);
+			}
+
+			word_type pivot_mask = 0;
+			block_pivot_rows.clear();
+			block_pivot_bits.clear();
+
+			for (std::size_t t = 0; t < block.size(); t++)
+			{
+				const std::size_t bit = bit_of(t);
+				const auto pivot = std::find_if(candidate_bits.begin(), candidate_bits.end(), [bit](const word_type bits) { return bit_set_at(bits, bit); });
+
+				if (pivot == candidate_bits.end())
+				{
+					continue;
+				}
+
+				const word_type pivot_bits = *pivot;
+
+				// This also clears the pivot's own bits, so it is not picked again
+				for (auto &bits : candidate_bits)
+				{
+					bits ^= pivot_bits * bit_set_at(bits, bit);
+				}
+
+				const std::size_t pivot_row = candidates[pivot - candidate_bits.begin()];
+
+				pivot_mask |= integral_pow_2(bit);
+				pivot_row_at_bit[bit] = pivot_row;
+				is_block_pivot[pivot_row] = true;
+				block_pivot_rows.push_back(pivot_row);
+				block_pivot_bits.push_back(bit);
+				pivots[pivot_row] = static_cast<int>(block[t]);
+			}
+
+			if (pivot_mask == 0)
+			{
+				continue;
+			}
+
+			// Reduce the pivot rows against each other, so each is zero on the other pivot columns of the block
+			for (std::size_t i = 0; i < block_pivot_rows.size(); i++)
+			{
+				const std::size_t pivot_row = block_pivot_rows[i];
+
+				for (const std::size_t other_row : block_pivot_rows)
+				{
+					if (other_row != pivot_row && bit_set_at(block_bits[other_row], block_pivot_bits[i]))
+					{
+						combine_rows(matrix.row(rows[other_row]), std::as_const(matrix).row(rows[pivot_row]));
+						block_bits[other_row] ^= block_bits[pivot_row];
+					}
+				}
+			}
+
+			// Table of every combination of the pivot rows, indexed by the block bits they cover
+			std::fill(table.row(0).begin(), table.row(0).end(), 0);
+
+			// (subsets of the pivot mask are visited in increasing order, so smaller entries are always ready)
+			for (word_type subset = (word_type(0) - pivot_mask) & pivot_mask; subset != 0; subset = (subset - pivot_mask) & pivot_mask)
+			{
+				const std::size_t lowest_bit = std::countr_zero(subset);
+				const auto smaller_entry = std::as_const(table).row(subset ^ integral_pow_2(lowest_bit));
+
+				std::copy(smaller_entry.begin(), smaller_entry.end(), table.row(subset).begin());
+				combine_rows(table.row(subset), std::as_const(matrix).row(rows[pivot_row_at_bit[lowest_bit]]));
+			}
+
+			// Clear the block's pivot columns from every other row, with one table lookup each
+			for (std::size_t r = 0; r < number_rows; r++)
+			{
+				if (!is_block_pivot[r])
+				{
+					combine_rows(matrix.row(rows[r]), std::as_const(table).row(block_bits[r] & pivot_mask));
+				}
+			}
+
+			for (const std::size_t pivot_row : block_pivot_rows)
+			{
+				is_block_pivot[pivot_row] = false;
+			}
+
+			std::erase_if(candidates, [&pivots](const std::size_t candidate) { return pivots[candidate] != -1; });
+		}
+
+		return pivots;
+	}
+}
+
+#endif
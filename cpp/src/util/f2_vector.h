@@ -0,0 +1,320 @@
+#ifndef _FAST_STABILISER_F2_VECTOR_H
+#define _FAST_STABILISER_F2_VECTOR_H
+
+#include "f2_helper.h"
+
+#include <algorithm>
+#include <bit>
+#include <concepts>
+#include <cstdint>
+#include <functional>
+#include <span>
+#include <vector>
+
+namespace fst
+{
+	/// A bit-packed F_2 vector of arbitrary length, used in place of a single std::size_t
+	/// when working on more than 64 qubits. Entry i is bit (i % 64) of word (i / 64).
+	///
+	/// Words beyond the end of the storage are treated as zero, so vectors of different
+	/// lengths can be combined freely (the storage grows when needed), and equality
+	/// ignores trailing zero words.
+	class F2_Vector
+	{
+		public:
+		using word_type = std::uint64_t;
+		static constexpr std::size_t word_size = 64;
+
+		F2_Vector() = default;
+
+		/// The vector with no entries set, with storage for number_bits entries
+		static F2_Vector zeros(const std::size_t number_bits)
+		{
+			F2_Vector vector;
+			vector.word_storage.resize(number_words_for(number_bits), 0);
+			return vector;
+		}
+
+		/// The vector whose first 64 entries are the bits of word
+		static F2_Vector from_word(const word_type word)
+		{
+			F2_Vector vector;
+			vector.word_storage.push_back(word);
+			return vector;
+		}
+
+		/// The vector with a single 1 at index index
+		static F2_Vector unit(const std::size_t index)
+		{
+			F2_Vector vector = zeros(index + 1);
+			vector.set(index);
+			return vector;
+		}
+
+		static constexpr std::size_t number_words_for(const std::size_t number_bits) noexcept
+		{
+			return (number_bits + word_size - 1) / word_size;
+		}
+
+		std::size_t number_words() const noexcept { return word_storage.size(); }
+		std::span<word_type> words() noexcept { return word_storage; }
+		std::span<const word_type> words() const noexcept { return word_storage; }
+
+		bool test(const std::size_t index) const noexcept
+		{
+			const std::size_t word_index = index / word_size;
+			return word_index < word_storage.size() && bit_set_at(word_storage[word_index], index % word_size);
+		}
+
+		void set(const std::size_t index, const bool value = true)
+		{
+			if (test(index) != value)
+			{
+				flip(index);
+			}
+		}
+
+		void flip(const std::size_t index)
+		{
+			grow_to(index / word_size + 1);
+			word_storage[index / word_size] ^= word_type(1) << (index % word_size);
+		}
+
+		/// Returns whether every entry is zero
+		bool none() const noexcept
+		{
+			return std::all_of(word_storage.begin(), word_storage.end(), [](const word_type word) { return word == 0; });
+		}
+
+		/// The index of the last non-zero entry, or -1 if the vector is zero
+		int highest_set_bit() const noexcept
+		{
+			for (std::size_t i = word_storage.size(); i-- > 0;)
+			{
+				if (word_storage[i] != 0)
+				{
+					return static_cast<int>(i * word_size) + integral_log_2(word_storage[i]);
+				}
+			}
+
+			return -1;
+		}
+
+		std::size_t popcount() const noexcept
+		{
+			std::size_t count = 0;
+
+			for (const word_type word : word_storage)
+			{
+				count += std::popcount(word);
+			}
+
+			return count;
+		}
+
+		F2_Vector &operator^=(const F2_Vector &other)
+		{
+			grow_to(other.word_storage.size());
+
+			for (std::size_t i = 0; i < other.word_storage.size(); i++)
+			{
+				word_storage[i] ^= other.word_storage[i];
+			}
+
+			return *this;
+		}
+
+		F2_Vector &operator|=(const F2_Vector &other)
+		{
+			grow_to(other.word_storage.size());
+
+			for (std::size_t i = 0; i < other.word_storage.size(); i++)
+			{
+				word_storage[i] |= other.word_storage[i];
+			}
+
+			return *this;
+		}
+
+		F2_Vector &operator&=(const F2_Vector &other) noexcept
+		{
+			const std::size_t common_words = std::min(word_storage.size(), other.word_storage.size());
+
+			for (std::size_t i = 0; i < common_words; i++)
+			{
+				word_storage[i] &= other.word_storage[i];
+			}
+
+			std::fill(word_storage.begin() + common_words, word_storage.end(), 0);
+
+			return *this;
+		}
+
+		friend F2_Vector operator^(F2_Vector lhs, const F2_Vector &rhs) { return lhs ^= rhs; }
+		friend F2_Vector operator|(F2_Vector lhs, const F2_Vector &rhs) { return lhs |= rhs; }
+		friend F2_Vector operator&(F2_Vector lhs, const F2_Vector &rhs) { return lhs &= rhs; }
+
+		bool operator==(const F2_Vector &other) const noexcept
+		{
+			const std::size_t common_words = std::min(word_storage.size(), other.word_storage.size());
+
+			return std::equal(word_storage.begin(), word_storage.begin() + common_words, other.word_storage.begin())
+				&& std::all_of(word_storage.begin() + common_words, word_storage.end(), [](const word_type word) { return word == 0; })
+				&& std::all_of(other.word_storage.begin() + common_words, other.word_storage.end(), [](const word_type word) { return word == 0; });
+		}
+
+		private:
+		std::vector<word_type> word_storage;
+
+		void grow_to(const std::size_t number_words)
+		{
+			if (word_storage.size() < number_words)
+			{
+				word_storage.resize(number_words, 0);
+			}
+		}
+	};
+
+	/// The types that can be used to store an F_2 vector: a single unsigned integer (for up
+	/// to 64 entries), or an F2_Vector
+	template <class T>
+	concept f2_vector_like = std::unsigned_integral<T> || std::same_as<T, F2_Vector>;
+
+	/// Returns the vector with a single 1 at index index, i.e. 2^index for integers
+	template <f2_vector_like Bits>
+	Bits unit_vector(const std::size_t index)
+	{
+		if constexpr (std::unsigned_integral<Bits>)
+		{
+			return integral_pow_2(static_cast<Bits>(index));
+		}
+		else
+		{
+			return F2_Vector::unit(index);
+		}
+	}
+
+	/// Returns the zero vector with room for number_bits entries
+	template <f2_vector_like Bits>
+	Bits zero_vector(const std::size_t number_bits)
+	{
+		if constexpr (std::unsigned_integral<Bits>)
+		{
+			return 0;
+		}
+		else
+		{
+			return F2_Vector::zeros(number_bits);
+		}
+	}
+
+	/// Sets the entry of the vector at index index to 1
+	template <f2_vector_like Bits>
+	void set_bit(Bits &vector, const std::size_t index)
+	{
+		if constexpr (std::unsigned_integral<Bits>)
+		{
+			vector |= integral_pow_2(static_cast<Bits>(index));
+		}
+		else
+		{
+			vector.set(index);
+		}
+	}
+
+	/// Calls function(index) for the index of each non-zero entry of the vector, in increasing order
+	template <f2_vector_like Bits, class Function>
+	void for_each_set_bit(const Bits &vector, Function &&function)
+	{
+		if constexpr (std::unsigned_integral<Bits>)
+		{
+			for (Bits rest = vector; rest != 0; rest &= rest - 1)
+			{
+				function(static_cast<std::size_t>(std::countr_zero(rest)));
+			}
+		}
+		else
+		{
+			const auto words = vector.words();
+
+			for (std::size_t w = 0; w < words.size(); w++)
+			{
+				for (F2_Vector::word_type rest = words[w]; rest != 0; rest &= rest - 1)
+				{
+					function(w * F2_Vector::word_size + std::countr_zero(rest));
+				}
+			}
+		}
+	}
+
+	/// Returns whether every entry of the vector is zero
+	template <f2_vector_like Bits>
+	bool is_zero(const Bits &vector) noexcept
+	{
+		if constexpr (std::unsigned_integral<Bits>)
+		{
+			return vector == 0;
+		}
+		else
+		{
+			return vector.none();
+		}
+	}
+
+	/// The index of the last non-zero entry of the vector, or -1 if it is zero
+	inline int integral_log_2(const F2_Vector &vector) noexcept
+	{
+		return vector.highest_set_bit();
+	}
+
+	/// Returns the entry of the vector at index index (as a bool)
+	template <std::unsigned_integral U>
+	bool bit_set_at(const F2_Vector &vector, const U index) noexcept
+	{
+		return vector.test(index);
+	}
+
+	/// Gives the F_2 inner product between 2 F_2 vectors, one word at a time
+	inline unsigned int f2_dot_product(const F2_Vector &x, const F2_Vector &y) noexcept
+	{
+		const auto x_words = x.words();
+		const auto y_words = y.words();
+		const std::size_t common_words = std::min(x_words.size(), y_words.size());
+
+		F2_Vector::word_type product = 0;
+
+		for (std::size_t i = 0; i < common_words; i++)
+		{
+			product ^= x_words[i] & y_words[i];
+		}
+
+		return std::popcount(product) % 2;
+	}
+}
+
+template <>
+struct std::hash<fst::F2_Vector>
+{
+	std::size_t operator()(const fst::F2_Vector &vector) const noexcept
+	{
+		const auto words = vector.words();
+		std::size_t length = words.size();
+
+		// Trailing zero words do not change the vector, so must not change the hash
+		while (length > 0 && words[length - 1] == 0)
+		{
+			--length;
+		}
+
+		std::size_t seed = length;
+
+		for (std::size_t i = 0; i < length; i++)
+		{
+			seed ^= std::hash<fst::F2_Vector::word_type>{}(words[i]) + 0x9e3779b97f4a7c15 + (seed << 6) + (seed >> 2);
+		}
+
+		return seed;
+	}
+};
+
+#endif
@@ -0,0 +1,62 @@
+#ifndef _FAST_STABILISER_F2_VECTOR_PYBIND_H
+#define _FAST_STABILISER_F2_VECTOR_PYBIND_H
+
+#include <pybind11/pybind11.h>
+
+#include "f2_vector.h"
+
+#include <cstddef>
+#include <string>
+
+namespace pybind11::detail
+{
+    /// Converts between F2_Vector and non-negative Python ints, with bit i of the int as entry i, so the Wide_*
+    /// classes take and return bit vectors as plain ints, as the std::size_t ones do. The int is passed through
+    /// its little-endian bytes, one word of the vector per 8 bytes
+    template <>
+    struct type_caster<fst::F2_Vector>
+    {
+        PYBIND11_TYPE_CASTER(fst::F2_Vector, const_name("int"));
+
+        bool load(handle source, bool)
+        {
+            if (!PyLong_Check(source.ptr()))
+            {
+                return false;
+            }
+
+            const int_ integer = reinterpret_borrow<int_>(source);
+
+            if (integer < int_(0))
+            {
+                throw value_error("Bit vectors must be non-negative");
+            }
+
+            const std::size_t number_words = fst::F2_Vector::number_words_for(integer.attr("bit_length")().cast<std::size_t>());
+            const std::string byte_string = integer.attr("to_bytes")(number_words * sizeof(fst::F2_Vector::word_type), "little").cast<std::string>();
+
+            value = fst::F2_Vector::zeros(number_words * fst::F2_Vector::word_size);
+
+            for (std::size_t i = 0; i < byte_string.size(); i++)
+            {
+                value.words()[i / sizeof(fst::F2_Vector::word_type)] |= fst::F2_Vector::word_type(static_cast<unsigned char>(byte_string[i])) << (8 * (i % sizeof(fst::F2_Vector::word_type)));
+            }
+
+            return true;
+        }
+
+        static handle cast(const fst::F2_Vector &vector, return_value_policy, handle)
+        {
+            std::string byte_string(vector.number_words() * sizeof(fst::F2_Vector::word_type), '\0');
+
+            for (std::size_t i = 0; i < byte_string.size(); i++)
+            {
+                byte_string[i] = static_cast<char>(vector.words()[i / sizeof(fst::F2_Vector::word_type)] >> (8 * (i % sizeof(fst::F2_Vector::word_type))));
+            }
+
+            return reinterpret_borrow<object>(reinterpret_cast<PyObject *>(&PyLong_Type)).attr("from_bytes")(bytes(byte_string), "little").release();
+        }
+    };
+}
+
+#endif
@@ -0,0 +1,172 @@
+#ifndef _FAST_STABILISER_NUMPY_PYBIND_H
+#define _FAST_STABILISER_NUMPY_PYBIND_H
+
+#include <pybind11/pybind11.h>
+#include <pybind11/numpy.h>
+
+#include <bit>
+#include <complex>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace py = pybind11;
+
+namespace fst_pybind
+{
+    /// The array type taken by every function reading amplitudes. A C-contiguous complex64 array is read
+    /// in place through the buffer protocol. Anything else numpy can cast (real arrays, lists, strided
+    /// views) is converted once to a C-contiguous complex64 copy
+    using Complex_Array = py::array_t<std::complex<float>, py::array::c_style | py::array::forcecast>;
+
+    /// A C-contiguous complex128 array, read in place in double precision. Functions taking one are
+    /// overloaded after their Complex_Array form, and pybind11 tries overloads without conversion first,
+    /// so complex128 input takes this one without a copy while everything else falls back to complex64
+    using Double_Complex_Array = py::array_t<std::complex<double>, py::array::c_style>;
+
+    /// The array type taken for basis state indices, e.g. of a sparse state vector. Any integer array is
+    /// converted to a C-contiguous array of std::size_t (a no-op for uint64, and a copy otherwise)
+    using Index_Array = py::array_t<std::size_t, py::array::c_style | py::array::forcecast>;
+
+    /// A view of the entries of the array, in row-major order
+    template <class T, int flags>
+    std::span<const T> as_span(const py::array_t<T, flags> &array)
+    {
+        return {array.data(), static_cast<std::size_t>(array.size())};
+    }
+
+    /// A view of a square matrix, in row-major order. Throws std::invalid_argument (ValueError) if the
+    /// array is not a square matrix
+    template <class Array>
+    auto as_square_matrix_span(const Array &matrix)
+    {
+        if (matrix.ndim() != 2 || matrix.shape(0) != matrix.shape(1))
+        {
+            throw std::invalid_argument("The matrix must be a square 2 dimensional array");
+        }
+
+        return as_span(matrix);
+    }
+
+    /// The number of qubits of a batch of state vectors, stored as the rows of a 2 dimensional array. Throws
+    /// std::invalid_argument (ValueError) if the rows are not of length 2^n
+    template <class Array>
+    std::size_t get_batch_number_qubits(const Array &statevectors)
+    {
+        if (statevectors.ndim() != 2 || statevectors.shape(1) <= 0 || !std::has_single_bit(static_cast<std::size_t>(statevectors.shape(1))))
+        {
+            throw std::invalid_argument("The batch must be a 2 dimensional array, with one state vector of length 2^n per row");
+        }
+
+        return std::countr_zero(static_cast<std::size_t>(statevectors.shape(1)));
+    }
+
+    /// Returns a numpy array of the given shape that takes ownership of buffer, without copying it
+    template <class T>
+    py::array_t<T> to_numpy(std::vector<T> &&buffer, const std::vector<py::ssize_t> &shape)
+    {
+        auto *owned_buffer = new std::vector<T>(std::move(buffer));
+
+        py::capsule owner(owned_buffer, [](void *pointer)
+        {
+            delete static_cast<std::vector<T> *>(pointer);
+        });
+
+        return py::array_t<T>(shape, owned_buffer->data(), owner);
+    }
+
+    /// Returns the sparse state vector (indices, amplitudes) of get_sparse() as a tuple of numpy arrays, of dtypes
+    /// uint64 and complex64. The GIL is released while it is computed
+    template <class Getter>
+    py::tuple sparse_to_numpy(Getter &&get_sparse)
+    {
+        std::pair<std::vector<std::size_t>, std::vector<std::complex<float>>> sparse;
+        {
+            py::gil_scoped_release release;
+            sparse = get_sparse();
+        }
+
+        const py::ssize_t size = static_cast<py::ssize_t>(sparse.first.size());
+
+        return py::make_tuple(to_numpy(std::move(sparse.first), {size}), to_numpy(std::move(sparse.second), {size}));
+    }
+
+    /// Checks out is a writeable array of the given size, and returns a view of its entries
+    template <class Scalar>
+    std::span<std::complex<Scalar>> as_output_span(py::array_t<std::complex<Scalar>, py::array::c_style> &array, const std::size_t size)
+    {
+        if (!array.writeable() || static_cast<std::size_t>(array.size()) != size)
+        {
+            throw std::invalid_argument("out must be writeable, with one entry per entry of the result");
+        }
+
+        return {array.mutable_data(), size};
+    }
+
+    /// Calls write(span) to fill an array of the given shape, and returns that array.
+    ///
+    /// If out is None, the array is a new complex64 buffer owned by the returned numpy array. Otherwise out
+    /// must be a writeable C-contiguous complex64 array with the right number of entries (or complex128, when
+    /// write also takes a double precision span), which is written in place and returned, so a buffer can be
+    /// reused across calls. (A converted copy would silently drop the result, so anything else raises
+    /// ValueError.) The GIL is released while writing
+    template <class Writer>
+    py::array write_array(const std::vector<py::ssize_t> &shape, const py::object &out, Writer &&write)
+    {
+        std::size_t size = 1;
+
+        for (const py::ssize_t extent : shape)
+        {
+            size *= static_cast<std::size_t>(extent);
+        }
+
+        if (out.is_none())
+        {
+            std::vector<std::complex<float>> buffer(size);
+            {
+                py::gil_scoped_release release;
+                write(std::span<std::complex<float>>(buffer));
+            }
+
+            return to_numpy(std::move(buffer), shape);
+        }
+
+        using Output_Array = py::array_t<std::complex<float>, py::array::c_style>;
+        using Double_Output_Array = py::array_t<std::complex<double>, py::array::c_style>;
+
+        if constexpr (std::is_invocable_v<Writer &, std::span<std::complex<double>>>)
+        {
+            if (Double_Output_Array::check_(out))
+            {
+                auto array = py::reinterpret_borrow<Double_Output_Array>(out);
+                const std::span<std::complex<double>> output = as_output_span(array, size);
+                {
+                    py::gil_scoped_release release;
+                    write(output);
+                }
+
+                return array;
+            }
+        }
+
+        if (!Output_Array::check_(out))
+        {
+            throw std::invalid_argument(std::is_invocable_v<Writer &, std::span<std::complex<double>>>
+                                            ? "out must be a C-contiguous numpy array of dtype complex64 or complex128"
+                                            : "out must be a C-contiguous numpy array of dtype complex64");
+        }
+
+        auto array = py::reinterpret_borrow<Output_Array>(out);
+        const std::span<std::complex<float>> output = as_output_span(array, size);
+        {
+            py::gil_scoped_release release;
+            write(output);
+        }
+
+        return array;
+    }
+}
+
+#endif
@@ -0,0 +1,110 @@
+#include "parallel.h"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace
+{
+	void run_on_threads(const std::size_t number_tasks, const std::function<void(std::size_t)> &task)
+	{
+		std::vector<std::exception_ptr> exceptions(number_tasks);
+
+		const auto run_task = [&](const std::size_t task_index)
+		{
+			try
+			{
+				task(task_index);
+			}
+			catch (...)
+			{
+				exceptions[task_index] = std::current_exception();
+			}
+		};
+
+		std::vector<std::jthread> threads;
+		threads.reserve(number_tasks - 1);
+
+		for (std::size_t task_index = 1; task_index < number_tasks; task_index++)
+		{
+			threads.emplace_back(run_task, task_index);
+		}
+
+		run_task(0);
+		threads.clear();
+
+		for (const auto &exception : exceptions)
+		{
+			if (exception)
+			{
+				std::rethrow_exception(exception);
+			}
+		}
+	}
+
+	std::atomic<std::size_t> &current_number_threads()
+	{
+		static std::atomic<std::size_t> number_threads = std::max(std::thread::hardware_concurrency(), 1u);
+		return number_threads;
+	}
+
+	std::mutex executor_mutex;
+	fst::Executor current_executor;
+}
+
+namespace fst
+{
+	std::size_t get_number_threads()
+	{
+		return current_number_threads().load(std::memory_order_relaxed);
+	}
+
+	void set_number_threads(const std::size_t number_threads)
+	{
+		if (number_threads == 0)
+		{
+			throw std::invalid_argument("The number of threads must be at least 1");
+		}
+
+		current_number_threads().store(number_threads, std::memory_order_relaxed);
+	}
+
+	void set_executor(Executor executor)
+	{
+		const std::lock_guard lock(executor_mutex);
+		current_executor = std::move(executor);
+	}
+
+	void parallel_for(const std::size_t number_tasks, const std::function<void(std::size_t)> &task)
+	{
+		if (number_tasks == 1)
+		{
+			task(0);
+			return;
+		}
+
+		if (number_tasks == 0)
+		{
+			return;
+		}
+
+		Executor executor;
+		{
+			const std::lock_guard lock(executor_mutex);
+			executor = current_executor;
+		}
+
+		if (executor)
+		{
+			executor(number_tasks, task);
+		}
+		else
+		{
+			run_on_threads(number_tasks, task);
+		}
+	}
+}
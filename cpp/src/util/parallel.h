@@ -0,0 +1,31 @@
+#ifndef _FAST_STABILISER_PARALLEL_H
+#define _FAST_STABILISER_PARALLEL_H
+
+#include <cstddef>
+#include <functional>
+
+namespace fst
+{
+	/// An executor runs task(0), ..., task(number_tasks - 1), possibly concurrently, and returns once
+	/// all of them have finished. An exception thrown by a task should be rethrown to the caller
+	using Executor = std::function<void(const std::size_t number_tasks, const std::function<void(std::size_t)> &task)>;
+
+	/// Returns the number of threads the parallel kernels split their work between. This defaults
+	/// to the number of hardware threads
+	std::size_t get_number_threads();
+
+	/// Sets the number of threads the parallel kernels split their work between, with 1 meaning
+	/// everything runs on the calling thread. Throws std::invalid_argument for 0
+	void set_number_threads(const std::size_t number_threads);
+
+	/// Replaces the executor that runs the tasks of the parallel kernels, e.g. with a thread pool
+	/// the caller already owns. An empty executor restores the default, which starts a std::thread
+	/// per task (the first task running on the calling thread)
+	void set_executor(Executor executor);
+
+	/// Runs task(0), ..., task(number_tasks - 1) through the current executor. A single task is run
+	/// directly on the calling thread
+	void parallel_for(const std::size_t number_tasks, const std::function<void(std::size_t)> &task);
+}
+
+#endif
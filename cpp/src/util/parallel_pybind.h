@@ -0,0 +1,20 @@
+#ifndef _FAST_STABILISER_PARALLEL_PYBIND_H
+#define _FAST_STABILISER_PARALLEL_PYBIND_H
+
+#include <pybind11/pybind11.h>
+
+#include "parallel.h"
+
+namespace py = pybind11;
+using namespace fst;
+
+namespace fst_pybind
+{
+    void init_parallel(py::module_ &m)
+    {
+        m.def("get_number_threads", &get_number_threads, "Returns the number of threads the parallel kernels (e.g. get_state_vector on large states) split their work between");
+        m.def("set_number_threads", &set_number_threads, py::arg("number_threads"), "Sets the number of threads the parallel kernels split their work between, with 1 meaning everything runs on the calling thread. Raises ValueError for 0");
+    }
+}
+
+#endif
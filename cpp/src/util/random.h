@@ -0,0 +1,73 @@
+#ifndef _FAST_STABILISER_RANDOM_H
+#define _FAST_STABILISER_RANDOM_H
+
+#include <bit>
+#include <cstdint>
+#include <limits>
+
+namespace fst
+{
+	/// Returns the next output of the splitmix64 generator with the given state, advancing the state
+	constexpr std::uint64_t splitmix64(std::uint64_t &state) noexcept
+	{
+		state += 0x9e3779b97f4a7c15;
+
+		std::uint64_t z = state;
+		z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9;
+		z = (z ^ (z >> 27)) * 0x94d049bb133111eb;
+
+		return z ^ (z >> 31);
+	}
+
+	/// The xoshiro256** pseudo-random generator of Blackman & Vigna, which satisfies
+	/// std::uniform_random_bit_generator.
+	///
+	/// Each (seed, stream) pair starts from a state filled by splitmix64, so the parallel kernels give each
+	/// fixed-size chunk of their work its own stream, and their output depends only on the seed (not on the
+	/// number of threads)
+	class Random_Generator
+	{
+		public:
+		using result_type = std::uint64_t;
+
+		explicit constexpr Random_Generator(const std::uint64_t seed, const std::uint64_t stream = 0) noexcept
+		{
+			std::uint64_t splitmix_state = seed ^ (stream * 0xd1342543de82ef95);
+
+			for (std::uint64_t &word : state)
+			{
+				word = splitmix64(splitmix_state);
+			}
+		}
+
+		static constexpr result_type min() noexcept
+		{
+			return 0;
+		}
+
+		static constexpr result_type max() noexcept
+		{
+			return std::numeric_limits<result_type>::max();
+		}
+
+		constexpr result_type operator()() noexcept
+		{
+			const std::uint64_t result = std::rotl(state[1] * 5, 7) * 9;
+			const std::uint64_t t = state[1] << 17;
+
+			state[2] ^= state[0];
+			state[3] ^= state[1];
+			state[1] ^= state[2];
+			state[0] ^= state[3];
+			state[2] ^= t;
+			state[3] = std::rotl(state[3], 45);
+
+			return result;
+		}
+
+		private:
+		std::uint64_t state[4];
+	};
+}
+
+#endif
@@ -0,0 +1,31 @@
+#ifndef _FAST_STABILISER_RANDOM_PYBIND_H
+#define _FAST_STABILISER_RANDOM_PYBIND_H
+
+#include "random.h"
+
+#include <cstdint>
+#include <optional>
+#include <random>
+
+namespace fst_pybind
+{
+    /// Returns seed, or a seed drawn from std::random_device if seed is None
+    inline std::uint64_t get_seed(const std::optional<std::uint64_t> seed)
+    {
+        if (seed)
+        {
+            return *seed;
+        }
+
+        std::random_device random_device;
+        return (std::uint64_t(random_device()) << 32) ^ random_device();
+    }
+
+    /// Returns the generator for the given stream of seed, or of a seed from std::random_device if seed is None
+    inline fst::Random_Generator make_generator(const std::optional<std::uint64_t> seed, const std::uint64_t stream = 0)
+    {
+        return fst::Random_Generator(get_seed(seed), stream);
+    }
+}
+
+#endif
@@ -0,0 +1,86 @@
+#include "simd.h"
+
+#include <atomic>
+#include <stdexcept>
+
+#if defined(FST_X86_64) && defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace
+{
+	fst::Simd_Level detect_simd_level()
+	{
+#if defined(FST_X86_64) && (defined(__GNUC__) || defined(__clang__))
+		__builtin_cpu_init();
+
+		if (__builtin_cpu_supports("avx512f"))
+		{
+			return fst::Simd_Level::avx512;
+		}
+
+		if (__builtin_cpu_supports("avx2"))
+		{
+			return fst::Simd_Level::avx2;
+		}
+#elif defined(FST_X86_64) && defined(_MSC_VER)
+		int registers[4];
+
+		__cpuid(registers, 1);
+		const bool os_saves_registers = registers[2] & (1 << 27);
+
+		if (!os_saves_registers)
+		{
+			return fst::Simd_Level::scalar;
+		}
+
+		// The operating system must save the ymm (and for AVX-512, the zmm and mask) registers
+		const unsigned long long saved_state = _xgetbv(0);
+
+		__cpuidex(registers, 7, 0);
+		const bool has_avx2 = registers[1] & (1 << 5);
+		const bool has_avx512f = registers[1] & (1 << 16);
+
+		if (has_avx512f && (saved_state & 0xe6) == 0xe6)
+		{
+			return fst::Simd_Level::avx512;
+		}
+
+		if (has_avx2 && (saved_state & 0x6) == 0x6)
+		{
+			return fst::Simd_Level::avx2;
+		}
+#endif
+		return fst::Simd_Level::scalar;
+	}
+
+	std::atomic<fst::Simd_Level> &current_simd_level()
+	{
+		static std::atomic<fst::Simd_Level> level = fst::get_supported_simd_level();
+		return level;
+	}
+}
+
+namespace fst
+{
+	Simd_Level get_supported_simd_level()
+	{
+		static const Simd_Level supported_level = detect_simd_level();
+		return supported_level;
+	}
+
+	Simd_Level get_simd_level()
+	{
+		return current_simd_level().load(std::memory_order_relaxed);
+	}
+
+	void set_simd_level(const Simd_Level level)
+	{
+		if (level > get_supported_simd_level())
+		{
+			throw std::invalid_argument("This CPU does not support the requested SIMD level");
+		}
+
+		current_simd_level().store(level, std::memory_order_relaxed);
+	}
+}
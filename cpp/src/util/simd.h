@@ -0,0 +1,41 @@
+#ifndef _FAST_STABILISER_SIMD_H
+#define _FAST_STABILISER_SIMD_H
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define FST_X86_64
+#endif
+
+// Kernels for a particular instruction set are compiled with that instruction set enabled for the
+// function only, and are only called once get_simd_level() says the CPU supports it. MSVC allows
+// the intrinsics in any function, so needs no annotation
+#if defined(FST_X86_64) && (defined(__GNUC__) || defined(__clang__))
+#define FST_TARGET_AVX2 __attribute__((target("avx2")))
+#define FST_TARGET_AVX512 __attribute__((target("avx512f")))
+#else
+#define FST_TARGET_AVX2
+#define FST_TARGET_AVX512
+#endif
+
+namespace fst
+{
+	/// The instruction sets that the vectorised kernels can use, in increasing order
+	enum class Simd_Level
+	{
+		scalar,
+		avx2,
+		avx512
+	};
+
+	/// Returns the best level supported by the CPU (and operating system) we are running on
+	Simd_Level get_supported_simd_level();
+
+	/// Returns the level the vectorised kernels currently use. This is the supported level, unless
+	/// it has been lowered with set_simd_level
+	Simd_Level get_simd_level();
+
+	/// Sets the level the vectorised kernels use, e.g. to compare against the scalar path.
+	/// Throws std::invalid_argument if the CPU does not support the level
+	void set_simd_level(const Simd_Level level);
+}
+
+#endif
@@ -0,0 +1,26 @@
+#ifndef _FAST_STABILISER_SIMD_PYBIND_H
+#define _FAST_STABILISER_SIMD_PYBIND_H
+
+#include <pybind11/pybind11.h>
+
+#include "simd.h"
+
+namespace py = pybind11;
+using namespace fst;
+
+namespace fst_pybind
+{
+    void init_simd(py::module_ &m)
+    {
+        py::enum_<Simd_Level>(m, "Simd_Level", "The instruction sets that the vectorised kernels can use")
+            .value("scalar", Simd_Level::scalar)
+            .value("avx2", Simd_Level::avx2)
+            .value("avx512", Simd_Level::avx512);
+
+        m.def("get_supported_simd_level", &get_supported_simd_level, "Returns the best SIMD level supported by this CPU");
+        m.def("get_simd_level", &get_simd_level, "Returns the SIMD level the vectorised kernels currently use");
+        m.def("set_simd_level", &set_simd_level, py::arg("level"), "Sets the SIMD level the vectorised kernels use, e.g. to compare against the scalar path. Raises ValueError if the CPU does not support the level");
+    }
+}
+
+#endif
@@ -0,0 +1,24 @@
+#ifndef _FAST_STABILISER_TOLERANCE_H
+#define _FAST_STABILISER_TOLERANCE_H
+
+namespace fst
+{
+	/// How far the input to a conversion (a state vector or a matrix) may be from an exact stabiliser
+	/// state or Clifford before it is rejected. Both are squared distances |z - w|^2 between complex numbers.
+	///
+	/// The defaults are loose enough for single precision input. Double precision input can be checked
+	/// strictly by lowering them, e.g. {1e-6, 1e-12}
+	struct Tolerance
+	{
+		/// A ratio of two amplitudes is read as the power of i it is within this distance of (and the
+		/// normalisation of the state as 1)
+		double phase = 0.125;
+
+		/// Once a stabiliser state has been found, every amplitude of the input must be within this
+		/// distance of the corresponding amplitude of it. This is absolute, so should shrink with
+		/// the amplitudes (as 1 / 2^n) when strictly checking states on many qubits
+		double amplitude = 0.001;
+	};
+}
+
+#endif
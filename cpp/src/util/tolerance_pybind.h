@@ -0,0 +1,23 @@
+#ifndef _FAST_STABILISER_TOLERANCE_PYBIND_H
+#define _FAST_STABILISER_TOLERANCE_PYBIND_H
+
+#include <pybind11/pybind11.h>
+
+#include "tolerance.h"
+
+namespace py = pybind11;
+using namespace fst;
+
+namespace fst_pybind
+{
+    void init_tolerance(py::module_ &m)
+    {
+        py::class_<Tolerance>(m, "Tolerance")
+            .def(py::init([](const double phase, const double amplitude) { return Tolerance{phase, amplitude}; }), py::arg("phase") = Tolerance{}.phase, py::arg("amplitude") = Tolerance{}.amplitude)
+            .def_readwrite("phase", &Tolerance::phase, "float\t\tThe squared distance from a power of i within which a ratio of two entries is read as that power")
+            .def_readwrite("amplitude", &Tolerance::amplitude, "float\t\tThe squared distance each entry of the input may be from the exact stabiliser state or Clifford. This is absolute, so should shrink with the entries when strictly checking many qubits")
+            .doc() = "How far the input to a conversion may be from an exact stabiliser state or Clifford before it is rejected. The defaults suit complex64 input; complex128 input can be checked strictly with e.g. Tolerance(1e-6, 1e-12)";
+    }
+}
+
+#endif
@@ -3,14 +3,17 @@
 1. Testing S_V
 2. S_V to succinct representation
 3. Succinct representation to S_V
-4. S_P to succinct representation
-5. Succinct representation to S_P
-6. S_V to S_P
-7. S_P to S_V
-
-8. Testing C_U
-9. C_U to succinct representation
-10. Succinct representation to C_U
+4. Succinct representation to S_V, scalar against vectorised
+5. S_P to succinct representation, also for large numbers of qubits
+6. Succinct representation to S_P
+7. S_V to S_P
+8. S_P to S_V
+
+9. Testing C_U
+10. C_U to succinct representation
+11. Succinct representation to C_U
+
+12. Gate-level simulation of random circuits on S_P
 """
 
 import generators as gs
@@ -44,8 +47,16 @@ def stim_succinct_to_S_V(our_succinct: fst.Stabiliser_State, stim_succinct: stim
 def our_succinct_to_S_V(our_succinct: fst.Stabiliser_State, stim_succinct: stim.Tableau):
     our_succinct.get_state_vector()
 
-def our_check_matrix_to_succinct(check_matrix: fst.Check_Matrix):
-    fst.Stabiliser_State(check_matrix)
+def our_succinct_to_S_V_scalar(our_succinct: fst.Stabiliser_State, stim_succinct: stim.Tableau):
+    fst.set_simd_level(fst.Simd_Level.scalar)
+    our_succinct.get_state_vector()
+    fst.set_simd_level(fst.get_supported_simd_level())
+
+def our_check_matrix_to_succinct(check_matrix: fst.Check_Matrix | fst.Wide_Check_Matrix):
+    if type(check_matrix) is fst.Wide_Check_Matrix:
+        fst.Wide_Stabiliser_State(check_matrix)
+    else:
+        fst.Stabiliser_State(check_matrix)
 
 def our_succinct_to_check_matrix(our_succinct: fst.Stabiliser_State):
     fst.Check_Matrix(our_succinct)
@@ -92,6 +103,13 @@ def qiskit_succinct_to_C_U(our_clifford: fst.Clifford, qiskit_clifford: qi.Cliff
 def stim_succinct_to_C_U(our_clifford: fst.Clifford, qiskit_clifford: qi.Clifford, stim_clifford: stim.Tableau):
     stim_clifford.to_unitary_matrix(endian='big')
 
+def our_gate_simulation(our_check_matrix: fst.Check_Matrix, our_gates: list, stim_circuit: stim.Circuit):
+    fst.apply_gates(our_check_matrix, our_gates)
+
+def stim_gate_simulation(our_check_matrix: fst.Check_Matrix, our_gates: list, stim_circuit: stim.Circuit):
+    simulator = stim.TableauSimulator()
+    simulator.do_circuit(stim_circuit)
+
 
 configs = [
     {
@@ -160,6 +178,30 @@ configs = [
         "reps" : int(1e3)
     },
 
+    {
+        "pre_string": "Succinct representation to S_V (SIMD)",
+        "title": r"Succinct rep to $[S_V]$, scalar against vectorised",
+        "functions_to_time": [
+            our_succinct_to_S_V,
+            our_succinct_to_S_V_scalar
+        ],
+        "function_strings": [
+            "our method (vectorised)",
+            "our method (scalar)"
+        ],
+        "generation_types": [
+            gs.rand_succinct,
+            gs.rand_mixed_basis_succinct
+        ],
+        "generation_strings": [
+            "rand_succinct",
+            "rand_mixed_basis_succinct"
+        ],
+        "min_qubit_number" : 3,
+        "max_qubit_number" : 20,
+        "reps" : int(1e2)
+    },
+
     {
         "pre_string": "S_P to succinct representation",
         "title": r"$[S_P]$ to succinct rep",
@@ -180,6 +222,28 @@ configs = [
         "reps" : int(1e3)
     },
 
+    {
+        # The check matrices are built without a state vector, so this reaches the sizes where the row reduction
+        # dominates, including above 64 qubits on the wide classes
+        "pre_string": "S_P to succinct representation (large)",
+        "title": r"$[S_P]$ to succinct rep, large $n$",
+        "functions_to_time": [
+            our_check_matrix_to_succinct
+        ],
+        "function_strings": [
+            "our method"
+        ],
+        "generation_types": [
+            gs.rand_large_check_matrix
+        ],
+        "generation_strings": [
+            "rand_large_check_matrix"
+        ],
+        "min_qubit_number" : 16,
+        "max_qubit_number" : 160,
+        "reps" : int(1e2)
+    },
+
     {
         "pre_string": "Succinct representation to S_P",
         "title": r"Succinct rep to $[S_P]$",
@@ -315,6 +379,30 @@ configs = [
         "max_qubit_number" : 10,
         "reps" : int(1e3) 
     },
+
+    {
+        # The matrix route (Clifford.get_matrix and a dense product) needs 4^n entries, so only the tableau
+        # simulators can reach these sizes
+        "pre_string": "Gate-level simulation",
+        "title": r"Random circuits of $10 n^2$ gates on $[S_P]$",
+        "functions_to_time": [
+            our_gate_simulation,
+            stim_gate_simulation
+        ],
+        "function_strings": [
+            "our method",
+            "stim"
+        ],
+        "generation_types": [
+            gs.rand_gate_circuit
+        ],
+        "generation_strings": [
+            "rand_gate_circuit"
+        ],
+        "min_qubit_number" : 20,
+        "max_qubit_number" : 60,
+        "reps" : int(1e2)
+    },
 ]
 
 # configs = configs[0:3]
\ No newline at end of file
@@ -67,12 +67,9 @@ def random_full_support_stab_state(n: int) -> np.ndarray:
     stab.dim = n
     stab.imaginary_part = random.randrange(1 << n)
     stab.real_linear_part = random.randrange(1 << n)
-    quadratic_form = {}
-    quadratic_form[0] = 0
     for i in range(n):
         for j in range(i+1, n):
-            quadratic_form[(1 << i) ^ (1 << j)] = random.randrange(2)
-    stab.quadratic_form = quadratic_form # for now, the quadratic_form is not opaque (see https://pybind11.readthedocs.io/en/stable/advanced/cast/stl.html), so this is a workaround
+            stab.set_quadratic_form(i, j, bool(random.randrange(2)))
     return np.array(stab.get_state_vector())
 
 
@@ -172,6 +169,24 @@ def rand_succinct(n: int) -> Tuple[fst.Stabiliser_State, stim.Tableau]:
     return our_succinct, stim_succinct
 
 
+def rand_mixed_basis_succinct(n: int) -> Tuple[fst.Stabiliser_State, stim.Tableau]:
+    # A full support state whose basis is a random invertible mix of the unit vectors, and not row reduced
+    stab = fst.Stabiliser_State(n)
+    basis_vectors = [1 << k for k in range(n)]
+    for _ in range(4 * n * n):
+        i, j = random.sample(range(n), 2)
+        basis_vectors[i] ^= basis_vectors[j]
+    stab.basis_vectors = basis_vectors
+    stab.row_reduced = False
+    stab.imaginary_part = random.randrange(1 << n)
+    stab.real_linear_part = random.randrange(1 << n)
+    for i in range(n):
+        for j in range(i+1, n):
+            stab.set_quadratic_form(i, j, bool(random.randrange(2)))
+    stim_succinct = stim.Tableau.from_state_vector(np.array(stab.get_state_vector()), endian='big')
+    return stab, stim_succinct
+
+
 def rand_our_succinct(n: int) -> fst.Stabiliser_State:
     var = rand_s_v_to_succinct(n)
     if type(var) is tuple:
@@ -194,6 +209,32 @@ def rand_our_check_matrix(n: int) -> fst.Check_Matrix:
     return fst.Check_Matrix(fst.stabiliser_state_from_statevector(statevector, assume_valid=True))
 
 
+def rand_large_check_matrix(n: int) -> fst.Check_Matrix | fst.Wide_Check_Matrix:
+    # The graph state of a random graph, with Hadamards on random qubits and random signs, with its generators
+    # multiplied together at random so that they are not row reduced. Nothing of size 2^n is built, so this
+    # reaches any number of qubits, using the wide classes above 64
+    pauli_type, check_matrix_type = (fst.Pauli, fst.Check_Matrix) if n <= 64 else (fst.Wide_Pauli, fst.Wide_Check_Matrix)
+
+    neighbours = [0] * n
+    for a in range(n):
+        for b in range(a + 1, n):
+            if random.getrandbits(1):
+                neighbours[a] |= 1 << b
+                neighbours[b] |= 1 << a
+
+    hadamards = random.getrandbits(n)
+    paulis = []
+    for a in range(n):
+        x_vector, z_vector = 1 << a, neighbours[a]
+        paulis.append(pauli_type(n, (x_vector & ~hadamards) | (z_vector & hadamards), (z_vector & ~hadamards) | (x_vector & hadamards), random.getrandbits(1), 0))
+
+    for _ in range(4 * n if n > 1 else 0):
+        i, j = random.sample(range(n), 2)
+        paulis[j].multiply_by_pauli_on_right(paulis[i])
+
+    return check_matrix_type(paulis)
+
+
 def rand_clifford_test(n: int) -> np.ndarray:
     func = random.sample(
         [random_clifford, random_almost_clifford], 1)[0]
@@ -213,4 +254,24 @@ def rand_clifford_succinct(n: int) -> Tuple[fst.Clifford, qi.Clifford, stim.Tabl
     mat = qiskit_clifford.to_matrix()
     our_clifford = fst.clifford_from_matrix(mat)
     stim_clifford = stim.Tableau.from_unitary_matrix(mat, endian='big')
-    return our_clifford, qiskit_clifford, stim_clifford
\ No newline at end of file
+    return our_clifford, qiskit_clifford, stim_clifford
+
+def rand_gate_circuit(n: int) -> Tuple[fst.Check_Matrix, list, stim.Circuit]:
+    # 10 n^2 random gates from H, S, CX, CZ and SWAP, on the state |0...0>
+    our_check_matrix = fst.Check_Matrix([fst.Pauli(n, 0, 1 << q, 0, 0) for q in range(n)])
+    our_gates = []
+    stim_circuit = stim.Circuit()
+
+    for _ in range(10 * n * n):
+        gate_type, stim_name = random.choice([(fst.Gate_Type.h, "H"), (fst.Gate_Type.s, "S"), (fst.Gate_Type.cx, "CX"),
+                                              (fst.Gate_Type.cz, "CZ"), (fst.Gate_Type.swap, "SWAP")])
+        a, b = random.sample(range(n), 2)
+
+        if stim_name in ("H", "S"):
+            our_gates.append(fst.Gate(gate_type, a))
+            stim_circuit.append(stim_name, [a])
+        else:
+            our_gates.append(fst.Gate(gate_type, a, b))
+            stim_circuit.append(stim_name, [a, b])
+
+    return our_check_matrix, our_gates, stim_circuit
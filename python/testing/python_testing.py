@@ -1,6 +1,6 @@
 print("### LAUNCHING PYTHON TESTS ###")
 
-import sys, unittest
+import random, sys, unittest
 from math import sqrt
 import numpy as np
 
@@ -65,6 +65,362 @@ class TestStabiliserStateMethods(unittest.TestCase):
         
         self.assertTrue( np.linalg.norm(stabiliser_statevector - output_statevector) <= 1e-7 )
         
+    def test_quadratic_form_is_symmetric(self):
+        stabiliser_state = fst.Stabiliser_State(3)
+        stabiliser_state.basis_vectors = [1, 2, 4]
+        stabiliser_state.set_quadratic_form(0, 2, True)
+
+        self.assertTrue(stabiliser_state.get_quadratic_form(2, 0))
+        self.assertFalse(stabiliser_state.get_quadratic_form(0, 1))
+        self.assertEqual(stabiliser_state.quadratic_form, [4, 0, 1])
+
+        with self.assertRaises(ValueError):
+            stabiliser_state.set_quadratic_form(1, 1, True)
+
+        with self.assertRaises(IndexError):
+            stabiliser_state.set_quadratic_form(70, 0, True)
+
+        with self.assertRaises(IndexError):
+            stabiliser_state.get_quadratic_form(0, 3)
+
+        stabiliser_state.dim = 5
+
+        with self.assertRaises(ValueError):
+            stabiliser_state.get_state_vector()
+
+    def test_simd_levels_agree(self):
+        stabiliser_state = fst.Stabiliser_State(5)
+        stabiliser_state.basis_vectors = [1, 2, 4, 8, 16]
+        stabiliser_state.real_linear_part = 5
+        stabiliser_state.imaginary_part = 18
+        stabiliser_state.set_quadratic_form(0, 3, True)
+        stabiliser_state.set_quadratic_form(2, 4, True)
+
+        fst.set_simd_level(fst.Simd_Level.scalar)
+        scalar_statevector = stabiliser_state.get_state_vector()
+        fst.set_simd_level(fst.get_supported_simd_level())
+
+        self.assertTrue(np.array_equal(scalar_statevector, stabiliser_state.get_state_vector()))
+
+        # A basis with no unit vectors, which is row reduced (on a copy) before the blocks are found
+        stabiliser_state.basis_vectors = [3, 6, 12, 24, 16]
+        stabiliser_state.row_reduced = False
+
+        fst.set_simd_level(fst.Simd_Level.scalar)
+        scalar_statevector = stabiliser_state.get_state_vector()
+        fst.set_simd_level(fst.get_supported_simd_level())
+
+        self.assertTrue(np.array_equal(scalar_statevector, stabiliser_state.get_state_vector()))
+        self.assertFalse(stabiliser_state.row_reduced)
+
+    def test_number_threads(self):
+        default_number_threads = fst.get_number_threads()
+
+        fst.set_number_threads(3)
+        self.assertEqual(fst.get_number_threads(), 3)
+
+        with self.assertRaises(ValueError):
+            fst.set_number_threads(0)
+
+        fst.set_number_threads(default_number_threads)
+
+    def test_numpy_state_vectors(self):
+        stabiliser_statevector = np.array([0, 1, 0, 0, 0, 0, 1, 0], dtype = np.complex128) / np.sqrt(2)
+        stabiliser_state = fst.stabiliser_state_from_statevector(stabiliser_statevector)
+
+        state_vector = stabiliser_state.get_state_vector()
+        self.assertIsInstance(state_vector, np.ndarray)
+        self.assertEqual(state_vector.dtype, np.complex64)
+        self.assertTrue(np.allclose(state_vector, stabiliser_statevector))
+
+        out = np.full(8, 7, dtype = np.complex64)
+        self.assertIs(stabiliser_state.get_state_vector(out = out), out)
+        self.assertTrue(np.array_equal(out, state_vector))
+
+        with self.assertRaises(ValueError):
+            stabiliser_state.get_state_vector(out = np.zeros(8, dtype = np.float64))
+
+        with self.assertRaises(ValueError):
+            stabiliser_state.get_state_vector(out = np.zeros(4, dtype = np.complex64))
+
+    def test_stabiliser_state_batch(self):
+        statevectors = np.array([self.get_uniform_stabiliser_state(3), self.get_non_stabiliser_statevector(3), self.get_uniform_stabiliser_state(3)])
+
+        self.assertTrue(np.array_equal(fst.is_stabiliser_state_batch(statevectors), [True, False, True]))
+
+        is_valid, states = fst.stabiliser_state_from_statevector_batch(statevectors)
+        self.assertTrue(np.array_equal(is_valid, [True, False, True]))
+        self.assertIsNone(states[1])
+        self.assertTrue(np.allclose(states[2].get_state_vector(), statevectors[2]))
+
+        with self.assertRaises(ValueError):
+            fst.is_stabiliser_state_batch(np.ones((2, 3)))
+
+    def test_double_precision_and_tolerance(self):
+        statevector = self.get_uniform_stabiliser_state(3)
+        self.assertEqual(statevector.dtype, np.complex128)
+
+        strict = fst.Tolerance(1e-6, 1e-12)
+        stabiliser_state = fst.stabiliser_state_from_statevector(statevector, tolerance = strict)
+
+        out = np.zeros(8, dtype = np.complex128)
+        stabiliser_state.get_state_vector(out = out)
+        self.assertTrue(np.allclose(out, statevector, rtol = 0, atol = 1e-7))
+
+        statevector[0] *= 1 + 1e-4
+        self.assertTrue(fst.is_stabiliser_state(statevector))
+        self.assertFalse(fst.is_stabiliser_state(statevector, tolerance = strict))
+
+    def test_sparse_statevector(self):
+        indices = np.array([1 << 39, 0, (1 << 39) | 2, 2])
+        amplitudes = np.array([1, 1, -1, 1]) / 2
+
+        stabiliser_state = fst.stabiliser_state_from_statevector(indices, amplitudes, 40)
+        self.assertEqual(stabiliser_state.number_qubits, 40)
+        self.assertEqual(stabiliser_state.dim, 2)
+
+        self.assertTrue(fst.is_stabiliser_state(indices, amplitudes, 40))
+        self.assertFalse(fst.is_stabiliser_state(indices, amplitudes * [1, 1, 1, 1j], 40))
+
+        with self.assertRaises(ValueError):
+            fst.is_stabiliser_state(indices, amplitudes, 39)
+
+        # A repeated index is rejected even when one of its amplitudes is zero
+        with self.assertRaises(ValueError):
+            fst.stabiliser_state_from_statevector(np.array([0, 1, 1]), np.array([1, 1, 0]) / np.sqrt(2), 1)
+
+    def test_sparse_state_vector_output(self):
+        stabiliser_statevector = np.array([0, 1, 0, 0, 0, 0, 1j, 0]) / np.sqrt(2)
+        stabiliser_state = fst.stabiliser_state_from_statevector(stabiliser_statevector)
+
+        indices, amplitudes = stabiliser_state.get_sparse_state_vector()
+        self.assertEqual(indices.dtype, np.uint64)
+        self.assertEqual(amplitudes.dtype, np.complex64)
+
+        statevector = np.zeros(8, dtype = np.complex64)
+        statevector[indices] = amplitudes
+        self.assertTrue(np.allclose(statevector, stabiliser_statevector))
+
+        self.assertTrue(fst.is_stabiliser_state(indices, amplitudes, 3))
+
+    def test_amplitude_queries(self):
+        stabiliser_statevector = np.array([0, 1, 0, 0, 0, 0, 1j, 0]) / np.sqrt(2)
+        stabiliser_state = fst.stabiliser_state_from_statevector(stabiliser_statevector)
+
+        self.assertAlmostEqual(stabiliser_state.get_amplitude(6), 1j / np.sqrt(2), places = 6)
+        self.assertEqual(stabiliser_state.get_amplitude(0), 0)
+
+        amplitudes = stabiliser_state.get_amplitudes(np.arange(8))
+        self.assertEqual(amplitudes.dtype, np.complex64)
+        self.assertTrue(np.allclose(amplitudes, stabiliser_statevector))
+
+        out = np.zeros(2, dtype = np.complex128)
+        self.assertIs(stabiliser_state.get_amplitudes([1, 2], out = out), out)
+        self.assertTrue(np.allclose(out, [1 / np.sqrt(2), 0]))
+
+    def test_inner_product(self):
+        plus_statevector = self.get_uniform_stabiliser_state(3)
+        other_statevector = np.array([0, 1, 0, 0, 0, 0, 1j, 0]) / np.sqrt(2)
+
+        plus_state = fst.stabiliser_state_from_statevector(plus_statevector)
+        other_state = fst.stabiliser_state_from_statevector(other_statevector)
+
+        expected = np.vdot(plus_statevector, other_statevector)
+        self.assertAlmostEqual(fst.inner_product(plus_state, other_state), expected, places = 6)
+        self.assertAlmostEqual(fst.fidelity(plus_state, other_state), abs(expected) ** 2, places = 6)
+
+        gram = fst.gram_matrix([plus_state, other_state])
+        self.assertEqual(gram.shape, (2, 2))
+        self.assertTrue(np.allclose(gram, [[1, expected], [np.conj(expected), 1]]))
+
+        with self.assertRaises(ValueError):
+            fst.inner_product(plus_state, fst.Stabiliser_State(2))
+
+    def test_expectation_values(self):
+        XXX = fst.Pauli(3, 7, 0, 0, 0)
+        ZZI = fst.Pauli(3, 0, 6, 0, 0)
+        ZIZ = fst.Pauli(3, 0, 5, 0, 0)
+        check_matrix = fst.Check_Matrix([XXX, ZZI, ZIZ])
+        stabiliser_state = fst.Stabiliser_State(check_matrix)
+
+        minus_ZZI = fst.Pauli(3, 0, 6, 1, 0)
+        ZII = fst.Pauli(3, 0, 4, 0, 0)
+        YYX = fst.Pauli(3, 7, 6, 1, 0)
+
+        self.assertEqual(stabiliser_state.get_expectation_value(XXX), 1)
+        self.assertEqual(stabiliser_state.get_expectation_value(minus_ZZI), -1)
+        self.assertEqual(stabiliser_state.get_expectation_value(ZII), 0)
+
+        values = stabiliser_state.get_expectation_values([XXX, minus_ZZI, ZII, YYX])
+        state_vector = stabiliser_state.get_state_vector()
+        expected = [np.vdot(state_vector, pauli.multiply_vector(state_vector)).real for pauli in [XXX, minus_ZZI, ZII, YYX]]
+        self.assertTrue(np.allclose(values, expected))
+        self.assertTrue(np.array_equal(check_matrix.get_expectation_values([XXX, minus_ZZI, ZII, YYX]), values))
+
+        with self.assertRaises(ValueError):
+            stabiliser_state.get_expectation_value(fst.Pauli(3, 1, 1, 0, 0))
+
+    def test_sampling(self):
+        stabiliser_statevector = np.array([0, 1, 0, 0, 0, 0, 1j, 0]) / np.sqrt(2)
+        stabiliser_state = fst.stabiliser_state_from_statevector(stabiliser_statevector)
+
+        shots = stabiliser_state.sample(1000, seed = 5)
+        self.assertEqual(shots.dtype, np.uint64)
+        self.assertEqual(set(shots.tolist()), {1, 6})
+        self.assertTrue(np.array_equal(shots, stabiliser_state.sample(1000, seed = 5)))
+
+        bits = stabiliser_state.sample(1000, seed = 5, packed = False)
+        self.assertEqual(bits.shape, (1000, 3))
+        self.assertTrue(np.array_equal(bits @ [1, 2, 4], shots))
+
+    def test_marginal_probabilities(self):
+        stabiliser_statevector = np.array([0, 1, 0, 0, 0, 0, 1j, 0]) / np.sqrt(2)
+        stabiliser_state = fst.stabiliser_state_from_statevector(stabiliser_statevector)
+
+        # Qubits 0 and 2 of the outcomes 1 and 6 are 01 and 10
+        self.assertTrue(np.allclose(stabiliser_state.get_marginal_probabilities(5), [0, 0.5, 0.5, 0]))
+        self.assertTrue(np.allclose(stabiliser_state.get_marginal_probabilities(2), [0.5, 0.5]))
+
+        support = stabiliser_state.get_marginal_support(5)
+        self.assertEqual(support.number_qubits, 2)
+        self.assertEqual(len(support.basis_vectors), 1)
+
+        with self.assertRaises(ValueError):
+            stabiliser_state.get_marginal_probabilities(8)
+
+    def test_measurement(self):
+        stabiliser_state = fst.stabiliser_state_from_statevector(np.array([1, 0, 0, 0]))
+        X0 = fst.Pauli(2, 1, 0, 0, 0)
+        Z1 = fst.Pauli(2, 0, 2, 0, 0)
+
+        result = stabiliser_state.measure(X0, outcome = True)
+        self.assertTrue(result.outcome and not result.deterministic)
+        self.assertTrue(np.allclose(stabiliser_state.get_state_vector(), np.array([1, -1, 0, 0]) / np.sqrt(2)))
+
+        result = stabiliser_state.measure(Z1, seed = 5)
+        self.assertTrue(not result.outcome and result.deterministic)
+
+        check_matrix = fst.Check_Matrix([fst.Pauli(2, 0, 1, 0, 0), Z1])
+        self.assertEqual(check_matrix.measure(X0, seed = 3), fst.Check_Matrix([fst.Pauli(2, 0, 1, 0, 0), Z1]).measure(X0, seed = 3))
+        self.assertTrue(check_matrix.measure(X0).deterministic)
+
+        with self.assertRaises(ValueError):
+            check_matrix.measure(fst.Pauli(2, 1, 1, 0, 0))
+
+    def test_wide_check_matrix(self):
+        # The GHZ state on 100 qubits, stabilised by the X on every qubit and Z_i Z_(i + 1)
+        number_qubits = 100
+        all_qubits = (1 << number_qubits) - 1
+        paulis = [fst.Wide_Pauli(number_qubits, all_qubits, 0, 0, 0)] + [fst.Wide_Pauli(number_qubits, 0, 3 << i, 0, 0) for i in range(number_qubits - 1)]
+
+        stabiliser_state = fst.Wide_Stabiliser_State(fst.Wide_Check_Matrix(paulis))
+        self.assertEqual(stabiliser_state.dim, 1)
+        self.assertEqual(stabiliser_state.basis_vectors, [all_qubits])
+
+        check_matrix = fst.Wide_Check_Matrix(stabiliser_state)
+        self.assertEqual(check_matrix.number_qubits, number_qubits)
+        self.assertEqual(fst.Wide_Stabiliser_State(check_matrix), stabiliser_state)
+
+        for pauli in paulis:
+            result = check_matrix.measure(pauli)
+            self.assertTrue(result.deterministic and not result.outcome)
+
+        # Measuring Z on the last qubit collapses every qubit to the same outcome
+        result = check_matrix.measure(fst.Wide_Pauli(number_qubits, 0, 1 << (number_qubits - 1), 0, 0), outcome = True)
+        self.assertTrue(result.outcome and not result.deterministic)
+        result = check_matrix.measure(fst.Wide_Pauli(number_qubits, 0, 1, 0, 0))
+        self.assertTrue(result.outcome and result.deterministic)
+
+        with self.assertRaises(ValueError):
+            check_matrix.measure(fst.Wide_Pauli(number_qubits, 1 << 80, 1 << 80, 0, 0))
+
+    def test_wide_row_reduction(self):
+        # Above 128 Paulis the row reduction uses the Method of Four Russians, so compare it with plain elimination
+        number_qubits = 150
+        rng = random.Random(3)
+        neighbours = [0] * number_qubits
+        for a in range(number_qubits):
+            for b in range(a + 1, number_qubits):
+                if rng.getrandbits(1):
+                    neighbours[a] |= 1 << b
+                    neighbours[b] |= 1 << a
+
+        hadamards = rng.getrandbits(number_qubits)
+        paulis = [fst.Wide_Pauli(number_qubits, ((1 << a) & ~hadamards) | (neighbours[a] & hadamards), (neighbours[a] & ~hadamards) | ((1 << a) & hadamards), rng.getrandbits(1), 0) for a in range(number_qubits)]
+        for _ in range(4 * number_qubits):
+            i, j = rng.sample(range(number_qubits), 2)
+            paulis[j].multiply_by_pauli_on_right(paulis[i])
+
+        def eliminate(vectors, column_mask):
+            reduced = []
+            for vector in vectors:
+                for pivot, row in reduced:
+                    if vector >> pivot & 1:
+                        vector ^= row
+                if vector & column_mask:
+                    pivot = (vector & column_mask).bit_length() - 1
+                    reduced = [(other_pivot, row ^ vector if row >> pivot & 1 else row) for other_pivot, row in reduced]
+                    reduced.append((pivot, vector))
+            return sorted(row for _, row in reduced)
+
+        check_matrix = fst.Wide_Check_Matrix([fst.Wide_Pauli(pauli.number_qubits, pauli.x_vector, pauli.z_vector, pauli.sign_bit, pauli.imag_bit) for pauli in paulis])
+        check_matrix.row_reduce()
+        reduced_paulis = check_matrix.get_paulis()
+
+        x_vectors = sorted(pauli.x_vector for pauli in reduced_paulis if pauli.x_vector)
+        self.assertEqual(x_vectors, eliminate([pauli.x_vector for pauli in paulis], (1 << number_qubits) - 1))
+
+        # The z_only stabilisers are reduced on the columns that are not pivots of the x_stabilisers
+        z_columns = (1 << number_qubits) - 1
+        for x_vector in x_vectors:
+            z_columns &= ~(1 << (x_vector.bit_length() - 1))
+        z_vectors = sorted(pauli.z_vector for pauli in reduced_paulis if not pauli.x_vector)
+        self.assertEqual(z_vectors, eliminate(z_vectors, z_columns))
+
+        # The reduced Paulis generate the same group, with the same signs
+        for pauli in paulis:
+            result = check_matrix.measure(pauli)
+            self.assertTrue(result.deterministic and not result.outcome)
+
+    def test_tableau_simulator(self):
+        check_matrix = fst.Check_Matrix([fst.Pauli(2, 0, 1, 0, 0), fst.Pauli(2, 0, 2, 0, 0)])
+        fst.apply_gates(check_matrix, [fst.Gate(fst.Gate_Type.h, 0), fst.Gate(fst.Gate_Type.cx, 0, 1)])
+
+        # The Bell state (|00> + |11>) / sqrt(2) is stabilised by XX, ZZ and -YY, where YY = -XZXZ
+        self.assertEqual(check_matrix.get_expectation_value(fst.Pauli(2, 3, 0, 0, 0)), 1)
+        self.assertEqual(check_matrix.get_expectation_value(fst.Pauli(2, 0, 3, 0, 0)), 1)
+        self.assertEqual(check_matrix.get_expectation_value(fst.Pauli(2, 3, 3, 1, 0)), -1)
+
+        simulator = fst.Tableau_Simulator(check_matrix)
+        simulator.cx(0, 1)
+        simulator.h(0)
+        simulator.write_to(check_matrix)
+        self.assertTrue(np.allclose(check_matrix.get_state_vector(), [1, 0, 0, 0]))
+
+        with self.assertRaises(ValueError):
+            simulator.apply_gates([fst.Gate(fst.Gate_Type.h, 0), fst.Gate(fst.Gate_Type.cz, 1, 1)])
+
+    def test_pauli_frames(self):
+        zeros = fst.Check_Matrix([fst.Pauli(2, 0, 1, 0, 0), fst.Pauli(2, 0, 2, 0, 0)])
+        frames = fst.Pauli_Frames([fst.Pauli(2, 1, 0, 0, 0), fst.Pauli(2, 0, 0, 0, 0)])
+        frames.apply_gates([fst.Gate(fst.Gate_Type.cx, 0, 1)])
+
+        self.assertTrue(np.array_equal(frames.get_flips(zeros.get_paulis()), [[1, 1], [0, 0]]))
+        self.assertTrue(np.array_equal(frames.sample(zeros, seed = 1), [3, 0]))
+
+        frames.z_error(0, 1.0, seed = 2)
+        self.assertTrue(np.array_equal(frames.get_flips([fst.Pauli(2, 1, 0, 0, 0)]), [[1], [1]]))
+
+        with self.assertRaises(ValueError):
+            frames.x_error(2, 0.5)
+
+        # One seed reused across qubits draws each qubit's errors from its own stream
+        frames = fst.Pauli_Frames(2, 1000)
+        frames.x_error(0, 0.5, seed = 7)
+        frames.x_error(1, 0.5, seed = 7)
+        flips = frames.get_flips(zeros.get_paulis())
+        self.assertFalse(np.array_equal(flips[:, 0], flips[:, 1]))
+
     def get_uniform_stabiliser_state(self, number_qubits : int):
         support_size = 1 << number_qubits
         return np.ones(support_size, dtype = complex)/sqrt(support_size)
@@ -88,6 +444,82 @@ class TestCliffordMethods(unittest.TestCase):
         self.assertTrue(np.allclose(X_matrix, matrix@Z_matrix@matrix.conj().T))
         self.assertTrue(np.allclose(Z_matrix, matrix@X_matrix@matrix.conj().T))
 
+    def test_clifford_composition(self):
+        X = fst.Pauli(1,1,0,0,0)
+        Z = fst.Pauli(1,0,1,0,0)
+        Y = fst.Pauli(1,1,1,1,1)
+
+        # S maps X to Y and fixes Z, and H swaps X and Z
+        S = fst.Clifford([Z], [Y], 1)
+        H = fst.Clifford([X], [Z], -1)
+        S_matrix = np.array(S.get_matrix())
+        H_matrix = np.array(H.get_matrix())
+
+        self.assertTrue(np.allclose(S.compose(H).get_matrix(), S_matrix @ H_matrix))
+        self.assertTrue(np.allclose(S.inverse().get_matrix(), S_matrix.conj().T))
+        self.assertTrue(np.allclose(S.power(4).get_matrix(), np.eye(2)))
+        self.assertTrue(np.allclose(H.compose(S).power(-2).get_matrix(), np.linalg.matrix_power(np.linalg.inv(H_matrix @ S_matrix), 2)))
+
+        with self.assertRaises(ValueError):
+            S.compose(fst.Clifford.identity(2))
+
+    def test_clifford_conjugation(self):
+        X = fst.Pauli(1,1,0,0,0)
+        Z = fst.Pauli(1,0,1,0,0)
+        Y = fst.Pauli(1,1,1,1,1)
+
+        S = fst.Clifford([Z], [Y], 1)
+        S_matrix = np.array(S.get_matrix())
+
+        for pauli in [X, Y, Z, fst.Pauli(1,1,0,1,1)]:
+            pauli_matrix = np.array(pauli.get_matrix())
+            self.assertTrue(np.allclose(S.conjugate(pauli).get_matrix(), S_matrix @ pauli_matrix @ S_matrix.conj().T))
+
+        for conjugate, pauli in zip(S.conjugate([X, Y, Z]), [X, Y, Z]):
+            self.assertTrue(np.allclose(conjugate.get_matrix(), S.conjugate(pauli).get_matrix()))
+
+        statevector = np.array([1, 1j], dtype = complex) / sqrt(2) * (1+1j) / sqrt(2)
+        stabiliser_state = fst.stabiliser_state_from_statevector(statevector)
+        self.assertTrue(np.allclose(S.apply(stabiliser_state).get_state_vector(), S_matrix @ statevector))
+
+        check_matrix = S.apply(fst.Check_Matrix(stabiliser_state))
+        self.assertTrue(np.allclose(check_matrix.get_paulis()[0].get_matrix(), -np.array(X.get_matrix())))
+
+        with self.assertRaises(ValueError):
+            S.conjugate(fst.Pauli(2,0,0,0,0))
+
+    def test_clifford_apply_state_vector(self):
+        clifford = fst.Clifford([fst.Pauli(2,0,1,0,0), fst.Pauli(2,0,3,0,0)], [fst.Pauli(2,3,1,1,1), fst.Pauli(2,2,0,0,0)], 1j)
+        matrix = np.array(clifford.get_matrix(), dtype = np.complex128)
+
+        for dtype in [np.complex64, np.complex128]:
+            statevector = np.array([1, 2j, -1, 0.5], dtype = dtype)
+            expected = matrix @ statevector
+            self.assertIs(clifford.apply(statevector), statevector)
+            self.assertTrue(np.allclose(statevector, expected, atol = 1e-5))
+
+        with self.assertRaises(ValueError):
+            clifford.apply(np.zeros(8, dtype = np.complex64))
+
+    def test_numpy_matrices(self):
+        X = fst.Pauli(1,1,0,0,0)
+        Z = fst.Pauli(1,0,1,0,0)
+        clifford = fst.Clifford([X], [Z], -1)
+
+        matrix = clifford.get_matrix()
+        self.assertEqual(matrix.shape, (2, 2))
+        self.assertEqual(matrix.dtype, np.complex64)
+
+        out = np.zeros((2, 2), dtype = np.complex64)
+        X.get_matrix(out = out)
+        self.assertTrue(np.array_equal(out, [[0, 1], [1, 0]]))
+
+        vector = np.array([1, 2], dtype = np.complex64)
+        X.multiply_vector(vector, out = vector)
+        self.assertTrue(np.array_equal(vector, [2, 1]))
+
+        self.assertFalse(fst.is_clifford_matrix(np.ones((2, 4))))
+
     def test_is_clifford_matrix(self):
         matrix = self.get_hadamard_tensor_hadamard()
         almost_clifford = self.get_almost_clifford_matrix()